@@ -0,0 +1,37 @@
+//===- AIEVecToHost.h - AIEVec to host vector conversion --------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_CONVERSION_AIEVECTOHOST_AIEVECTOHOST_H
+#define AIE_CONVERSION_AIEVECTOHOST_AIEVECTOHOST_H
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+#include <memory>
+
+namespace mlir {
+class RewritePatternSet;
+class TypeConverter;
+} // namespace mlir
+
+namespace xilinx {
+namespace aievec {
+enum class AIEVecRoundingMode : uint32_t;
+
+void populateAIEVecToHostConversionPatterns(mlir::TypeConverter &converter,
+                                            mlir::RewritePatternSet &patterns,
+                                            AIEVecRoundingMode roundingMode,
+                                            bool saturate);
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createConvertAIEVecToHostPass();
+} // namespace aievec
+} // namespace xilinx
+
+#endif // AIE_CONVERSION_AIEVECTOHOST_AIEVECTOHOST_H
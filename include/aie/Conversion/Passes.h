@@ -12,6 +12,7 @@
 #define AIE_CONVERSION_PASSES_H
 
 #include "aie/Conversion/AIEToConfiguration/AIEToConfiguration.h"
+#include "aie/Conversion/AIEVecToHost/AIEVecToHost.h"
 #include "aie/Conversion/AIEVecToLLVM/AIEVecToLLVM.h"
 #include "aie/Conversion/PassesEnums.h.inc"
 
@@ -202,9 +202,19 @@ public:
   /// Return the size (in bytes) of the local data memory of a core.
   virtual uint32_t getLocalMemorySize() const = 0;
 
+  /// Return the size (in bytes) of the program memory of a core.
+  virtual uint32_t getProgramMemorySize() const = 0;
+
   /// Return the size (in bits) of the accumulator/cascade.
   virtual uint32_t getAccumulatorCascadeSize() const = 0;
 
+  /// Return the number of accumulator registers of a core, each the size of
+  /// the accumulator/cascade.
+  virtual uint32_t getNumAccumulatorRegisters() const = 0;
+
+  /// Return the size (in bits) of the vector register file of a core.
+  virtual uint32_t getVectorRegisterFileSize() const = 0;
+
   /// Return the number of lock objects
   virtual uint32_t getNumLocks(int col, int row) const = 0;
 
@@ -303,7 +313,10 @@ public:
   uint32_t getMemNorthBaseAddress() const override { return 0x00030000; }
   uint32_t getMemEastBaseAddress() const override { return 0x00038000; }
   uint32_t getLocalMemorySize() const override { return 0x00008000; }
+  uint32_t getProgramMemorySize() const override { return 0x00004000; }
   uint32_t getAccumulatorCascadeSize() const override { return 384; }
+  uint32_t getNumAccumulatorRegisters() const override { return 8; }
+  uint32_t getVectorRegisterFileSize() const override { return 2048; }
   uint32_t getNumLocks(int col, int row) const override { return 16; }
   uint32_t getNumBDs(int col, int row) const override { return 16; }
   bool isBdChannelAccessible(int col, int row, uint32_t bd_id,
@@ -371,7 +384,10 @@ public:
   uint32_t getMemNorthBaseAddress() const override { return 0x00060000; }
   uint32_t getMemEastBaseAddress() const override { return 0x00070000; }
   uint32_t getLocalMemorySize() const override { return 0x00010000; }
+  uint32_t getProgramMemorySize() const override { return 0x00004000; }
   uint32_t getAccumulatorCascadeSize() const override { return 512; }
+  uint32_t getNumAccumulatorRegisters() const override { return 18; }
+  uint32_t getVectorRegisterFileSize() const override { return 6144; }
 
   uint32_t getNumLocks(int col, int row) const override {
     return isMemTile(col, row) ? 64 : 16;
@@ -40,6 +40,8 @@ std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEObjectFifoStatefulTransformPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEObjectFifoRegisterProcessPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEObjectFifoDepthSizingPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIELowerCascadeFlowsPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEAssignBufferDescriptorIDsPass();
@@ -72,6 +74,8 @@ struct AIEPathfinderPass : AIERoutePathfinderFlowsBase<AIEPathfinderPass> {
   void runOnOperation() override;
   void runOnFlow(DeviceOp d);
   void runOnPacketFlow(DeviceOp d, mlir::OpBuilder &builder);
+  // Emit a remark on each flow with the length of its route.
+  void reportRouteLengths(DeviceOp d);
 
   typedef std::pair<mlir::Operation *, Port> PhysPort;
 
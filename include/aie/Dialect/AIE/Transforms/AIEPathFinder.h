@@ -17,6 +17,8 @@
 #include <algorithm>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <new>
 #include <set>
 
 namespace xilinx::AIE {
@@ -27,9 +29,19 @@ namespace xilinx::AIE {
 #define DEMAND_BASE 1.0
 #define MAX_CIRCUIT_STREAM_CAPACITY 1
 #define MAX_PACKET_STREAM_CAPACITY 32
+// Cost of every channel used by a flow, per unit of flow criticality
+#define LATENCY_COEFF 0.5
+// Bump whenever a change to the routers changes the routing they produce, to
+// invalidate the on-disk routing caches.
+#define ROUTING_CACHE_VERSION 1
 
 enum class Connectivity { INVALID = 0, AVAILABLE = 1 };
 
+// Routing state of the channels from the srcPorts to the dstPorts of a
+// switchbox. All of it lives in a single cache-line-aligned block, one
+// row-major srcPorts x dstPorts array per field, with the flags packed into
+// bitsets and the counts held in narrow integers, so that resetting or
+// sweeping the whole switchbox at each iteration is a handful of flat loops.
 using SwitchboxConnect = struct SwitchboxConnect {
   SwitchboxConnect() = default;
   SwitchboxConnect(TileID coords) : srcCoords(coords), dstCoords(coords) {}
@@ -39,57 +51,104 @@ using SwitchboxConnect = struct SwitchboxConnect {
   TileID srcCoords, dstCoords;
   std::vector<Port> srcPorts;
   std::vector<Port> dstPorts;
+
+  // allocate the block for the size of srcPorts and dstPorts, with every
+  // channel INVALID and no routing state
+  void resize();
+
+  // number of channels, i.e. srcPorts.size() * dstPorts.size()
+  size_t size() const { return numChannels; }
+  // position of the channel from srcPorts[i] to dstPorts[j] in the arrays
+  size_t index(size_t i, size_t j) const { return i * dstPorts.size() + j; }
+
   // connectivity between ports
-  std::vector<std::vector<Connectivity>> connectivity;
+  Connectivity getConnectivity(size_t i, size_t j) const {
+    return testBit(connectivityBits, index(i, j)) ? Connectivity::AVAILABLE
+                                                  : Connectivity::INVALID;
+  }
+  void setConnectivity(size_t i, size_t j, Connectivity c) {
+    setBit(connectivityBits, index(i, j), c == Connectivity::AVAILABLE);
+  }
   // weights of Dijkstra's shortest path
-  std::vector<std::vector<double>> demand;
+  double &demand(size_t i, size_t j) { return demandData[index(i, j)]; }
+  double demand(size_t i, size_t j) const { return demandData[index(i, j)]; }
   // history of Channel being over capacity
-  std::vector<std::vector<int>> overCapacity;
+  uint16_t &overCapacity(size_t i, size_t j) {
+    return overCapacityData[index(i, j)];
+  }
   // how many circuit streams are actually using this Channel
-  std::vector<std::vector<int>> usedCapacity;
+  uint16_t &usedCapacity(size_t i, size_t j) {
+    return usedCapacityData[index(i, j)];
+  }
+  uint16_t usedCapacity(size_t i, size_t j) const {
+    return usedCapacityData[index(i, j)];
+  }
   // how many packet streams are actually using this Channel
-  std::vector<std::vector<int>> packetFlowCount;
+  uint8_t &packetFlowCount(size_t i, size_t j) {
+    return packetFlowCountData[index(i, j)];
+  }
   // only sharing the channel with the same packet group id
-  std::vector<std::vector<int>> packetGroupId;
+  int32_t &packetGroupId(size_t i, size_t j) {
+    return packetGroupIdData[index(i, j)];
+  }
   // flags indicating priority routings
-  std::vector<std::vector<bool>> isPriority;
-
-  // resize the matrices to the size of srcPorts and dstPorts
-  void resize() {
-    connectivity.resize(
-        srcPorts.size(),
-        std::vector<Connectivity>(dstPorts.size(), Connectivity::INVALID));
-    demand.resize(srcPorts.size(), std::vector<double>(dstPorts.size(), 0.0));
-    overCapacity.resize(srcPorts.size(), std::vector<int>(dstPorts.size(), 0));
-    usedCapacity.resize(srcPorts.size(), std::vector<int>(dstPorts.size(), 0));
-    packetFlowCount.resize(srcPorts.size(),
-                           std::vector<int>(dstPorts.size(), 0));
-    packetGroupId.resize(srcPorts.size(), std::vector<int>(dstPorts.size(), 0));
-    isPriority.resize(srcPorts.size(),
-                      std::vector<bool>(dstPorts.size(), false));
+  bool isPriority(size_t i, size_t j) const {
+    return testBit(priorityBits, index(i, j));
+  }
+  void setPriority(size_t i, size_t j, bool priority) {
+    setBit(priorityBits, index(i, j), priority);
   }
 
+  // forget the channel usage, history and priorities of a previous routing
+  void clearHistory();
+  // release every channel at the start of an iteration's rip-up
+  void ripUp();
   // update demand at the beginning of each dijkstraShortestPaths iteration
-  void updateDemand() {
-    for (size_t i = 0; i < srcPorts.size(); i++) {
-      for (size_t j = 0; j < dstPorts.size(); j++) {
-        double history = DEMAND_BASE + OVER_CAPACITY_COEFF * overCapacity[i][j];
-        double congestion =
-            DEMAND_BASE + USED_CAPACITY_COEFF * usedCapacity[i][j];
-        demand[i][j] = history * congestion;
-      }
-    }
-  }
+  void updateDemand();
+  // at the end of a packet group, count every channel it shares as one
+  // circuit stream and bump the demand of the channels at capacity
+  void settlePacketFlows();
 
   // Inside each dijkstraShortestPaths interation, bump demand when exceeds
   // capacity. If isPriority is true, then set demand to INF to ensure routing
   // consistency for prioritized flows
-  void bumpDemand(size_t i, size_t j) {
-    if (usedCapacity[i][j] >= MAX_CIRCUIT_STREAM_CAPACITY) {
-      demand[i][j] *=
-          isPriority[i][j] ? std::numeric_limits<int>::max() : DEMAND_COEFF;
+  void bumpDemand(size_t i, size_t j) { bumpDemand(index(i, j)); }
+
+private:
+  struct BlockDeleter {
+    void operator()(char *block) const {
+      ::operator delete(block, std::align_val_t(BLOCK_ALIGNMENT));
     }
+  };
+  static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+  static bool testBit(const uint64_t *bits, size_t k) {
+    return (bits[k / 64] >> (k % 64)) & 1;
   }
+  static void setBit(uint64_t *bits, size_t k, bool value) {
+    if (value)
+      bits[k / 64] |= uint64_t(1) << (k % 64);
+    else
+      bits[k / 64] &= ~(uint64_t(1) << (k % 64));
+  }
+  void bumpDemand(size_t k) {
+    if (usedCapacityData[k] >= MAX_CIRCUIT_STREAM_CAPACITY) {
+      demandData[k] *= testBit(priorityBits, k)
+                           ? std::numeric_limits<int>::max()
+                           : DEMAND_COEFF;
+    }
+  }
+
+  size_t numChannels = 0;
+  std::unique_ptr<char, BlockDeleter> block;
+  // views into block, each starting on its own cache line
+  double *demandData = nullptr;
+  int32_t *packetGroupIdData = nullptr;
+  uint16_t *overCapacityData = nullptr;
+  uint16_t *usedCapacityData = nullptr;
+  uint8_t *packetFlowCountData = nullptr;
+  uint64_t *connectivityBits = nullptr;
+  uint64_t *priorityBits = nullptr;
 };
 
 using PathEndPoint = struct PathEndPoint {
@@ -125,6 +184,9 @@ using PathEndPoint = struct PathEndPoint {
 using Flow = struct Flow {
   int packetGroupId;
   bool isPriorityFlow;
+  // Weight of the latency of the flow against congestion; critical flows are
+  // routed first and penalize each channel they traverse.
+  int criticality;
   PathEndPoint src;
   std::vector<PathEndPoint> dsts;
 };
@@ -179,6 +241,51 @@ using SwitchSetting = struct SwitchSetting {
 
 using SwitchSettings = std::map<TileID, SwitchSetting>;
 
+// Dense indices into the compacted routing graph built by the Pathfinder.
+using NodeId = unsigned;
+using EdgeId = unsigned;
+static constexpr EdgeId INVALID_EDGE = std::numeric_limits<EdgeId>::max();
+
+// Scratch state of a single shortest path search over the compacted routing
+// graph. All vectors are indexed by NodeId and are reused across searches, so
+// that a search does not allocate once the graph has been built.
+struct RoutingSearchState {
+  enum Color : uint8_t { WHITE, GRAY, BLACK };
+
+  std::vector<double> distance;
+  // distance plus the A* heuristic, the priority of a node in the A* search
+  std::vector<double> estimate;
+  // the channel through which the shortest path enters each node
+  std::vector<EdgeId> predEdge;
+  std::vector<uint64_t> indexInHeap;
+  std::vector<Color> colors;
+  // nodes whose outgoing channels were read by the search, i.e. the only
+  // demands the result depends on
+  std::vector<NodeId> expanded;
+
+  void reset(size_t numNodes) {
+    distance.assign(numNodes, std::numeric_limits<double>::max());
+    predEdge.assign(numNodes, INVALID_EDGE);
+    indexInHeap.assign(numNodes, 0);
+    colors.assign(numNodes, WHITE);
+    expanded.clear();
+  }
+};
+
+// Options controlling how a Router searches for a legal routing.
+using RouterOptions = struct RouterOptions {
+  // After the first iteration, only rip up and reroute the flows that use an
+  // over capacity channel, keeping all other routes in place.
+  bool incremental = false;
+  // Run the shortest path searches of a negotiation iteration concurrently on
+  // the thread pool of context. The routing is identical to the serial one.
+  bool parallel = false;
+  // Route single destination circuit flows with an A* search directed by the
+  // Manhattan distance to the destination tile.
+  bool astar = false;
+  mlir::MLIRContext *context = nullptr;
+};
+
 class Router {
 public:
   Router() = default;
@@ -188,41 +295,125 @@ public:
   virtual void initialize(int maxCol, int maxRow,
                           const AIETargetModel &targetModel) = 0;
   virtual void addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
-                       Port dstPort, bool isPacketFlow,
-                       bool isPriorityFlow) = 0;
+                       Port dstPort, bool isPacketFlow, bool isPriorityFlow,
+                       int criticality) = 0;
   virtual void sortFlows(const int maxCol, const int maxRow) = 0;
   virtual bool addFixedConnection(SwitchboxOp switchboxOp) = 0;
   virtual std::optional<std::map<PathEndPoint, SwitchSettings>>
   findPaths(int maxIterations) = 0;
+
+  // Name identifying the routing algorithm, part of the routing cache key.
+  virtual llvm::StringRef getName() const = 0;
+
+  void setOptions(const RouterOptions &routerOptions) {
+    options = routerOptions;
+  }
+  const RouterOptions &getOptions() const { return options; }
+
+protected:
+  RouterOptions options;
 };
 
 class Pathfinder : public Router {
 public:
   Pathfinder() = default;
+  llvm::StringRef getName() const override { return "pathfinder"; }
   void initialize(int maxCol, int maxRow,
                   const AIETargetModel &targetModel) override;
   void addFlow(TileID srcCoords, Port srcPort, TileID dstCoords, Port dstPort,
-               bool isPacketFlow, bool isPriorityFlow) override;
+               bool isPacketFlow, bool isPriorityFlow,
+               int criticality) override;
   void sortFlows(const int maxCol, const int maxRow) override;
   bool addFixedConnection(SwitchboxOp switchboxOp) override;
   std::optional<std::map<PathEndPoint, SwitchSettings>>
   findPaths(int maxIterations) override;
-  std::map<PathEndPoint, PathEndPoint> dijkstraShortestPaths(PathEndPoint src);
+  // Number of negotiation iterations run by the last findPaths
+  int getNumIterations() const { return numIterations; }
+  // Run Dijkstra's shortest path from src over the compacted routing graph,
+  // until all of dsts are reached. Each channel costs its demand plus
+  // channelCost. The shortest path tree is left in state.predEdge.
+  void dijkstraShortestPaths(NodeId src, llvm::ArrayRef<NodeId> dsts,
+                             RoutingSearchState &state,
+                             double channelCost = 0.0);
+  // Run an A* search from src to dst over the compacted routing graph, using
+  // the Manhattan distance between tiles as the heuristic. Each channel costs
+  // its demand plus channelCost. The shortest path is left in state.predEdge.
+  void aStarShortestPath(NodeId src, NodeId dst, RoutingSearchState &state,
+                         double channelCost = 0.0);
+
+protected:
+  // Search the route of flow given the current demands. The route is left as
+  // a tree in state.predEdge, rooted at the source of flow and reaching all of
+  // its destinations. Uses A* if possible, Dijkstra otherwise.
+  virtual void searchRoute(const Flow &flow, RoutingSearchState &state);
+
+  // Build the compacted routing graph (nodes and CSR adjacency) from the
+  // switchboxes. Must be called after all fixed connections have been added.
+  void buildRoutingGraph();
+  NodeId getOrCreateNode(PathEndPoint endPoint);
+  // Trace the route of a flow backwards through the shortest path tree in
+  // state. The channels of the route are appended to route, in the order in
+  // which they must be committed.
+  SwitchSettings traceRoute(const Flow &flow, const RoutingSearchState &state,
+                            std::vector<EdgeId> &route);
+  // Account for a flow using the given channel. Returns true if this changed
+  // the demand of the channel.
+  bool commitEdge(EdgeId edge, int packetGroupId, bool isPriority);
+  bool isOverCapacity(EdgeId edge) const;
+  // Run the searches for flows (indices into groupFlows) concurrently, each
+  // into its own entry of searchStates.
+  void speculateSearches(llvm::ArrayRef<Flow> groupFlows,
+                         llvm::ArrayRef<size_t> flows);
 
-private:
   // Flows to be routed
   std::vector<Flow> flows;
+  int numIterations = 0;
   // Represent all routable paths as a graph
-  // The key is a pair of TileIDs representing the connectivity from srcTile to
-  // dstTile If srcTile == dstTile, it represents connections inside the same
+  // Each SwitchboxConnect represents the connectivity from srcTile to dstTile.
+  // If srcTile == dstTile, it represents connections inside the same
   // switchbox otherwise, it represents connections (South, North, West, East)
   // accross two switchboxes
-  std::map<std::pair<TileID, TileID>, SwitchboxConnect> graph;
-  // Channels available in the network
-  // The key is a PathEndPoint representing the start of a path
-  // The value is a vector of PathEndPoints representing the possible ends of
-  // the path
-  std::map<PathEndPoint, std::vector<PathEndPoint>> channels;
+  std::vector<SwitchboxConnect> switchboxes;
+  // Index into switchboxes of the (srcTile, dstTile) connectivity
+  std::map<std::pair<TileID, TileID>, unsigned> switchboxIndex;
+
+  // Compacted routing graph. Every PathEndPoint is given a dense NodeId and
+  // the channels leaving node n are the edges [edgeBegin[n], edgeBegin[n+1]),
+  // ordered by the PathEndPoint they lead to.
+  std::vector<PathEndPoint> nodes;
+  std::map<PathEndPoint, NodeId> nodeIds;
+  std::vector<EdgeId> edgeBegin;
+  // Per-edge attributes: the endpoints of the channel and the switchbox
+  // entry (switchboxes[edgeSwitchbox].xxx(edgeSrcPort, edgeDstPort)) holding
+  // its demand and capacity.
+  std::vector<NodeId> edgeSource;
+  std::vector<NodeId> edgeTarget;
+  std::vector<unsigned> edgeSwitchbox;
+  std::vector<unsigned> edgeSrcPort;
+  std::vector<unsigned> edgeDstPort;
+
+  // One search state per concurrent search; the serial mode uses the first.
+  std::vector<RoutingSearchState> searchStates;
+  // Nodes already on the route of the flow being traced
+  std::vector<bool> onRoute;
+  // Nodes with an outgoing channel whose demand changed since the last batch
+  // of concurrent searches was started
+  std::vector<bool> demandChanged;
+  std::vector<NodeId> changedNodes;
+};
+
+// Pathfinder variant that routes flows with several destinations as an
+// approximate Steiner tree: starting from the source, the nearest unreached
+// destination is repeatedly connected to the tree built so far, so that
+// branches share channels instead of each following its own shortest path
+// from the source.
+class SteinerRouter : public Pathfinder {
+public:
+  SteinerRouter() = default;
+  llvm::StringRef getName() const override { return "steiner"; }
+
+protected:
+  void searchRoute(const Flow &flow, RoutingSearchState &state) override;
 };
 
 // DynamicTileAnalysis integrates the Pathfinder class into the MLIR
@@ -242,6 +433,11 @@ public:
   llvm::DenseMap<int, PLIOOp> coordToPLIO;
 
   const int maxIterations = 1000; // how long until declared unroutable
+  // Directory of the on-disk routing cache; the cache is disabled if empty.
+  std::string cacheDir;
+  // Number of routings loaded from and stored in the routing cache.
+  unsigned numCacheHits = 0;
+  unsigned numCacheMisses = 0;
 
   DynamicTileAnalysis() : pathfinder(std::make_shared<Pathfinder>()) {}
   DynamicTileAnalysis(std::shared_ptr<Router> p) : pathfinder(std::move(p)) {}
@@ -251,6 +447,19 @@ public:
   int getMaxCol() const { return maxCol; }
   int getMaxRow() const { return maxRow; }
 
+  // Canonical description of the routing problem of device: the router, the
+  // device and its target model, the fixed connections and the sorted flows.
+  std::string getRoutingCacheKey(DeviceOp &device);
+  // Load flowSolutions from the routing cache entry for key. Returns false on
+  // a cache miss.
+  bool loadCachedRouting(llvm::StringRef key);
+  // Store flowSolutions in the routing cache entry for key.
+  mlir::LogicalResult storeCachedRouting(llvm::StringRef key);
+
+  // Number of switchboxes the routed flow from src traverses to reach dst.
+  std::optional<unsigned> getRouteLength(const PathEndPoint &src,
+                                         const PathEndPoint &dst) const;
+
   TileOp getTile(mlir::OpBuilder &builder, int col, int row);
 
   SwitchboxOp getSwitchbox(mlir::OpBuilder &builder, int col, int row);
@@ -20,10 +20,16 @@
 
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+#include "mlir/Interfaces/ViewLikeInterface.h"
 
 #include <cassert>
 #include <numeric>
 
+namespace xilinx::AIE {
+class AIETargetModel;
+} // namespace xilinx::AIE
+
 namespace xilinx::aievec {
 
 // For input val, return its value in hex. Since we currently support each
@@ -247,6 +253,33 @@ isAssumingNoImplicitBroadcastOfDynamicSizes(mlir::OpBuilder &builder) {
   return isAssumingNoImplicitBroadcastOfDynamicSizes(builder.getBlock());
 }
 
+// Return the buffer that `memref` is a view of
+inline mlir::Value getUnderlyingBuffer(mlir::Value memref) {
+  while (auto viewOp = memref.getDefiningOp<mlir::ViewLikeOpInterface>())
+    memref = viewOp.getViewSource();
+  return memref;
+}
+
+// Return true if `buffer` is a memref block argument that may be the same
+// memory as another one. Only the function arguments marked llvm.noalias are
+// known not to be.
+inline bool isAliasingArgument(mlir::Value buffer) {
+  auto arg = llvm::dyn_cast<mlir::BlockArgument>(buffer);
+  if (!arg || !llvm::isa<mlir::MemRefType>(arg.getType()))
+    return false;
+  auto func = llvm::dyn_cast<mlir::FunctionOpInterface>(
+      arg.getOwner()->getParentOp());
+  return !func || !arg.getOwner()->isEntryBlock() ||
+         !func.getArgAttr(arg.getArgNumber(), "llvm.noalias");
+}
+
+// Return the target model of the device that `op` is in or, outside of a
+// device, the one of `aieTarget` ("aie", "aie2"/"aieml" or "aie2p"). Return
+// null if the target is unknown. This is defined in the AIEVec transforms
+// library, which is the one linked with the AIE dialect.
+const AIE::AIETargetModel *getTargetModel(mlir::Operation *op,
+                                          llvm::StringRef aieTarget);
+
 } // namespace xilinx::aievec
 // end namespace xilinx
 
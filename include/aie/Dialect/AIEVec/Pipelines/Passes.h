@@ -41,8 +41,9 @@ struct CanonicalizeVectorForAIEVecOptions
     : public mlir::PassPipelineOptions<CanonicalizeVectorForAIEVecOptions> {
   PassOptions::Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". "
+                     "This will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
   PassOptions::Option<std::string> targetBackend{
       *this, "target-backend",
@@ -50,6 +51,12 @@ struct CanonicalizeVectorForAIEVecOptions
                      "will determine the aievec operations used to convert "
                      "from vector dialect."),
       llvm::cl::init("cpp")};
+  PassOptions::Option<bool> fuseNormalizationLoops{
+      *this, "fuse-normalization-loops",
+      llvm::cl::desc("Fuse the statistics loops of vectorized softmax and "
+                     "layernorm kernels into a single pass over the input "
+                     "(AIE2 only)"),
+      llvm::cl::init(false)};
 };
 
 /// Options for the "lower-vector-to-aievec" pipeline.
@@ -57,8 +64,9 @@ struct LowerVectorToAIEVecOptions
     : public mlir::PassPipelineOptions<LowerVectorToAIEVecOptions> {
   PassOptions::Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". "
+                     "This will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
   PassOptions::Option<std::string> targetBackend{
       *this, "target-backend",
@@ -66,6 +74,12 @@ struct LowerVectorToAIEVecOptions
                      "will determine the aievec operations used to convert "
                      "from vector dialect."),
       llvm::cl::init("cpp")};
+  PassOptions::Option<bool> bfp16MatMul{
+      *this, "bfp16-matmul",
+      llvm::cl::desc("Lower contractions with a bfp16 operand to "
+                     "aievec.matmul_bfp on AIE2P. Experimental: the bfp16 "
+                     "ops have no LLVM IR or C++ lowering yet."),
+      llvm::cl::init(false)};
 };
 
 /// Options for the "optimize-aievec" pipeline.
@@ -73,8 +87,9 @@ struct OptimizeAIEVecOptions
     : public mlir::PassPipelineOptions<OptimizeAIEVecOptions> {
   PassOptions::Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". "
+                     "This will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
   PassOptions::Option<std::string> targetBackend{
       *this, "target-backend",
@@ -109,8 +124,9 @@ struct ConvertVectorToAIEVecOptions
       llvm::cl::init(2)};
   PassOptions::Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". "
+                     "This will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
   PassOptions::Option<std::string> targetBackend{
       *this, "target-backend",
@@ -118,14 +134,28 @@ struct ConvertVectorToAIEVecOptions
                      "will determine the aievec operations used to convert "
                      "from vector dialect."),
       llvm::cl::init("cpp")};
+  PassOptions::Option<bool> fuseNormalizationLoops{
+      *this, "fuse-normalization-loops",
+      llvm::cl::desc("Fuse the statistics loops of vectorized softmax and "
+                     "layernorm kernels into a single pass over the input "
+                     "(AIE2 only)"),
+      llvm::cl::init(false)};
+  PassOptions::Option<bool> bfp16MatMul{
+      *this, "bfp16-matmul",
+      llvm::cl::desc("Lower contractions with a bfp16 operand to "
+                     "aievec.matmul_bfp on AIE2P. Experimental: the bfp16 "
+                     "ops have no LLVM IR or C++ lowering yet."),
+      llvm::cl::init(false)};
 
   mlir::LogicalResult parseFromString(mlir::StringRef options) {
     auto res = PassPipelineOptions::parseFromString(options);
     if (!failed(res)) {
       lowerOptions.aieTarget = aieTarget;
       lowerOptions.targetBackend = targetBackend;
+      lowerOptions.bfp16MatMul = bfp16MatMul;
       canonicalizeOptions.aieTarget = aieTarget;
       canonicalizeOptions.targetBackend = targetBackend;
+      canonicalizeOptions.fuseNormalizationLoops = fuseNormalizationLoops;
       optimizeOptions.aieTarget = aieTarget;
       optimizeOptions.targetBackend = targetBackend;
       optimizeOptions.shiftParam = shiftParam;
@@ -34,6 +34,10 @@ namespace arith {
 class ArithDialect;
 } // end namespace arith
 
+namespace math {
+class MathDialect;
+} // end namespace math
+
 namespace memref {
 class MemRefDialect;
 } // end namespace memref
@@ -67,6 +71,12 @@ namespace aievec {
 
 std::unique_ptr<mlir::Pass> createAIEVectorizePass();
 
+std::unique_ptr<mlir::Pass> createAIEVecMatMulRegisterBlockingPass();
+
+std::unique_ptr<mlir::Pass> createAIEVecSoftwarePipelinePass();
+
+std::unique_ptr<mlir::Pass> createAIEVecFuseNormalizationLoopsPass();
+
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
 #include "aie/Dialect/AIEVec/Transforms/Passes.h.inc"
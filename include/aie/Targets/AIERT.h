@@ -22,11 +22,16 @@ extern "C" {
 #include "xaiengine/xaiegbl.h"
 }
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #define AIERC_STR(x) x, #x
 static const std::map<AieRC, std::string> AIERCTOSTR = {
@@ -190,10 +195,32 @@ static_assert(XAIE_OK == 0);
 #define BASE_ADDR_A_INCR_EAST 0x100000
 
 namespace xilinx::AIE {
+
+// Returns the path of the ELF of a core in elfDir.
+std::string getCoreElfPath(CoreOp coreOp, llvm::StringRef elfDir);
+
+// The ELFs loaded into the cores, and the bytes of program memory they hold.
+// Every core is written its whole program, even when another core runs the
+// same image: the distinct figures only tell how much of the program writes
+// repeat each other.
+struct ElfLoadStats {
+  uint64_t cores = 0;
+  // Distinct ELF images among those loaded.
+  uint64_t images = 0;
+  // Program bytes written to the cores.
+  uint64_t programBytes = 0;
+  // Program bytes of the distinct images only.
+  uint64_t imageProgramBytes = 0;
+
+  ElfLoadStats &operator+=(const ElfLoadStats &other);
+  void print(llvm::raw_ostream &os) const;
+};
+
 struct AIERTControl {
   XAie_Config configPtr;
   XAie_DevInst devInst;
   const BaseNPUTargetModel &targetModel;
+  ElfLoadStats elfStats;
 
   AIERTControl(const xilinx::AIE::BaseNPUTargetModel &tm);
 
@@ -216,14 +243,29 @@ struct AIERTControl {
   mlir::LogicalResult configureLocksInBdBlock(XAie_DmaDesc &dmaTileBd,
                                               mlir::Block &block,
                                               XAie_LocType &tileLoc);
+  // Loads an ELF into a core. Each ELF file is only read once, and cores
+  // whose ELFs have the same contents are loaded from one image in memory,
+  // unless `loadElfFromPath`, in which case libxaie reads each ELF from its
+  // path as it does for simulation. Either way, the program memory of each
+  // core gets its own writes.
   mlir::LogicalResult addAieElf(uint8_t col, uint8_t row,
-                                const mlir::StringRef elfPath, bool aieSim);
+                                const mlir::StringRef elfPath, bool aieSim,
+                                bool loadElfFromPath = false);
   mlir::LogicalResult addAieElfs(DeviceOp &targetOp,
                                  const mlir::StringRef workDirPath,
-                                 bool aieSim);
+                                 bool aieSim, bool loadElfFromPath = false);
   void startTransaction();
   void dmaUpdateBdAddr(int col, int row, size_t addr, size_t bdId);
   void exportSerializedTransaction();
+
+private:
+  // Returns the image of the ELF at `elfPath`, or null if it cannot be read.
+  // Each file is read once, and files with the same contents share one image.
+  const llvm::MemoryBuffer *getElfImage(mlir::StringRef elfPath);
+
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> elfImages;
+  llvm::DenseMap<llvm::StringRef, const llvm::MemoryBuffer *> imagesByContents;
+  llvm::StringMap<const llvm::MemoryBuffer *> imagesByPath;
 };
 
 } // namespace xilinx::AIE
@@ -40,6 +40,11 @@ mlir::LogicalResult AIETranslateNpuToBinary(mlir::ModuleOp module,
 mlir::LogicalResult AIETranslateNpuToBinary(mlir::ModuleOp,
                                             std::vector<uint32_t> &,
                                             llvm::StringRef sequenceName = "");
+// Writes, as JSON, where the BD fields given by runtime sequence arguments
+// (npu.field_patch) are in the instructions of aie-npu-to-binary.
+mlir::LogicalResult
+AIETranslateNpuToPatchTable(mlir::ModuleOp module, llvm::raw_ostream &output,
+                            llvm::StringRef sequenceName = "");
 mlir::LogicalResult
 AIETranslateControlPacketsToUI32Vec(mlir::ModuleOp module,
                                     llvm::raw_ostream &output,
@@ -59,11 +64,20 @@ AIELLVMLink(llvm::raw_ostream &output, std::vector<std::string> Files,
             bool Internalize = false, bool OnlyNeeded = false,
             bool PreserveAssemblyUseListOrder = false, bool Verbose = false);
 
+// Generates the CDO files of every device of the module. With several
+// devices, the ELFs and CDO files of each are in the subdirectory
+// device_<index> of workDirPath. The files are generated concurrently unless
+// multithreading is disabled in the context. If `elfReport` is given, the
+// number of cores, distinct ELF images and program bytes loaded for each
+// device are printed to it. With `loadElfFromPath`, libxaie reads each ELF
+// from its file instead of loading cores with the same ELF from one image.
 mlir::LogicalResult
 AIETranslateToCDODirect(mlir::ModuleOp m, llvm::StringRef workDirPath,
                         bool bigEndian = false, bool emitUnified = false,
                         bool cdoDebug = false, bool aieSim = false,
-                        bool xaieDebug = false, bool enableCores = true);
+                        bool xaieDebug = false, bool enableCores = true,
+                        llvm::raw_ostream *elfReport = nullptr,
+                        bool loadElfFromPath = false);
 
 #ifdef AIE_ENABLE_AIRBIN
 mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
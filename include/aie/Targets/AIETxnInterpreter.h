@@ -0,0 +1,133 @@
+//===- AIETxnInterpreter.h --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// A host-side interpreter for NPU transaction binaries. It runs the
+// operations of a binary against a sparse model of the array registers, so
+// that the configuration produced by the compiler can be checked and compared
+// without hardware.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_TARGETS_AIETXNINTERPRETER_H
+#define AIE_TARGETS_AIETXNINTERPRETER_H
+
+#include "aie/Dialect/AIE/IR/AIEEnums.h"
+#include "aie/Dialect/AIE/IR/AIETargetModel.h"
+
+#include "mlir/Support/LogicalResult.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace xilinx::AIE {
+
+// Transaction operation codes, as found in the low byte of the first word of
+// each operation.
+enum class TxnOpcode : uint8_t {
+  Write = 0x0,
+  BlockWrite = 0x1,
+  MaskWrite = 0x3,
+  Tct = 0x80,
+  DdrPatch = 0x81,
+};
+
+struct TxnOpStats {
+  uint64_t count = 0;
+  uint64_t bytes = 0;
+  std::chrono::nanoseconds time{0};
+};
+
+struct TxnStats {
+  std::map<TxnOpcode, TxnOpStats> ops;
+  // 32-bit register writes, counting each word of a blockwrite.
+  uint64_t registerWrites = 0;
+  // Register writes that did not change the value of the register.
+  uint64_t redundantWrites = 0;
+  // Register writes that were fully overwritten before the next sync or DMA
+  // channel write, and so had no effect.
+  uint64_t overwrittenWrites = 0;
+};
+
+// Runs transaction binaries against a sparse register model of the device.
+// Registers that were never written are not part of the model. Syncs only
+// order the writes around them and address patches are recorded, since the
+// host buffers they refer to do not exist here.
+class TxnInterpreter {
+public:
+  explicit TxnInterpreter(const AIETargetModel &targetModel);
+
+  // Returns the device a transaction binary was generated for, from the
+  // array size in its header, if it identifies one.
+  static std::optional<AIEDevice> inferDevice(llvm::ArrayRef<uint32_t> words);
+
+  // Runs a transaction binary, header included. Versions 0.1 and 1.0 of the
+  // format are supported. Returns failure and reports to `errs` if the binary
+  // is malformed or uses an unknown operation.
+  mlir::LogicalResult run(llvm::ArrayRef<uint32_t> words,
+                          llvm::raw_ostream &errs = llvm::errs());
+
+  // Returns the value of the register at the given array address, if it was
+  // written.
+  std::optional<uint32_t> readRegister(uint64_t address) const;
+
+  // Returns the tile of the register at the given array address.
+  TileID getTile(uint64_t address) const;
+
+  // Returns the registers that were written, by array address.
+  const std::map<uint64_t, uint32_t> &getRegisters() const { return registers; }
+
+  // Returns true for the DMA channel control and task queue registers, whose
+  // writes act on the array rather than only configure it.
+  bool isDmaChannelRegister(uint64_t address) const;
+
+  // Returns true for the stream switch port and packet slot registers.
+  bool isStreamSwitchRegister(uint64_t address) const;
+
+  // Returns true for the words of the buffer descriptors.
+  bool isBdRegister(uint64_t address) const;
+
+  // Returns true for the lock value registers.
+  bool isLockRegister(uint64_t address) const;
+
+  const TxnStats &getStats() const { return stats; }
+
+  // Prints the BDs, locks, stream switch configuration, address patches and
+  // other registers of each tile that was written.
+  void printState(llvm::raw_ostream &os) const;
+
+  // Prints the operation counts and sizes, and their run time if `printTime`.
+  void printStats(llvm::raw_ostream &os, bool printTime = false) const;
+
+private:
+  mlir::LogicalResult runV1(llvm::ArrayRef<uint32_t> ops,
+                            llvm::raw_ostream &errs);
+  mlir::LogicalResult runV01(llvm::ArrayRef<uint32_t> ops,
+                             llvm::raw_ostream &errs);
+  void write(uint64_t address, uint32_t value, uint32_t mask = 0xFFFFFFFF);
+  void sync();
+
+  const AIETargetModel &targetModel;
+  std::map<uint64_t, uint32_t> registers;
+  // address -> (argument index, offset)
+  std::map<uint64_t, std::pair<uint32_t, uint32_t>> patches;
+  // registers fully written since the last sync
+  llvm::DenseSet<uint64_t> pendingWrites;
+  TxnStats stats;
+};
+
+} // namespace xilinx::AIE
+
+#endif // AIE_TARGETS_AIETXNINTERPRETER_H
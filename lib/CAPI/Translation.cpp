@@ -105,6 +105,19 @@ MlirStringRef aieTranslateNpuToBinary(MlirOperation moduleOp,
   return mlirStringRefCreate(cStr, npu.size());
 }
 
+MlirStringRef aieTranslateNpuToPatchTable(MlirOperation moduleOp,
+                                          MlirStringRef sequenceName) {
+  std::string table;
+  llvm::raw_string_ostream os(table);
+  ModuleOp mod = llvm::cast<ModuleOp>(unwrap(moduleOp));
+  llvm::StringRef name(sequenceName.data, sequenceName.length);
+  if (failed(AIETranslateNpuToPatchTable(mod, os, name)))
+    return mlirStringRefCreate(nullptr, 0);
+  char *cStr = static_cast<char *>(malloc(table.size()));
+  table.copy(cStr, table.size());
+  return mlirStringRefCreate(cStr, table.size());
+}
+
 MlirStringRef aieTranslateControlPacketsToUI32Vec(MlirOperation moduleOp) {
   std::string npu;
   llvm::raw_string_ostream os(npu);
@@ -12,9 +12,17 @@
 
 #include "aie/Conversion/AIEToConfiguration/AIEToConfiguration.h"
 #include "aie/Targets/AIERT.h"
+#include "aie/Targets/AIETxnInterpreter.h"
 
+#include "mlir/Parser/Parser.h"
+
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MemoryBuffer.h"
 
+#include <map>
+#include <set>
+#include <tuple>
 #include <vector>
 
 #define DEBUG_TYPE "aie-convert-to-config"
@@ -351,8 +359,12 @@ static LogicalResult convertTransactionOpsToMLIR(
 
   auto loc = builder.getUnknownLoc();
 
-  // for each blockwrite in the binary, create a GlobalOp with the data
+  // for each blockwrite in the binary, create a GlobalOp with the data.
+  // Blockwrites of the same data, such as the program memory of cores that
+  // run the same ELF, share one GlobalOp. This only shrinks the MLIR: each
+  // blockwrite still carries its data when the sequence is serialized.
   std::vector<memref::GlobalOp> global_data;
+  std::map<std::vector<uint32_t>, memref::GlobalOp> globals_by_data;
   for (auto &op : operations) {
     if (op.cmd.Opcode != XAIE_IO_BLOCKWRITE) {
       global_data.push_back(nullptr);
@@ -361,6 +373,11 @@ static LogicalResult convertTransactionOpsToMLIR(
     uint32_t size = op.cmd.Size / 4;
     const uint32_t *d = reinterpret_cast<const uint32_t *>(op.cmd.DataPtr);
     std::vector<uint32_t> data32(d, d + size);
+    auto it = globals_by_data.find(data32);
+    if (it != globals_by_data.end()) {
+      global_data.push_back(it->second);
+      continue;
+    }
 
     int id = 0;
     std::string name = "blockwrite_data";
@@ -373,6 +390,7 @@ static LogicalResult convertTransactionOpsToMLIR(
         loc, name, builder.getStringAttr("private"), memrefType,
         DenseElementsAttr::get<uint32_t>(tensorType, data32), true, nullptr);
     global_data.push_back(global);
+    globals_by_data[std::move(data32)] = global;
   }
 
   // create aiex.runtime_sequence
@@ -443,9 +461,267 @@ xilinx::AIE::convertTransactionBinaryToMLIR(mlir::MLIRContext *ctx,
   return module;
 }
 
+// Returns the serialized transaction collected by `ctl`.
+static std::vector<uint8_t> exportTransaction(AIERTControl &ctl) {
+  uint8_t *txn_ptr = XAie_ExportSerializedTransaction(&ctl.devInst, 0, 0);
+  XAie_TxnHeader *hdr = (XAie_TxnHeader *)txn_ptr;
+  return std::vector<uint8_t>(txn_ptr, txn_ptr + hdr->TxnSize);
+}
+
+static bool haveSameContents(StringRef path, StringRef otherPath) {
+  auto file = llvm::MemoryBuffer::getFile(path);
+  auto otherFile = llvm::MemoryBuffer::getFile(otherPath);
+  return file && otherFile &&
+         (*file)->getBuffer() == (*otherFile)->getBuffer();
+}
+
+// Returns the tiles whose BDs the runtime sequences of `device` program,
+// besides the shim tiles: those of the tasks and BD writes of the sequences.
+static std::set<TileID> getRuntimeSequenceBdTiles(DeviceOp device) {
+  std::set<TileID> tiles;
+  device.walk([&](Operation *op) {
+    if (auto task = dyn_cast<AIEX::DMAConfigureTaskOp>(op)) {
+      TileOp tile = task.getTileOp();
+      tiles.insert({tile.colIndex(), tile.rowIndex()});
+    } else if (auto writeBd = dyn_cast<AIEX::NpuWriteBdOp>(op)) {
+      tiles.insert({static_cast<int>(writeBd.getColumn()),
+                    static_cast<int>(writeBd.getRow())});
+    }
+  });
+  return tiles;
+}
+
+// The DMA channels, BDs and locks that the configuration of a device sets up,
+// by tile.
+struct DmaResources {
+  std::set<std::tuple<int, int, DMAChannelDir, int>> channels;
+  std::set<std::tuple<int, int, int>> bds;
+  std::set<std::tuple<int, int, int>> locks;
+};
+
+static DmaResources getDmaResources(DeviceOp device) {
+  DmaResources resources;
+  // the tile of the DMA an op is in, if any: the BDs of the tasks of runtime
+  // sequences are not part of the configuration
+  auto getTile = [](Operation *op) -> std::optional<TileID> {
+    for (Operation *parent = op->getParentOp(); parent;
+         parent = parent->getParentOp())
+      if (auto element = dyn_cast<TileElement>(parent))
+        return element.getTileID();
+    return std::nullopt;
+  };
+  device.walk([&](Operation *op) {
+    if (auto start = dyn_cast<DMAStartOp>(op)) {
+      if (auto tile = getTile(op))
+        resources.channels.insert({tile->col, tile->row,
+                                   start.getChannelDir(),
+                                   start.getChannelIndex()});
+    } else if (auto dma = dyn_cast<DMAOp>(op)) {
+      if (auto tile = getTile(op))
+        resources.channels.insert({tile->col, tile->row, dma.getChannelDir(),
+                                   dma.getChannelIndex()});
+    } else if (auto bd = dyn_cast<DMABDOp>(op)) {
+      auto tile = getTile(op);
+      if (tile && bd.getBdId())
+        resources.bds.insert({tile->col, tile->row, *bd.getBdId()});
+    } else if (auto lock = dyn_cast<LockOp>(op)) {
+      TileOp tile = lock.getTileOp();
+      if (lock.getLockID())
+        resources.locks.insert(
+            {tile.colIndex(), tile.rowIndex(), *lock.getLockID()});
+    }
+  });
+  return resources;
+}
+
+// Collects the configuration of `device` that differs from the state the
+// baseline design leaves the array in: the ELFs of the new and changed cores,
+// the teardown of the baseline stream switch connections, DMA channels, BDs
+// and locks that the design does not use, and the writes that change a
+// register. Some registers do not keep
+// the value the baseline configuration gives them, so their writes are always
+// kept: the DMA channel registers, which act on the array, the lock values,
+// which the cores and DMAs change as they run, and the BDs that a runtime
+// sequence of either design may program.
+static LogicalResult collectDeltaTransactions(
+    AIE::DeviceOp device, StringRef elfDir, StringRef baselinePath,
+    StringRef baselineElfDir, std::vector<std::vector<uint8_t>> &txns,
+    std::vector<TransactionBinaryOperation> &operations) {
+
+  const BaseNPUTargetModel &targetModel =
+      (const BaseNPUTargetModel &)device.getTargetModel();
+
+  // The baseline is parsed in its own context, as dialects cannot be loaded
+  // into the context of a running pass.
+  MLIRContext baselineContext(device->getContext()->getDialectRegistry());
+  OwningOpRef<ModuleOp> baselineModule =
+      parseSourceFile<ModuleOp>(baselinePath, &baselineContext);
+  if (!baselineModule)
+    return device.emitOpError("cannot parse the baseline design ")
+           << baselinePath;
+  DeviceOp baselineDevice;
+  for (DeviceOp d : baselineModule->getOps<DeviceOp>())
+    if (d.getDevice() == device.getDevice()) {
+      baselineDevice = d;
+      break;
+    }
+  if (!baselineDevice)
+    return device.emitOpError("the baseline design has no ")
+           << stringifyAIEDevice(device.getDevice()) << " device";
+
+  // The state of the array after the baseline configuration. The ELFs are
+  // compared file by file rather than through the program memory.
+  AIERTControl baselineCtl(targetModel);
+  if (failed(baselineCtl.setIOBackend(false, false)))
+    return failure();
+  baselineCtl.startTransaction();
+  if (failed(generateTransactions(baselineCtl, "", baselineDevice, false,
+                                  false, true, true)))
+    return failure();
+  std::vector<uint8_t> baselineTxn = exportTransaction(baselineCtl);
+  std::vector<uint32_t> baselineWords(baselineTxn.size() / sizeof(uint32_t));
+  std::memcpy(baselineWords.data(), baselineTxn.data(),
+              baselineWords.size() * sizeof(uint32_t));
+  TxnInterpreter baseline(targetModel);
+  if (failed(baseline.run(baselineWords)))
+    return failure();
+
+  // Load the ELFs of the new cores and of the cores whose ELF changed, and
+  // stop the cores the design no longer has. Without a baseline ELF
+  // directory, the ELFs cannot be compared and are all loaded.
+  AIERTControl elfCtl(targetModel);
+  if (failed(elfCtl.setIOBackend(false, false)))
+    return failure();
+  elfCtl.startTransaction();
+  std::map<std::pair<int, int>, CoreOp> baselineCores;
+  for (CoreOp core : baselineDevice.getOps<CoreOp>())
+    baselineCores[{core.colIndex(), core.rowIndex()}] = core;
+  for (CoreOp core : device.getOps<CoreOp>()) {
+    auto baselineCore = baselineCores.find({core.colIndex(), core.rowIndex()});
+    bool changed = true;
+    if (baselineCore != baselineCores.end()) {
+      changed = baselineElfDir.empty() ||
+                !haveSameContents(
+                    getCoreElfPath(core, elfDir),
+                    getCoreElfPath(baselineCore->second, baselineElfDir));
+      baselineCores.erase(baselineCore);
+    }
+    if (!elfDir.empty() && changed &&
+        failed(elfCtl.addAieElf(core.colIndex(), core.rowIndex(),
+                                getCoreElfPath(core, elfDir), false)))
+      return failure();
+  }
+  for (auto &[tile, core] : baselineCores)
+    TRY_XAIE_API_LOGICAL_RESULT(XAie_CoreDisable, &elfCtl.devInst,
+                                XAie_TileLoc(tile.first, tile.second));
+
+  // Stop the DMA channels that only the baseline uses, and invalidate the
+  // BDs and zero the locks that only the baseline sets up, so that nothing
+  // the baseline left running moves data or holds a lock.
+  DmaResources resources = getDmaResources(device);
+  DmaResources baselineResources = getDmaResources(baselineDevice);
+  for (auto [col, row, dir, channel] : baselineResources.channels)
+    if (!resources.channels.count({col, row, dir, channel}))
+      TRY_XAIE_API_LOGICAL_RESULT(
+          XAie_DmaChannelDisable, &elfCtl.devInst, XAie_TileLoc(col, row),
+          channel, dir == DMAChannelDir::S2MM ? DMA_S2MM : DMA_MM2S);
+  for (auto [col, row, bdId] : baselineResources.bds)
+    if (!resources.bds.count({col, row, bdId})) {
+      XAie_LocType tileLoc = XAie_TileLoc(col, row);
+      XAie_DmaDesc bd;
+      TRY_XAIE_API_LOGICAL_RESULT(XAie_DmaDescInit, &elfCtl.devInst, &bd,
+                                  tileLoc);
+      TRY_XAIE_API_LOGICAL_RESULT(XAie_DmaWriteBd, &elfCtl.devInst, &bd,
+                                  tileLoc, bdId);
+    }
+  for (auto [col, row, lockId] : baselineResources.locks)
+    if (!resources.locks.count({col, row, lockId}))
+      TRY_XAIE_API_LOGICAL_RESULT(XAie_LockSetValue, &elfCtl.devInst,
+                                  XAie_TileLoc(col, row),
+                                  XAie_LockInit(lockId, 0));
+
+  AIERTControl ctl(targetModel);
+  if (failed(ctl.setIOBackend(false, false)))
+    return failure();
+  ctl.startTransaction();
+  if (failed(generateTransactions(ctl, "", device, false, false, true, true)))
+    return failure();
+
+  std::vector<TransactionBinaryOperation> elfOps;
+  std::vector<TransactionBinaryOperation> configOps;
+  txns.push_back(exportTransaction(elfCtl));
+  if (!parseTransactionBinary(txns.back(), elfOps))
+    return failure();
+  txns.push_back(exportTransaction(ctl));
+  if (!parseTransactionBinary(txns.back(), configOps))
+    return failure();
+
+  std::set<TileID> runtimeBdTiles = getRuntimeSequenceBdTiles(device);
+  runtimeBdTiles.merge(getRuntimeSequenceBdTiles(baselineDevice));
+  auto isVolatile = [&](uint64_t address) {
+    if (baseline.isDmaChannelRegister(address) ||
+        baseline.isLockRegister(address))
+      return true;
+    if (!baseline.isBdRegister(address))
+      return false;
+    TileID tile = baseline.getTile(address);
+    return targetModel.isShimNOCorPLTile(tile.col, tile.row) ||
+           runtimeBdTiles.count(tile);
+  };
+
+  // Returns true if the operation changes a register of the array state.
+  std::map<uint64_t, uint32_t> state = baseline.getRegisters();
+  llvm::DenseSet<uint64_t> written;
+  auto apply = [&](const TransactionBinaryOperation &op) {
+    bool changed = false;
+    auto write = [&](uint64_t address, uint32_t value, uint32_t mask) {
+      written.insert(address);
+      auto it = state.find(address);
+      uint32_t oldValue = it != state.end() ? it->second : 0;
+      uint32_t newValue = (oldValue & ~mask) | (value & mask);
+      if (it == state.end() || newValue != oldValue || isVolatile(address))
+        changed = true;
+      state[address] = newValue;
+    };
+    if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE) {
+      write(op.cmd.RegOff, op.cmd.Value, 0xFFFFFFFF);
+    } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
+      write(op.cmd.RegOff, op.cmd.Value, op.cmd.Mask);
+    } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
+      const uint32_t *data = reinterpret_cast<const uint32_t *>(op.cmd.DataPtr);
+      for (uint32_t i = 0; i < op.cmd.Size / sizeof(uint32_t); i++)
+        write(op.cmd.RegOff + i * sizeof(uint32_t), data[i], 0xFFFFFFFF);
+    }
+    return changed;
+  };
+
+  // The ELF loads and the teardown of the baseline DMAs are always kept. The
+  // ELF loads disable the cores and reset their DMA channels, which the
+  // configuration then has to undo.
+  for (const TransactionBinaryOperation &op : elfOps) {
+    apply(op);
+    operations.push_back(op);
+  }
+
+  std::vector<TransactionBinaryOperation> changedOps;
+  for (const TransactionBinaryOperation &op : configOps)
+    if (apply(op))
+      changedOps.push_back(op);
+
+  for (auto [address, value] : baseline.getRegisters())
+    if (value && !written.contains(address) &&
+        baseline.isStreamSwitchRegister(address))
+      operations.emplace_back(XAie_TxnOpcode::XAIE_IO_WRITE, 0, address, 0,
+                              nullptr, 0);
+  llvm::append_range(operations, changedOps);
+  return success();
+}
+
 static LogicalResult convertAIEToConfiguration(AIE::DeviceOp device,
                                                StringRef clElfDir,
-                                               OutputType outputType) {
+                                               OutputType outputType,
+                                               StringRef clBaseline,
+                                               StringRef clBaselineElfDir) {
 
   const BaseNPUTargetModel &targetModel =
       (const BaseNPUTargetModel &)device.getTargetModel();
@@ -453,6 +729,17 @@ static LogicalResult convertAIEToConfiguration(AIE::DeviceOp device,
   if (!targetModel.hasProperty(AIETargetModel::IsNPU))
     return failure();
 
+  if (!clBaseline.empty()) {
+    std::vector<std::vector<uint8_t>> txns;
+    std::vector<TransactionBinaryOperation> operations;
+    if (failed(collectDeltaTransactions(device, clElfDir, clBaseline,
+                                        clBaselineElfDir, txns, operations)))
+      return failure();
+    OpBuilder builder(device.getBodyRegion());
+    return convertTransactionOpsToMLIR(builder, device, outputType,
+                                       operations);
+  }
+
   bool aieSim = false;
   bool xaieDebug = false;
 
@@ -499,7 +786,8 @@ struct ConvertAIEToTransactionPass
   }
   void runOnOperation() override {
     if (failed(convertAIEToConfiguration(getOperation(), clElfDir,
-                                         OutputType::Transaction)))
+                                         OutputType::Transaction, clBaseline,
+                                         clBaselineElfDir)))
       return signalPassFailure();
   }
 };
@@ -511,7 +799,8 @@ struct ConvertAIEToControlPacketsPass
   }
   void runOnOperation() override {
     if (failed(convertAIEToConfiguration(getOperation(), clElfDir,
-                                         OutputType::ControlPacket)))
+                                         OutputType::ControlPacket, clBaseline,
+                                         clBaselineElfDir)))
       return signalPassFailure();
   }
 };
@@ -0,0 +1,992 @@
+//===- AIEVecToHost.cpp - AIEVec to host vector conversion ----------------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file implements the AIE2 AIEVec ops with target-independent arith,
+// vector and memref ops, so that vectorized kernels can run on the host.
+//===----------------------------------------------------------------------===//
+
+#include "../PassDetail.h"
+
+#include "aie/Conversion/AIEVecToHost/AIEVecToHost.h"
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Transforms/DialectConversion.h"
+
+#include "llvm/ADT/StringSwitch.h"
+
+using namespace mlir;
+
+namespace xilinx::aievec {
+
+// Returns a constant vector of `type` with all lanes set to `value`.
+static Value createSplat(OpBuilder &builder, Location loc, VectorType type,
+                         int64_t value) {
+  Type elemTy = type.getElementType();
+  Attribute attr;
+  if (auto floatTy = dyn_cast<FloatType>(elemTy))
+    attr = builder.getFloatAttr(floatTy, (double)value);
+  else
+    attr = builder.getIntegerAttr(elemTy, value);
+  return builder.create<arith::ConstantOp>(
+      loc, type, DenseElementsAttr::get(type, attr));
+}
+
+static Value createSplat(OpBuilder &builder, Location loc, VectorType type,
+                         const APInt &value) {
+  return builder.create<arith::ConstantOp>(
+      loc, type,
+      DenseElementsAttr::get(
+          type, builder.getIntegerAttr(type.getElementType(), value)));
+}
+
+// Converts the elements of a vector to `elemTy`, sign-extending integers and
+// rounding floats to nearest even.
+static Value convertElements(OpBuilder &builder, Location loc, Value value,
+                             Type elemTy) {
+  auto type = cast<VectorType>(value.getType());
+  Type srcTy = type.getElementType();
+  if (srcTy == elemTy)
+    return value;
+  VectorType dstType = type.clone(elemTy);
+  unsigned srcWidth = srcTy.getIntOrFloatBitWidth();
+  unsigned dstWidth = elemTy.getIntOrFloatBitWidth();
+  if (isa<FloatType>(srcTy) && isa<FloatType>(elemTy)) {
+    if (dstWidth > srcWidth)
+      return builder.create<arith::ExtFOp>(loc, dstType, value);
+    return builder.create<arith::TruncFOp>(loc, dstType, value);
+  }
+  if (isa<IntegerType>(srcTy) && isa<IntegerType>(elemTy)) {
+    if (dstWidth > srcWidth)
+      return builder.create<arith::ExtSIOp>(loc, dstType, value);
+    return builder.create<arith::TruncIOp>(loc, dstType, value);
+  }
+  if (isa<IntegerType>(srcTy))
+    return builder.create<arith::SIToFPOp>(loc, dstType, value);
+  return builder.create<arith::FPToSIOp>(loc, dstType, value);
+}
+
+// Returns `value`, an integer vector, clamped to the range of `elemTy`.
+static Value saturateTo(OpBuilder &builder, Location loc, Value value,
+                        IntegerType elemTy) {
+  auto type = cast<VectorType>(value.getType());
+  unsigned width = type.getElementTypeBitWidth();
+  unsigned dstWidth = elemTy.getWidth();
+  if (dstWidth >= width)
+    return value;
+  Value minValue = createSplat(builder, loc, type,
+                               APInt::getSignedMinValue(dstWidth).sext(width));
+  Value maxValue = createSplat(builder, loc, type,
+                               APInt::getSignedMaxValue(dstWidth).sext(width));
+  value = builder.create<arith::MaxSIOp>(loc, value, minValue);
+  return builder.create<arith::MinSIOp>(loc, value, maxValue);
+}
+
+// Shifts the lanes of `value`, an integer vector, right by `shift` bits and
+// rounds the result with `mode`, as the SRS unit does. The shift is a scalar
+// integer. The quotient and remainder of the shift are computed separately so
+// that rounding cannot overflow.
+static Value shiftRightAndRound(OpBuilder &builder, Location loc, Value value,
+                                Value shift, AIEVecRoundingMode mode) {
+  auto type = cast<VectorType>(value.getType());
+  auto elemTy = cast<IntegerType>(type.getElementType());
+  unsigned shiftWidth = shift.getType().getIntOrFloatBitWidth();
+  if (shiftWidth < elemTy.getWidth())
+    shift = builder.create<arith::ExtUIOp>(loc, elemTy, shift);
+  else if (shiftWidth > elemTy.getWidth())
+    shift = builder.create<arith::TruncIOp>(loc, elemTy, shift);
+  shift = builder.create<vector::BroadcastOp>(loc, type, shift);
+
+  Value quotient = builder.create<arith::ShRSIOp>(loc, value, shift);
+  if (mode == AIEVecRoundingMode::Floor)
+    return quotient;
+
+  Value zero = createSplat(builder, loc, type, 0);
+  Value one = createSplat(builder, loc, type, 1);
+  Value remainder = builder.create<arith::SubIOp>(
+      loc, value, builder.create<arith::ShLIOp>(loc, quotient, shift));
+  // Half of the weight of the last bit shifted out, zero without shift.
+  Value half = builder.create<arith::ShRUIOp>(
+      loc, builder.create<arith::ShLIOp>(loc, one, shift), one);
+
+  auto cmp = [&](arith::CmpIPredicate pred, Value lhs, Value rhs) -> Value {
+    return builder.create<arith::CmpIOp>(loc, pred, lhs, rhs);
+  };
+  auto andOp = [&](Value lhs, Value rhs) -> Value {
+    return builder.create<arith::AndIOp>(loc, lhs, rhs);
+  };
+  auto orOp = [&](Value lhs, Value rhs) -> Value {
+    return builder.create<arith::OrIOp>(loc, lhs, rhs);
+  };
+  auto select = [&](Value cond, Value lhs, Value rhs) -> Value {
+    return builder.create<arith::SelectOp>(loc, cond, lhs, rhs);
+  };
+
+  // The remainder is never negative, so these are unsigned comparisons.
+  Value inexact = cmp(arith::CmpIPredicate::ne, remainder, zero);
+  Value aboveHalf = cmp(arith::CmpIPredicate::ugt, remainder, half);
+  Value tie = andOp(inexact, cmp(arith::CmpIPredicate::eq, remainder, half));
+  Value halfOrAbove = orOp(aboveHalf, tie);
+  Value negative = cmp(arith::CmpIPredicate::slt, value, zero);
+  Value lsb = builder.create<arith::AndIOp>(loc, quotient, one);
+
+  Value increment;
+  switch (mode) {
+  case AIEVecRoundingMode::Floor:
+    llvm_unreachable("handled above");
+  case AIEVecRoundingMode::Ceil:
+    increment = inexact;
+    break;
+  case AIEVecRoundingMode::SymFloor:
+    increment = andOp(inexact, negative);
+    break;
+  case AIEVecRoundingMode::SymCeil:
+    increment = andOp(inexact, cmp(arith::CmpIPredicate::sge, value, zero));
+    break;
+  case AIEVecRoundingMode::PosInf:
+    increment = halfOrAbove;
+    break;
+  case AIEVecRoundingMode::NegInf:
+    increment = aboveHalf;
+    break;
+  case AIEVecRoundingMode::SymInf:
+    increment = select(negative, aboveHalf, halfOrAbove);
+    break;
+  case AIEVecRoundingMode::SymZero:
+    increment = select(negative, halfOrAbove, aboveHalf);
+    break;
+  case AIEVecRoundingMode::ConvEven:
+    increment =
+        orOp(aboveHalf, andOp(tie, cmp(arith::CmpIPredicate::ne, lsb, zero)));
+    break;
+  case AIEVecRoundingMode::ConvOdd:
+    increment =
+        orOp(aboveHalf, andOp(tie, cmp(arith::CmpIPredicate::eq, lsb, zero)));
+    break;
+  }
+  return builder.create<arith::AddIOp>(
+      loc, quotient, builder.create<arith::ExtUIOp>(loc, type, increment));
+}
+
+// Returns a vector of `type` with all lanes set to zero.
+static Value createZero(OpBuilder &builder, Location loc, VectorType type) {
+  return createSplat(builder, loc, type, 0);
+}
+
+// Bitcasts a 1-D vector to a vector of `elemTy` of the same size.
+static Value bitcastElements(OpBuilder &builder, Location loc, Value value,
+                             Type elemTy) {
+  auto type = cast<VectorType>(value.getType());
+  if (type.getElementType() == elemTy)
+    return value;
+  int64_t bits = getVectorSizeInBits(type);
+  auto dstType =
+      VectorType::get({bits / (int64_t)elemTy.getIntOrFloatBitWidth()}, elemTy);
+  return builder.create<vector::BitCastOp>(loc, dstType, value);
+}
+
+//===----------------------------------------------------------------------===//
+// Elementwise arithmetic
+//===----------------------------------------------------------------------===//
+
+template <typename SrcOpTy, typename IntOpTy, typename FloatOpTy>
+class BinaryOpConversion : public OpConversionPattern<SrcOpTy> {
+public:
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (isa<FloatType>(getElementTypeOrSelf(op.getType())))
+      rewriter.replaceOpWithNewOp<FloatOpTy>(op, adaptor.getLhs(),
+                                             adaptor.getRhs());
+    else
+      rewriter.replaceOpWithNewOp<IntOpTy>(op, adaptor.getLhs(),
+                                           adaptor.getRhs());
+    return success();
+  }
+};
+
+using AddElemOpConversion =
+    BinaryOpConversion<aievec::AddElemOp, arith::AddIOp, arith::AddFOp>;
+using SubElemOpConversion =
+    BinaryOpConversion<aievec::SubElemOp, arith::SubIOp, arith::SubFOp>;
+using MaxOpConversion =
+    BinaryOpConversion<aievec::MaxOp, arith::MaxSIOp, arith::MaximumFOp>;
+using MinOpConversion =
+    BinaryOpConversion<aievec::MinOp, arith::MinSIOp, arith::MinimumFOp>;
+
+// The bitwise ops act on the bits of bfloat16 lanes too.
+template <typename SrcOpTy, typename IntOpTy>
+class BitwiseOpConversion : public OpConversionPattern<SrcOpTy> {
+public:
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto type = cast<VectorType>(op.getType());
+    Type intTy = rewriter.getIntegerType(type.getElementTypeBitWidth());
+    Value lhs = bitcastElements(rewriter, loc, adaptor.getLhs(), intTy);
+    Value rhs = bitcastElements(rewriter, loc, adaptor.getRhs(), intTy);
+    Value result = rewriter.create<IntOpTy>(loc, lhs, rhs);
+    rewriter.replaceOp(op, bitcastElements(rewriter, loc, result,
+                                           type.getElementType()));
+    return success();
+  }
+};
+
+using BandOpConversion = BitwiseOpConversion<aievec::BandOp, arith::AndIOp>;
+using BorOpConversion = BitwiseOpConversion<aievec::BorOp, arith::OrIOp>;
+using BxorOpConversion = BitwiseOpConversion<aievec::BxorOp, arith::XOrIOp>;
+
+class BnegOpConversion : public OpConversionPattern<aievec::BnegOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::BnegOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto type = cast<VectorType>(op.getType());
+    Type intTy = rewriter.getIntegerType(type.getElementTypeBitWidth());
+    Value source = bitcastElements(rewriter, loc, adaptor.getSource(), intTy);
+    Value ones = createSplat(rewriter, loc, cast<VectorType>(source.getType()),
+                             -1);
+    Value result = rewriter.create<arith::XOrIOp>(loc, source, ones);
+    rewriter.replaceOp(op, bitcastElements(rewriter, loc, result,
+                                           type.getElementType()));
+    return success();
+  }
+};
+
+class NegOpConversion : public OpConversionPattern<aievec::NegOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::NegOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto type = cast<VectorType>(op.getType());
+    if (isa<FloatType>(type.getElementType()))
+      rewriter.replaceOpWithNewOp<arith::NegFOp>(op, adaptor.getSource());
+    else
+      rewriter.replaceOpWithNewOp<arith::SubIOp>(
+          op, createZero(rewriter, op.getLoc(), type), adaptor.getSource());
+    return success();
+  }
+};
+
+// The operands are converted to the element type of the accumulator, where
+// the products of all supported types are exact.
+class MulElemOpConversion : public OpConversionPattern<aievec::MulElemOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::MulElemOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    Type accTy = getElementTypeOrSelf(op.getType());
+    Value lhs = convertElements(rewriter, loc, adaptor.getLhs(), accTy);
+    Value rhs = convertElements(rewriter, loc, adaptor.getRhs(), accTy);
+    if (isa<FloatType>(accTy))
+      rewriter.replaceOpWithNewOp<arith::MulFOp>(op, lhs, rhs);
+    else
+      rewriter.replaceOpWithNewOp<arith::MulIOp>(op, lhs, rhs);
+    return success();
+  }
+};
+
+class FMAElemOpConversion : public OpConversionPattern<aievec::FMAElemOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::FMAElemOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    Type accTy = getElementTypeOrSelf(op.getType());
+    Value lhs = convertElements(rewriter, loc, adaptor.getLhs(), accTy);
+    Value rhs = convertElements(rewriter, loc, adaptor.getRhs(), accTy);
+    Value acc = adaptor.getAcc();
+    if (isa<FloatType>(accTy)) {
+      Value product = rewriter.create<arith::MulFOp>(loc, lhs, rhs);
+      if (op.getFmsub())
+        rewriter.replaceOpWithNewOp<arith::SubFOp>(op, acc, product);
+      else
+        rewriter.replaceOpWithNewOp<arith::AddFOp>(op, acc, product);
+    } else {
+      Value product = rewriter.create<arith::MulIOp>(loc, lhs, rhs);
+      if (op.getFmsub())
+        rewriter.replaceOpWithNewOp<arith::SubIOp>(op, acc, product);
+      else
+        rewriter.replaceOpWithNewOp<arith::AddIOp>(op, acc, product);
+    }
+    return success();
+  }
+};
+
+// Returns `acc` plus the matrix product of `lhs` and `rhs`, all of the same
+// element type.
+static Value createMatMul(OpBuilder &builder, Location loc, Value lhs,
+                          Value rhs, Value acc) {
+  MLIRContext *ctx = builder.getContext();
+  // (m, n, k): lhs[m, k] * rhs[k, n] -> acc[m, n]
+  AffineExpr m, n, k;
+  bindDims(ctx, m, n, k);
+  auto indexingMaps = builder.getAffineMapArrayAttr(
+      {AffineMap::get(3, 0, {m, k}, ctx), AffineMap::get(3, 0, {k, n}, ctx),
+       AffineMap::get(3, 0, {m, n}, ctx)});
+  auto iteratorTypes = builder.getArrayAttr(
+      {vector::IteratorTypeAttr::get(ctx, vector::IteratorType::parallel),
+       vector::IteratorTypeAttr::get(ctx, vector::IteratorType::parallel),
+       vector::IteratorTypeAttr::get(ctx, vector::IteratorType::reduction)});
+  return builder.create<vector::ContractionOp>(loc, lhs, rhs, acc,
+                                               indexingMaps, iteratorTypes);
+}
+
+class MatMulOpConversion : public OpConversionPattern<aievec::MatMulOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::MatMulOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    Type accTy = getElementTypeOrSelf(op.getType());
+    Value lhs = convertElements(rewriter, loc, adaptor.getLhs(), accTy);
+    Value rhs = convertElements(rewriter, loc, adaptor.getRhs(), accTy);
+    rewriter.replaceOp(
+        op, createMatMul(rewriter, loc, lhs, rhs, adaptor.getAcc()));
+    return success();
+  }
+};
+
+// The operands hold the values of their bfp16 elements in f32, where the
+// products of 8-bit mantissas are exact.
+class MatMulBFPOpConversion : public OpConversionPattern<aievec::MatMulBFPOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::MatMulBFPOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    rewriter.replaceOp(op, createMatMul(rewriter, op.getLoc(), adaptor.getLhs(),
+                                        adaptor.getRhs(), adaptor.getAcc()));
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// Accumulator moves
+//===----------------------------------------------------------------------===//
+
+class UPSOpConversion : public OpConversionPattern<aievec::UPSOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::UPSOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultType = cast<VectorType>(op.getType());
+    Type accTy = resultType.getElementType();
+    Value result =
+        convertElements(rewriter, loc, adaptor.getSource(), accTy);
+    if (op.getShift() != 0) {
+      if (!isa<IntegerType>(accTy))
+        return rewriter.notifyMatchFailure(op, "shift of a float accumulator");
+      result = rewriter.create<arith::ShLIOp>(
+          loc, result,
+          createSplat(rewriter, loc, resultType, op.getShift()));
+    }
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+class SRSOpConversion : public OpConversionPattern<aievec::SRSOp> {
+public:
+  SRSOpConversion(TypeConverter &converter, MLIRContext *context,
+                  AIEVecRoundingMode roundingMode, bool saturate)
+      : OpConversionPattern(converter, context), roundingMode(roundingMode),
+        saturate(saturate) {}
+
+  LogicalResult
+  matchAndRewrite(aievec::SRSOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    Type resultTy = getElementTypeOrSelf(op.getType());
+    Value source = adaptor.getSource();
+    Type accTy = getElementTypeOrSelf(source.getType());
+    if (isa<FloatType>(accTy) || isa<FloatType>(resultTy)) {
+      if (!isa<FloatType>(accTy) || !isa<FloatType>(resultTy))
+        return rewriter.notifyMatchFailure(op, "mixed int and float srs");
+      rewriter.replaceOp(op, convertElements(rewriter, loc, source, resultTy));
+      return success();
+    }
+
+    Value result = shiftRightAndRound(rewriter, loc, source,
+                                      adaptor.getShift(), roundingMode);
+    if (saturate)
+      result = saturateTo(rewriter, loc, result, cast<IntegerType>(resultTy));
+    rewriter.replaceOp(op, convertElements(rewriter, loc, result, resultTy));
+    return success();
+  }
+
+private:
+  AIEVecRoundingMode roundingMode;
+  bool saturate;
+};
+
+class PackOpConversion : public OpConversionPattern<aievec::PackOp> {
+public:
+  PackOpConversion(TypeConverter &converter, MLIRContext *context,
+                   bool saturate)
+      : OpConversionPattern(converter, context), saturate(saturate) {}
+
+  LogicalResult
+  matchAndRewrite(aievec::PackOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultTy = cast<IntegerType>(getElementTypeOrSelf(op.getType()));
+    Value result = adaptor.getSource();
+    if (saturate)
+      result = saturateTo(rewriter, loc, result, resultTy);
+    rewriter.replaceOp(op, convertElements(rewriter, loc, result, resultTy));
+    return success();
+  }
+
+private:
+  bool saturate;
+};
+
+class UnpackOpConversion : public OpConversionPattern<aievec::UnpackOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::UnpackOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    rewriter.replaceOp(op, convertElements(rewriter, op.getLoc(),
+                                           adaptor.getSource(),
+                                           getElementTypeOrSelf(op.getType())));
+    return success();
+  }
+};
+
+// Quantizes each block of 8 elements to 8-bit mantissas that share the
+// exponent of the largest magnitude of the block, scaled so that it lies in
+// [64, 128). The result holds the values of the bfp16 elements in f32.
+class PackBFPOpConversion : public OpConversionPattern<aievec::PackBFPOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::PackBFPOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultTy = getTypeConverter()->convertType<VectorType>(op.getType());
+    if (!resultTy)
+      return failure();
+    int64_t blockSize = aievec::BFP16Type::getBlockSize();
+    auto blocksTy =
+        VectorType::get({op.getType().getNumElements() / blockSize, blockSize},
+                        rewriter.getF32Type());
+    auto bitsTy = blocksTy.clone(rewriter.getI32Type());
+    auto blockBitsTy = VectorType::get(blocksTy.getShape().front(),
+                                       rewriter.getI32Type());
+    auto splat = [&](VectorType type, int64_t value) {
+      return createSplat(rewriter, loc, type, value);
+    };
+
+    Value source = convertElements(rewriter, loc, adaptor.getSource(),
+                                   rewriter.getF32Type());
+    Value blocks = source;
+    if (source.getType() != blocksTy)
+      blocks = rewriter.create<vector::ShapeCastOp>(loc, blocksTy, source);
+
+    // The biased exponent grows with the magnitude, so that of the largest
+    // magnitude of a block is the maximum over the block. It is at least 7 so
+    // that the scales below are normal floats.
+    Value bits = rewriter.create<vector::BitCastOp>(loc, bitsTy, blocks);
+    Value exponents = rewriter.create<arith::AndIOp>(
+        loc, rewriter.create<arith::ShRUIOp>(loc, bits, splat(bitsTy, 23)),
+        splat(bitsTy, 0xFF));
+    Value blockExponents = rewriter.create<vector::MultiDimReductionOp>(
+        loc, exponents, splat(blockBitsTy, 7), ArrayRef<bool>{false, true},
+        vector::CombiningKind::MAXUI);
+    auto transposedTy = VectorType::get({blockSize, blocksTy.getDimSize(0)},
+                                        rewriter.getI32Type());
+    Value exponent = rewriter.create<vector::TransposeOp>(
+        loc, rewriter.create<vector::BroadcastOp>(loc, transposedTy,
+                                                  blockExponents),
+        ArrayRef<int64_t>{1, 0});
+
+    // 2^(6 - e) and 2^(e - 6), with e the unbiased exponent.
+    auto createPowerOfTwo = [&](Value biasedExponent) -> Value {
+      Value powerBits = rewriter.create<arith::ShLIOp>(loc, biasedExponent,
+                                                       splat(bitsTy, 23));
+      return rewriter.create<vector::BitCastOp>(loc, blocksTy, powerBits);
+    };
+    Value scale = createPowerOfTwo(
+        rewriter.create<arith::SubIOp>(loc, splat(bitsTy, 260), exponent));
+    Value invScale = createPowerOfTwo(
+        rewriter.create<arith::SubIOp>(loc, exponent, splat(bitsTy, 6)));
+
+    // Scaling by a power of two is exact, and adding and subtracting 1.5 * 2^23
+    // rounds to nearest even.
+    Value scaled = rewriter.create<arith::MulFOp>(loc, blocks, scale);
+    Value magic = splat(blocksTy, 0xC00000);
+    Value mantissas = rewriter.create<arith::SubFOp>(
+        loc, rewriter.create<arith::AddFOp>(loc, scaled, magic), magic);
+    mantissas = rewriter.create<arith::MaximumFOp>(loc, mantissas,
+                                                   splat(blocksTy, -128));
+    mantissas = rewriter.create<arith::MinimumFOp>(loc, mantissas,
+                                                   splat(blocksTy, 127));
+    Value values = rewriter.create<arith::MulFOp>(loc, mantissas, invScale);
+    if (resultTy != blocksTy)
+      values = rewriter.create<vector::ShapeCastOp>(loc, resultTy, values);
+    rewriter.replaceOp(op, values);
+    return success();
+  }
+};
+
+// The conversion from bfp16 is exact.
+class UnpackBFPOpConversion : public OpConversionPattern<aievec::UnpackBFPOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::UnpackBFPOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    rewriter.replaceOp(op, convertElements(rewriter, op.getLoc(),
+                                           adaptor.getSource(),
+                                           op.getType().getElementType()));
+    return success();
+  }
+};
+
+class CastOpConversion : public OpConversionPattern<aievec::CastOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::CastOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (adaptor.getSource().getType() == op.getType())
+      rewriter.replaceOp(op, adaptor.getSource());
+    else
+      rewriter.replaceOpWithNewOp<vector::BitCastOp>(op, op.getType(),
+                                                     adaptor.getSource());
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// Data movement
+//===----------------------------------------------------------------------===//
+
+class BroadcastOpConversion : public OpConversionPattern<aievec::BroadcastOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::BroadcastOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Value lane = rewriter.create<vector::ExtractOp>(
+        op.getLoc(), adaptor.getSource(), ArrayRef<int64_t>{op.getIdx()});
+    rewriter.replaceOpWithNewOp<vector::BroadcastOp>(op, op.getType(), lane);
+    return success();
+  }
+};
+
+class BroadcastScalarOpConversion
+    : public OpConversionPattern<aievec::BroadcastScalarOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::BroadcastScalarOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    rewriter.replaceOpWithNewOp<vector::BroadcastOp>(op, op.getType(),
+                                                     adaptor.getSource());
+    return success();
+  }
+};
+
+class ExtElemOpConversion : public OpConversionPattern<aievec::ExtElemOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ExtElemOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Value index = rewriter.create<arith::IndexCastOp>(
+        op.getLoc(), rewriter.getIndexType(), adaptor.getIndex());
+    rewriter.replaceOpWithNewOp<vector::ExtractOp>(
+        op, adaptor.getSource(), ArrayRef<OpFoldResult>{index});
+    return success();
+  }
+};
+
+class ConcatOpConversion : public OpConversionPattern<aievec::ConcatOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ConcatOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultType = cast<VectorType>(op.getType());
+    Value result = createZero(rewriter, loc, resultType);
+    int64_t offset = 0;
+    for (Value source : adaptor.getSources()) {
+      result = rewriter.create<vector::InsertStridedSliceOp>(
+          loc, source, result, ArrayRef<int64_t>{offset},
+          ArrayRef<int64_t>{1});
+      offset += cast<VectorType>(source.getType()).getNumElements();
+    }
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+class ExtOpConversion : public OpConversionPattern<aievec::ExtOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ExtOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    int64_t lanes = cast<VectorType>(op.getType()).getNumElements();
+    rewriter.replaceOpWithNewOp<vector::ExtractStridedSliceOp>(
+        op, adaptor.getSource(), ArrayRef<int64_t>{op.getIndex() * lanes},
+        ArrayRef<int64_t>{lanes}, ArrayRef<int64_t>{1});
+    return success();
+  }
+};
+
+// Vectors of up to 256 bits are loaded whole. Larger ones are loaded one half
+// at a time, into the half selected by the index of the linked vector.
+class UPDOpConversion : public OpConversionPattern<aievec::UPDOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::UPDOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultType = cast<VectorType>(op.getType());
+    if (getVectorSizeInBits(resultType) <= 256) {
+      rewriter.replaceOpWithNewOp<vector::LoadOp>(
+          op, resultType, adaptor.getSource(), adaptor.getIndices());
+      return success();
+    }
+
+    int64_t lanes = resultType.getNumElements() / 2;
+    Value half = rewriter.create<vector::LoadOp>(
+        loc, VectorType::get({lanes}, resultType.getElementType()),
+        adaptor.getSource(), adaptor.getIndices());
+    Value dest = adaptor.getVector();
+    if (!dest)
+      dest = createZero(rewriter, loc, resultType);
+    rewriter.replaceOpWithNewOp<vector::InsertStridedSliceOp>(
+        op, half, dest, ArrayRef<int64_t>{op.getIndex() * lanes},
+        ArrayRef<int64_t>{1});
+    return success();
+  }
+};
+
+// Returns the bytes [shift, shift + size) of the concatenation lhs:rhs.
+class ShiftOpConversion : public OpConversionPattern<aievec::ShiftOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ShiftOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    Type i8Ty = rewriter.getI8Type();
+    Value lhs = bitcastElements(rewriter, loc, adaptor.getLhs(), i8Ty);
+    Value rhs = bitcastElements(rewriter, loc, adaptor.getRhs(), i8Ty);
+    auto bytesType = cast<VectorType>(lhs.getType());
+    int64_t bytes = bytesType.getNumElements();
+
+    Value result;
+    APInt shift;
+    if (matchPattern(adaptor.getShift(), m_ConstantInt(&shift))) {
+      SmallVector<int64_t> mask;
+      for (int64_t i = 0; i < bytes; i++)
+        mask.push_back(shift.getZExtValue() + i);
+      result = rewriter.create<vector::ShuffleOp>(loc, lhs, rhs, mask);
+    } else {
+      auto bufferType = MemRefType::get({2 * bytes}, i8Ty);
+      Value buffer = rewriter.create<memref::AllocaOp>(loc, bufferType);
+      Value c0 = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+      Value cBytes = rewriter.create<arith::ConstantIndexOp>(loc, bytes);
+      rewriter.create<vector::StoreOp>(loc, lhs, buffer, ValueRange{c0});
+      rewriter.create<vector::StoreOp>(loc, rhs, buffer, ValueRange{cBytes});
+      Value offset = rewriter.create<arith::IndexCastOp>(
+          loc, rewriter.getIndexType(), adaptor.getShift());
+      result = rewriter.create<vector::LoadOp>(loc, bytesType, buffer,
+                                               ValueRange{offset});
+    }
+    rewriter.replaceOpWithNewOp<vector::BitCastOp>(op, op.getType(), result);
+    return success();
+  }
+};
+
+// Shuffle mode `t<width>_<r>x<c>(_lo|_hi)?` transposes each r x c matrix of
+// <width>-bit lanes of the input. Modes with two operands transpose their
+// concatenation and return its low or high half.
+class ShuffleOpConversion : public OpConversionPattern<aievec::ShuffleOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ShuffleOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    StringRef mode = stringifyShuffleMode(op.getMode());
+    unsigned width, rows, cols;
+    StringRef rest = mode.drop_front();
+    if (rest.consumeInteger(10, width) || !rest.consume_front("_") ||
+        rest.consumeInteger(10, rows) || !rest.consume_front("x") ||
+        rest.consumeInteger(10, cols))
+      return rewriter.notifyMatchFailure(op, "unknown shuffle mode");
+
+    Type laneTy = rewriter.getIntegerType(width);
+    Value lhs = bitcastElements(rewriter, loc, adaptor.getLhs(), laneTy);
+    Value rhs = adaptor.getRhs()
+                    ? bitcastElements(rewriter, loc, adaptor.getRhs(), laneTy)
+                    : lhs;
+    int64_t lanes = cast<VectorType>(lhs.getType()).getNumElements();
+
+    SmallVector<int64_t> mask;
+    if (rest == "_flip") {
+      for (int64_t i = 0; i < lanes; i++)
+        mask.push_back(i ^ 1);
+    } else {
+      int64_t block = rows * cols;
+      int64_t total = adaptor.getRhs() ? 2 * lanes : lanes;
+      SmallVector<int64_t> transposed;
+      for (int64_t base = 0; base < total; base += block)
+        for (int64_t col = 0; col < cols; col++)
+          for (int64_t row = 0; row < rows; row++)
+            transposed.push_back(base + row * cols + col);
+      int64_t first = rest == "_hi" ? lanes : 0;
+      mask.assign(transposed.begin() + first,
+                  transposed.begin() + first + lanes);
+    }
+    Value result = rewriter.create<vector::ShuffleOp>(loc, lhs, rhs, mask);
+    rewriter.replaceOpWithNewOp<vector::BitCastOp>(op, op.getType(), result);
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// Comparison and selection
+//===----------------------------------------------------------------------===//
+
+// Packs a vector of i1 into an integer of `maskTy`, lane i in bit i.
+static Value packMask(OpBuilder &builder, Location loc, Value bits,
+                      IntegerType maskTy) {
+  auto type = cast<VectorType>(bits.getType());
+  int64_t width = maskTy.getWidth();
+  if (type.getNumElements() < width) {
+    Value padded = createZero(
+        builder, loc, VectorType::get({width}, builder.getI1Type()));
+    bits = builder.create<vector::InsertStridedSliceOp>(
+        loc, bits, padded, ArrayRef<int64_t>{0}, ArrayRef<int64_t>{1});
+  }
+  Value word = builder.create<vector::BitCastOp>(
+      loc, VectorType::get({1}, maskTy), bits);
+  return builder.create<vector::ExtractOp>(loc, word, ArrayRef<int64_t>{0});
+}
+
+// Unpacks the low `lanes` bits of an integer into a vector of i1.
+static Value unpackMask(OpBuilder &builder, Location loc, Value mask,
+                        int64_t lanes) {
+  auto maskTy = cast<IntegerType>(mask.getType());
+  Value word = builder.create<vector::BroadcastOp>(
+      loc, VectorType::get({1}, maskTy), mask);
+  Value bits = builder.create<vector::BitCastOp>(
+      loc, VectorType::get({(int64_t)maskTy.getWidth()}, builder.getI1Type()),
+      word);
+  if (lanes == maskTy.getWidth())
+    return bits;
+  return builder.create<vector::ExtractStridedSliceOp>(
+      loc, bits, ArrayRef<int64_t>{0}, ArrayRef<int64_t>{lanes},
+      ArrayRef<int64_t>{1});
+}
+
+class CmpOpConversion : public OpConversionPattern<aievec::CmpOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::CmpOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto maskTy =
+        dyn_cast<IntegerType>(getTypeConverter()->convertType(op.getType()));
+    if (!maskTy)
+      return failure();
+
+    StringRef pred = op.getPred();
+    Value bits;
+    if (isa<FloatType>(getElementTypeOrSelf(op.getLhs().getType()))) {
+      auto predicate =
+          llvm::StringSwitch<std::optional<arith::CmpFPredicate>>(pred)
+              .Case("eq", arith::CmpFPredicate::OEQ)
+              .Case("ne", arith::CmpFPredicate::UNE)
+              .Cases("slt", "ult", arith::CmpFPredicate::OLT)
+              .Cases("sle", "ule", arith::CmpFPredicate::OLE)
+              .Cases("sgt", "ugt", arith::CmpFPredicate::OGT)
+              .Cases("sge", "uge", arith::CmpFPredicate::OGE)
+              .Default(std::nullopt);
+      if (!predicate)
+        return rewriter.notifyMatchFailure(op, "unknown predicate");
+      bits = rewriter.create<arith::CmpFOp>(loc, *predicate, adaptor.getLhs(),
+                                            adaptor.getRhs());
+    } else {
+      auto predicate =
+          llvm::StringSwitch<std::optional<arith::CmpIPredicate>>(pred)
+              .Case("eq", arith::CmpIPredicate::eq)
+              .Case("ne", arith::CmpIPredicate::ne)
+              .Case("slt", arith::CmpIPredicate::slt)
+              .Case("ult", arith::CmpIPredicate::ult)
+              .Case("sle", arith::CmpIPredicate::sle)
+              .Case("ule", arith::CmpIPredicate::ule)
+              .Case("sgt", arith::CmpIPredicate::sgt)
+              .Case("ugt", arith::CmpIPredicate::ugt)
+              .Case("sge", arith::CmpIPredicate::sge)
+              .Case("uge", arith::CmpIPredicate::uge)
+              .Default(std::nullopt);
+      if (!predicate)
+        return rewriter.notifyMatchFailure(op, "unknown predicate");
+      bits = rewriter.create<arith::CmpIOp>(loc, *predicate, adaptor.getLhs(),
+                                            adaptor.getRhs());
+    }
+    rewriter.replaceOp(op, packMask(rewriter, loc, bits, maskTy));
+    return success();
+  }
+};
+
+class SelOpConversion : public OpConversionPattern<aievec::SelOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::SelOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    int64_t lanes = cast<VectorType>(op.getType()).getNumElements();
+    Value bits = unpackMask(rewriter, op.getLoc(), adaptor.getSel(), lanes);
+    // A set bit selects the lane of rhs.
+    rewriter.replaceOpWithNewOp<arith::SelectOp>(op, bits, adaptor.getRhs(),
+                                                 adaptor.getLhs());
+    return success();
+  }
+};
+
+void populateAIEVecToHostConversionPatterns(TypeConverter &converter,
+                                            RewritePatternSet &patterns,
+                                            AIEVecRoundingMode roundingMode,
+                                            bool saturate) {
+  MLIRContext *context = patterns.getContext();
+  // clang-format off
+  patterns.add<AddElemOpConversion,
+               SubElemOpConversion,
+               MaxOpConversion,
+               MinOpConversion,
+               BandOpConversion,
+               BorOpConversion,
+               BxorOpConversion,
+               BnegOpConversion,
+               NegOpConversion,
+               MulElemOpConversion,
+               FMAElemOpConversion,
+               MatMulOpConversion,
+               UPSOpConversion,
+               UnpackOpConversion,
+               PackBFPOpConversion,
+               UnpackBFPOpConversion,
+               MatMulBFPOpConversion,
+               CastOpConversion,
+               BroadcastOpConversion,
+               BroadcastScalarOpConversion,
+               ExtElemOpConversion,
+               ConcatOpConversion,
+               ExtOpConversion,
+               UPDOpConversion,
+               ShiftOpConversion,
+               ShuffleOpConversion,
+               CmpOpConversion,
+               SelOpConversion>(converter, context);
+  // clang-format on
+  patterns.add<SRSOpConversion>(converter, context, roundingMode, saturate);
+  patterns.add<PackOpConversion>(converter, context, saturate);
+}
+
+struct ConvertAIEVecToHostPass
+    : ConvertAIEVecToHostBase<ConvertAIEVecToHostPass> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+
+    // The masks of aievec.cmp and aievec.sel are unsigned integers, which
+    // arith does not accept.
+    TypeConverter converter;
+    converter.addConversion([](Type type) { return type; });
+    converter.addConversion([](IntegerType type) -> Type {
+      if (type.isSignless())
+        return type;
+      return IntegerType::get(type.getContext(), type.getWidth());
+    });
+    // bfp16 vectors hold the values of their elements in f32.
+    converter.addConversion([](BFP16Type type) -> Type {
+      return VectorType::get(type.getShape(),
+                             Float32Type::get(type.getContext()));
+    });
+    auto materialize = [](OpBuilder &builder, Type type, ValueRange inputs,
+                          Location loc) -> Value {
+      return builder.create<UnrealizedConversionCastOp>(loc, type, inputs)
+          .getResult(0);
+    };
+    converter.addSourceMaterialization(materialize);
+    converter.addTargetMaterialization(materialize);
+
+    RewritePatternSet patterns(context);
+    populateAIEVecToHostConversionPatterns(converter, patterns, roundingMode,
+                                           saturate);
+
+    ConversionTarget target(*context);
+    target.addIllegalDialect<xilinx::aievec::AIEVecDialect>();
+    target.addLegalDialect<arith::ArithDialect, memref::MemRefDialect,
+                           vector::VectorDialect>();
+    target.addLegalOp<UnrealizedConversionCastOp>();
+    if (failed(applyPartialConversion(getOperation(), target,
+                                      std::move(patterns))))
+      signalPassFailure();
+  }
+};
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createConvertAIEVecToHostPass() {
+  return std::make_unique<ConvertAIEVecToHostPass>();
+}
+
+} // namespace xilinx::aievec
@@ -41,6 +41,10 @@ namespace LLVM {
 class LLVMDialect;
 } // namespace LLVM
 
+namespace memref {
+class MemRefDialect;
+} // namespace memref
+
 #define GEN_PASS_CLASSES
 #include "aie/Conversion/Passes.h.inc"
 } // namespace mlir
@@ -12,7 +12,11 @@
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 
 #include "mlir/IR/Attributes.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+#include "mlir/Interfaces/ViewLikeInterface.h"
 
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/Twine.h"
 
 #define DEBUG_TYPE "aie-assign-buffers"
@@ -351,7 +355,124 @@ void deAllocationBuffers(SmallVector<BufferOp> &buffers) {
   }
 }
 
-LogicalResult simpleBankAwareAllocation(TileOp tile) {
+//===----------------------------------------------------------------------===//
+// ConflictAwareAllocation : bank-aware allocation that keeps the buffers that
+// are accessed together in different banks
+//===----------------------------------------------------------------------===//
+
+// Number of times each pair of buffers is accessed together, keyed by the
+// pair of buffer operations with the lower Operation pointer first.
+using BufferConflicts = DenseMap<std::pair<Operation *, Operation *>, int>;
+
+// Returns the buffer the given memref is a view of, if any.
+BufferOp getUnderlyingBuffer(Value memref) {
+  while (memref) {
+    if (auto buffer = memref.getDefiningOp<BufferOp>())
+      return buffer;
+    auto view = memref.getDefiningOp<ViewLikeOpInterface>();
+    if (!view)
+      break;
+    memref = view.getViewSource();
+  }
+  return {};
+}
+
+// Function that finds the buffers that are accessed at the same time, and so
+// should be placed in different banks to avoid bank conflicts:
+//  - buffers accessed in the same loop of a core (or in the code of the core
+//    outside any loop), either directly or through a call;
+//  - buffers in the same chain of buffer descriptors, such as the ping-pong
+//    buffers of an objectFifo, one of which is accessed by the DMA while the
+//    core works on the other.
+BufferConflicts findBufferConflicts(DeviceOp device) {
+  BufferConflicts conflicts;
+  auto addConflicts = [&](const llvm::SetVector<Operation *> &buffers) {
+    for (auto [i, a] : llvm::enumerate(buffers))
+      for (Operation *b : llvm::drop_begin(buffers, i + 1))
+        conflicts[a < b ? std::make_pair(a, b) : std::make_pair(b, a)]++;
+  };
+
+  for (auto core : device.getOps<CoreOp>()) {
+    llvm::MapVector<Operation *, llvm::SetVector<Operation *>> accessedTogether;
+    core.walk([&](Operation *op) {
+      if (isa<ViewLikeOpInterface>(op))
+        return;
+      Operation *loop = op->getParentOfType<LoopLikeOpInterface>();
+      if (!loop)
+        loop = core;
+      for (Value operand : op->getOperands())
+        if (auto buffer = getUnderlyingBuffer(operand))
+          accessedTogether[loop].insert(buffer);
+    });
+    for (auto &[_, buffers] : accessedTogether)
+      addConflicts(buffers);
+  }
+
+  device.walk([&](DMAStartOp start) {
+    llvm::SetVector<Operation *> chain;
+    SmallPtrSet<Block *, 4> visited;
+    for (Block *block = start.getDest(); block && visited.insert(block).second;
+         block = block->hasNoSuccessors() ? nullptr : block->getSuccessor(0))
+      for (auto bd : block->getOps<DMABDOp>())
+        if (auto buffer = getUnderlyingBuffer(bd.getBuffer()))
+          chain.insert(buffer);
+    addConflicts(chain);
+  });
+  device.walk([&](DMAOp dma) {
+    llvm::SetVector<Operation *> chain;
+    dma.walk([&](DMABDOp bd) {
+      if (auto buffer = getUnderlyingBuffer(bd.getBuffer()))
+        chain.insert(buffer);
+    });
+    addConflicts(chain);
+  });
+  return conflicts;
+}
+
+// Function that returns the bank with enough space for the given buffer in
+// which it conflicts the least with the buffers already placed. Ties are
+// broken in round-robin order from startBankIndex, so that without conflicts
+// the choice is the same as the one of setBufferAddress. If no bank has
+// enough space, returns startBankIndex.
+int selectLeastConflictingBank(BufferOp buffer, int numBanks,
+                               int startBankIndex,
+                               std::vector<int64_t> &nextAddrInBanks,
+                               std::vector<BankLimits> &bankLimits,
+                               ArrayRef<BufferOp> placedBuffers,
+                               const BufferConflicts &conflicts) {
+  std::vector<int> bankConflicts(numBanks, 0);
+  for (auto placed : placedBuffers) {
+    Operation *a = buffer, *b = placed;
+    auto it = conflicts.find(a < b ? std::make_pair(a, b)
+                                   : std::make_pair(b, a));
+    // Buffers placed by the user at an address outside of the banks have no
+    // mem_bank and cannot conflict with the ones placed in a bank.
+    std::optional<int> bank = placed.getMemBank();
+    if (it != conflicts.end() && bank && *bank < numBanks)
+      bankConflicts[*bank] += it->second;
+  }
+
+  int bestBank = startBankIndex;
+  int bestConflicts = std::numeric_limits<int>::max();
+  for (int i = 0; i < numBanks; i++) {
+    int bankIndex = (startBankIndex + i) % numBanks;
+    int64_t endAddr =
+        nextAddrInBanks[bankIndex] + buffer.getAllocationSize();
+    if (endAddr <= bankLimits[bankIndex].endAddr &&
+        bankConflicts[bankIndex] < bestConflicts) {
+      bestBank = bankIndex;
+      bestConflicts = bankConflicts[bankIndex];
+    }
+  }
+  return bestBank;
+}
+
+// Round-robin bank-aware allocation. If conflicts are given, each buffer is
+// instead placed in the bank where it conflicts the least with the buffers
+// already allocated.
+LogicalResult
+simpleBankAwareAllocation(TileOp tile,
+                          const BufferConflicts *conflicts = nullptr) {
   auto device = tile->getParentOfType<AIE::DeviceOp>();
   if (!device)
     return failure();
@@ -425,6 +546,13 @@ LogicalResult simpleBankAwareAllocation(TileOp tile) {
   SmallVector<BufferOp> allocatedBuffers;
   int bankIndex = 0;
   for (auto buffer : buffersToAlloc) {
+    if (conflicts) {
+      SmallVector<BufferOp> placedBuffers(preAllocatedBuffers);
+      placedBuffers.append(allocatedBuffers);
+      bankIndex = selectLeastConflictingBank(buffer, numBanks, bankIndex,
+                                             nextAddrInBanks, bankLimits,
+                                             placedBuffers, *conflicts);
+    }
     // If the buffer doesn't fit in any of the bank space then
     // it prints the current memory map of the banks,
     // deallocates all the buffers, and
@@ -485,6 +613,13 @@ struct AIEAssignBufferAddressesPass
         if (auto res = simpleBankAwareAllocation(tile); res.failed())
           return signalPassFailure();
       }
+    } else if (clAllocScheme == "conflict-aware") {
+      BufferConflicts conflicts = findBufferConflicts(device);
+      for (auto tile : device.getOps<TileOp>()) {
+        if (auto res = simpleBankAwareAllocation(tile, &conflicts);
+            res.failed())
+          return signalPassFailure();
+      }
     } else {
       for (auto tile : device.getOps<TileOp>()) {
         tile.emitWarning("Memory allocation scheme is either not provided or "
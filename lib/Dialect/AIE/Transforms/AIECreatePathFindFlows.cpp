@@ -920,14 +920,61 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
     signalPassFailure();
 }
 
+void AIEPathfinderPass::reportRouteLengths(DeviceOp d) {
+  auto getEndPoint = [](Value tile, Port port) {
+    auto tileOp = cast<TileOp>(tile.getDefiningOp());
+    return PathEndPoint{{tileOp.colIndex(), tileOp.rowIndex()}, port};
+  };
+  for (FlowOp flowOp : d.getOps<FlowOp>()) {
+    PathEndPoint src =
+        getEndPoint(flowOp.getSource(),
+                    {flowOp.getSourceBundle(), flowOp.sourceIndex()});
+    PathEndPoint dst = getEndPoint(
+        flowOp.getDest(), {flowOp.getDestBundle(), flowOp.destIndex()});
+    if (auto length = analyzer.getRouteLength(src, dst))
+      flowOp.emitRemark() << "routed through " << *length << " switchboxes";
+  }
+  for (PacketFlowOp pktFlowOp : d.getOps<PacketFlowOp>()) {
+    PathEndPoint src;
+    for (Operation &op : pktFlowOp.getPorts().front()) {
+      if (auto pktSource = dyn_cast<PacketSourceOp>(op)) {
+        src = getEndPoint(pktSource.getTile(), pktSource.port());
+      } else if (auto pktDest = dyn_cast<PacketDestOp>(op)) {
+        PathEndPoint dst = getEndPoint(pktDest.getTile(), pktDest.port());
+        if (auto length = analyzer.getRouteLength(src, dst))
+          pktDest.emitRemark() << "routed through " << *length
+                               << " switchboxes";
+      }
+    }
+  }
+}
+
 void AIEPathfinderPass::runOnOperation() {
 
   // create analysis pass with routing graph for entire device
   LLVM_DEBUG(llvm::dbgs() << "---Begin AIEPathfinderPass---\n");
 
   DeviceOp d = getOperation();
+  if (clRouter == "steiner") {
+    analyzer.pathfinder = std::make_shared<SteinerRouter>();
+  } else if (clRouter != "pathfinder") {
+    d.emitError("unknown router '") << clRouter << "'";
+    return signalPassFailure();
+  }
+  RouterOptions routerOptions;
+  routerOptions.incremental = clIncremental;
+  routerOptions.parallel = clParallel;
+  routerOptions.astar = clAStar;
+  routerOptions.context = &getContext();
+  analyzer.pathfinder->setOptions(routerOptions);
+  analyzer.cacheDir = clCacheDir;
   if (failed(analyzer.runAnalysis(d)))
     return signalPassFailure();
+  numRoutingCacheHits = analyzer.numCacheHits;
+  numRoutingCacheMisses = analyzer.numCacheMisses;
+
+  if (clReportRouteLength)
+    reportRouteLengths(d);
   OpBuilder builder = OpBuilder::atBlockTerminator(d.getBody());
 
   if (clRouteCircuit)
@@ -0,0 +1,335 @@
+//===- AIEObjectFifoDepthSizing.cpp -----------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Sizes the depth of each objectFifo from a dataflow model of the design.
+// Every core, link and shim or memtile DMA endpoint is an actor, and every
+// objectFifo connects its producer to each of its consumers. An objectFifo has
+// one pool of buffers per endpoint tile, or a single pool when its producer and
+// consumer share memory, or when the endpoint is the memtile of a link.
+//
+// The minimum depth of a pool lets each of its users hold the elements it
+// acquires at once while the other users work, so that neither side of the
+// objectFifo stalls in steady state: a core holds its largest acquire and a DMA
+// holds one element. The throughput depth adds to the pools of the inputs of an
+// actor the difference, in pipeline stages, between the longest path to its
+// inputs and the path to each input, so that reconvergent paths do not throttle
+// each other. Throughput depths are then reduced, largest surplus first, until
+// the pools of each tile fit in its memory.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Pass/Pass.h"
+
+#include <map>
+
+#define DEBUG_TYPE "aie-objectFifo-depth-sizing"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+// A pool of objectFifo buffers on a tile, and the depth entries of the
+// objectFifos that it implements.
+struct FifoPool {
+  TileOp tile;
+  int64_t elemBytes = 0;
+  int minDepth = 0;
+  int surplus = 0;
+  // depth is given by the user and cannot change, e.g. for init values
+  bool fixed = false;
+  SmallVector<std::pair<ObjectFifoCreateOp, int>> entries;
+
+  int depth() const { return minDepth + surplus; }
+};
+
+// An actor of the dataflow model: a core tile, a link, or the DMA of a shim
+// or memtile endpoint of an objectFifo.
+using Actor = std::pair<Operation *, int>;
+
+int64_t getElemBytes(ObjectFifoCreateOp createOp) {
+  auto memrefType = llvm::cast<MemRefType>(
+      llvm::cast<AIEObjectFifoType>(createOp.getElemType()).getElementType());
+  return memrefType.getNumElements() * memrefType.getElementTypeBitWidth() / 8;
+}
+
+std::optional<ObjectFifoLinkOp> getOptionalLinkOp(ObjectFifoCreateOp op) {
+  auto device = op->getParentOfType<DeviceOp>();
+  for (ObjectFifoLinkOp linkOp : device.getOps<ObjectFifoLinkOp>()) {
+    for (ObjectFifoCreateOp in : linkOp.getInputObjectFifos())
+      if (in == op)
+        return {linkOp};
+    for (ObjectFifoCreateOp out : linkOp.getOutputObjectFifos())
+      if (out == op)
+        return {linkOp};
+  }
+  return {};
+}
+
+// Returns true if the objectFifo uses a single pool in the memory shared by
+// its producer and consumer cores, as the stateful transform does.
+bool usesSharedMemory(ObjectFifoCreateOp createOp) {
+  if (createOp.getVia_DMA() || createOp.getRepeatCount().has_value() ||
+      createOp.getConsumerTiles().size() != 1 ||
+      !createOp.getDimensionsToStream().empty() ||
+      getOptionalLinkOp(createOp))
+    return false;
+  for (BDDimLayoutArrayAttr dims :
+       createOp.getDimensionsFromStreamPerConsumer())
+    if (!dims.empty())
+      return false;
+  TileOp producer = createOp.getProducerTileOp();
+  auto consumer = cast<TileOp>(createOp.getConsumerTiles()[0].getDefiningOp());
+  if (producer.isShimTile() || producer.isMemTile() || consumer.isShimTile() ||
+      consumer.isMemTile())
+    return false;
+  const auto &targetModel = getTargetModel(producer);
+  int pCol = producer.colIndex(), pRow = producer.rowIndex();
+  int cCol = consumer.colIndex(), cRow = consumer.rowIndex();
+  return targetModel.isLegalMemAffinity(pCol, pRow, cCol, cRow) ||
+         targetModel.isLegalMemAffinity(cCol, cRow, pCol, pRow);
+}
+
+} // namespace
+
+struct AIEObjectFifoDepthSizingPass
+    : AIEObjectFifoDepthSizingBase<AIEObjectFifoDepthSizingPass> {
+  std::vector<FifoPool> pools;
+  // (objectFifo, depth index) -> pool
+  DenseMap<std::pair<ObjectFifoCreateOp, int>, size_t> poolOfEntry;
+  // (owner, tile) -> pool, where owner is the objectFifo or its link
+  std::map<std::pair<Operation *, Operation *>, size_t> poolOfOwner;
+
+  /// Returns the largest number of elements of createOp that the core on tile
+  /// acquires at once through port, or 1 if none, as a DMA would.
+  int getAcquireWindow(DeviceOp device, TileOp tile,
+                       ObjectFifoCreateOp createOp, ObjectFifoPort port) {
+    int window = 0;
+    for (auto coreOp : device.getOps<CoreOp>())
+      if (coreOp.getTileOp() == tile)
+        coreOp.walk([&](ObjectFifoAcquireOp acqOp) {
+          if (acqOp.getObjectFifo() == createOp && acqOp.getPort() == port)
+            window = std::max(window, acqOp.acqNumber());
+        });
+    return std::max(window, 1);
+  }
+
+  /// Adds the depth entry of createOp at index to the pool of owner on tile,
+  /// creating it with the given minimum depth.
+  void addToPool(Operation *owner, TileOp tile, ObjectFifoCreateOp createOp,
+                 int index, int minDepth) {
+    auto [it, inserted] =
+        poolOfOwner.try_emplace({owner, tile.getOperation()}, pools.size());
+    if (inserted)
+      pools.push_back({tile});
+    FifoPool &pool = pools[it->second];
+    pool.elemBytes = std::max(pool.elemBytes, getElemBytes(createOp));
+    pool.minDepth = std::max(pool.minDepth, minDepth);
+    if (createOp.getInitValues().has_value()) {
+      pool.minDepth = std::max(pool.minDepth, createOp.size(index));
+      pool.fixed = true;
+    }
+    pool.entries.push_back({createOp, index});
+    poolOfEntry[{createOp, index}] = it->second;
+  }
+
+  void buildPools(DeviceOp device) {
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      TileOp producer = createOp.getProducerTileOp();
+      if (usesSharedMemory(createOp)) {
+        auto consumer =
+            cast<TileOp>(createOp.getConsumerTiles()[0].getDefiningOp());
+        int minDepth = getAcquireWindow(device, producer, createOp,
+                                        ObjectFifoPort::Produce) +
+                       getAcquireWindow(device, consumer, createOp,
+                                        ObjectFifoPort::Consume);
+        addToPool(createOp, producer, createOp, 0, minDepth);
+        addToPool(createOp, producer, createOp, 1, minDepth);
+        continue;
+      }
+
+      auto linkOp = getOptionalLinkOp(createOp);
+      SmallVector<TileOp> endpoints = {producer};
+      for (auto consumerTile : createOp.getConsumerTiles())
+        endpoints.push_back(cast<TileOp>(consumerTile.getDefiningOp()));
+      for (auto [index, tile] : llvm::enumerate(endpoints)) {
+        // the buffers of shim endpoints live in external memory
+        if (tile.isShimTile())
+          continue;
+        // a link reads and writes a single pool with one DMA channel each
+        if (tile.isMemTile() && linkOp) {
+          addToPool(*linkOp, tile, createOp, index, 2);
+          continue;
+        }
+        auto port = index == 0 ? ObjectFifoPort::Produce
+                               : ObjectFifoPort::Consume;
+        addToPool(createOp, tile, createOp, index,
+                  getAcquireWindow(device, tile, createOp, port) + 1);
+      }
+    }
+  }
+
+  /// Returns the actor behind the endpoint of createOp at index.
+  Actor getActor(ObjectFifoCreateOp createOp, TileOp tile, int index) {
+    if (auto linkOp = getOptionalLinkOp(createOp); linkOp && tile.isMemTile())
+      return {linkOp->getOperation(), -1};
+    if (tile.isShimTile() || tile.isMemTile())
+      return {createOp.getOperation(), index};
+    return {tile.getOperation(), -1};
+  }
+
+  /// Adds to the pools of the inputs of each actor the number of pipeline
+  /// stages by which they lead its longest input path.
+  void addReconvergenceSurplus(DeviceOp device) {
+    struct Edge {
+      Actor src, dst;
+      ObjectFifoCreateOp createOp;
+      int index;
+    };
+    std::vector<Edge> edges;
+    std::map<Actor, int> numInputs;
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      Actor src = getActor(createOp, createOp.getProducerTileOp(), 0);
+      numInputs.try_emplace(src, 0);
+      for (auto [i, consumerTile] :
+           llvm::enumerate(createOp.getConsumerTiles())) {
+        int index = i + 1;
+        Actor dst =
+            getActor(createOp, cast<TileOp>(consumerTile.getDefiningOp()),
+                     index);
+        edges.push_back({src, dst, createOp, index});
+        numInputs[dst]++;
+      }
+    }
+
+    // longest path from the sources, in topological order; actors on cycles
+    // never become ready and get no level
+    std::map<Actor, int> level;
+    std::map<Actor, int> pending = numInputs;
+    SmallVector<Actor> ready;
+    for (auto &[actor, n] : numInputs)
+      if (n == 0) {
+        level[actor] = 0;
+        ready.push_back(actor);
+      }
+    while (!ready.empty()) {
+      Actor actor = ready.pop_back_val();
+      for (auto &edge : edges) {
+        if (edge.src != actor)
+          continue;
+        level[edge.dst] = std::max(level[edge.dst], level[actor] + 1);
+        if (--pending[edge.dst] == 0)
+          ready.push_back(edge.dst);
+      }
+    }
+
+    for (auto &edge : edges) {
+      if (numInputs[edge.dst] < 2 || pending[edge.dst] != 0)
+        continue;
+      int skew = level[edge.dst] - 1 - level[edge.src];
+      auto it = poolOfEntry.find({edge.createOp, edge.index});
+      if (skew <= 0 || it == poolOfEntry.end())
+        continue;
+      FifoPool &pool = pools[it->second];
+      if (!pool.fixed)
+        pool.surplus = std::max(pool.surplus, skew);
+    }
+  }
+
+  /// Reduces the surplus of the pools of each tile until they fit in its
+  /// memory, next to its other buffers and its stack.
+  void fitInMemory(DeviceOp device) {
+    const auto &targetModel = device.getTargetModel();
+    DenseMap<TileOp, int64_t> available;
+    for (auto &pool : pools) {
+      if (available.count(pool.tile))
+        continue;
+      int64_t capacity = pool.tile.isMemTile()
+                             ? targetModel.getMemTileSize()
+                             : targetModel.getLocalMemorySize();
+      for (auto bufferOp : device.getOps<BufferOp>())
+        if (bufferOp.getTileOp() == pool.tile)
+          capacity -= bufferOp.getAllocationSize();
+      for (auto coreOp : device.getOps<CoreOp>())
+        if (coreOp.getTileOp() == pool.tile)
+          capacity -= coreOp.getStackSize();
+      available[pool.tile] = capacity;
+    }
+
+    for (auto &[tile, capacity] : available) {
+      SmallVector<FifoPool *> tilePools;
+      int64_t minBytes = 0, bytes = 0;
+      for (auto &pool : pools)
+        if (pool.tile == tile) {
+          tilePools.push_back(&pool);
+          minBytes += pool.minDepth * pool.elemBytes;
+          bytes += pool.depth() * pool.elemBytes;
+        }
+      if (minBytes > capacity) {
+        tile.emitWarning("minimum objectFifo depths on tile (")
+            << tile.getCol() << ", " << tile.getRow() << ") need " << minBytes
+            << " bytes but only " << capacity << " are available";
+        for (auto *pool : tilePools)
+          pool->surplus = 0;
+        continue;
+      }
+      while (bytes > capacity) {
+        FifoPool *largest = *llvm::max_element(
+            tilePools, [](const FifoPool *a, const FifoPool *b) {
+              return std::make_pair(a->surplus, a->elemBytes) <
+                     std::make_pair(b->surplus, b->elemBytes);
+            });
+        largest->surplus--;
+        bytes -= largest->elemBytes;
+      }
+    }
+  }
+
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    OpBuilder builder(device.getContext());
+    pools.clear();
+    poolOfEntry.clear();
+    poolOfOwner.clear();
+
+    buildPools(device);
+    addReconvergenceSurplus(device);
+    fitInMemory(device);
+
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      SmallVector<Attribute> minDepths, depths;
+      for (int index = 0, e = createOp.getConsumerTiles().size() + 1;
+           index < e; index++) {
+        int minDepth = createOp.size(index);
+        int depth = minDepth;
+        if (auto it = poolOfEntry.find({createOp, index});
+            it != poolOfEntry.end()) {
+          minDepth = pools[it->second].minDepth;
+          depth = pools[it->second].depth();
+        }
+        minDepths.push_back(builder.getI32IntegerAttr(minDepth));
+        depths.push_back(builder.getI32IntegerAttr(depth));
+      }
+      createOp->setAttr("min_depth", builder.getArrayAttr(minDepths));
+      createOp->setAttr("throughput_depth", builder.getArrayAttr(depths));
+      if (clRewrite)
+        createOp.setElemNumberAttr(builder.getArrayAttr(depths));
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEObjectFifoDepthSizingPass() {
+  return std::make_unique<AIEObjectFifoDepthSizingPass>();
+}
@@ -22,6 +22,7 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include <limits>
 #include <numeric>
 #include <set>
 
@@ -148,6 +149,21 @@ struct AIEObjectFifoStatefulTransformPass
       splitBecauseLink; // objfifos which have been split because they are
   // part of a Link, not because they didn't have a shared memory module
 
+  /// An objectFifo port accessed in a loop that is lowered with modulo-indexed
+  /// buffer selection, and the number of elements it releases per iteration.
+  struct ModuloIndexedFifo {
+    ObjectFifoCreateOp fifo;
+    ObjectFifoPort port;
+    int advance;
+  };
+  struct ModuloIndexedLoop {
+    int64_t tripCount;
+    std::vector<ModuloIndexedFifo> fifos;
+  };
+  DenseMap<Operation *, ModuloIndexedLoop>
+      moduloLoops; // for-loops that are not unrolled, their buffers are
+  // selected at runtime from the iteration number
+
   /// Function that returns true if two tiles in the AIE array share a memory
   /// module. share_direction is equal to:
   ///   * -1 if the shared memory module is that of the first input tile,
@@ -933,6 +949,211 @@ struct AIEObjectFifoStatefulTransformPass
     return lcm;
   }
 
+  // Rough number of bytes of program memory taken by the code generated for
+  // one operation of a core body.
+  static constexpr int64_t estimatedBytesPerOp = 16;
+
+  // Function that returns the number of operations nested in op, used as an
+  // estimate of the size of its code.
+  int64_t countOps(Operation *op) {
+    int64_t numOps = 0;
+    op->walk([&](Operation *) { numOps++; });
+    return numOps;
+  }
+
+  // Function that returns true if the body of forLoop acquires objectFifo
+  // elements directly, i.e., if unrollForLoops() would unroll it.
+  bool hasObjectFifoAcquires(scf::ForOp forLoop) {
+    return !forLoop.getBody()->getOps<ObjectFifoAcquireOp>().empty();
+  }
+
+  // Function that checks whether the objectFifo buffers of forLoop can be
+  // selected at runtime, as the iteration number times the number of elements
+  // released per iteration, modulo the depth. This requires a constant trip
+  // count and all objectFifo operations of the loop to be directly in its
+  // body, and no enclosing loop that would be unrolled.
+  std::optional<ModuloIndexedLoop> getModuloIndexedLoop(scf::ForOp forLoop) {
+    if (!hasObjectFifoAcquires(forLoop) ||
+        !forLoop.getInductionVar().getType().isIndex())
+      return std::nullopt;
+    if (!forLoop.getSingleLowerBound() || !forLoop.getSingleUpperBound() ||
+        !forLoop.getSingleStep())
+      return std::nullopt;
+    int64_t tripCount = constantTripCount(*(forLoop.getSingleLowerBound()),
+                                          *(forLoop.getSingleUpperBound()),
+                                          *(forLoop.getSingleStep()))
+                            .value_or(0);
+    if (tripCount <= 0)
+      return std::nullopt;
+    for (auto parentLoop = forLoop->getParentOfType<scf::ForOp>(); parentLoop;
+         parentLoop = parentLoop->getParentOfType<scf::ForOp>())
+      if (hasObjectFifoAcquires(parentLoop))
+        return std::nullopt;
+
+    ModuloIndexedLoop loop{tripCount, {}};
+    auto addFifo = [&](ObjectFifoCreateOp fifo, ObjectFifoPort port,
+                       int released) {
+      for (auto &f : loop.fifos)
+        if (f.fifo == fifo && f.port == port) {
+          f.advance += released;
+          return;
+        }
+      loop.fifos.push_back({fifo, port, released});
+    };
+    WalkResult res = forLoop.getBody()->walk([&](Operation *op) {
+      ObjectFifoCreateOp fifo;
+      if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op)) {
+        fifo = acqOp.getObjectFifo();
+        addFifo(fifo, acqOp.getPort(), 0);
+      } else if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op)) {
+        fifo = relOp.getObjectFifo();
+        addFifo(fifo, relOp.getPort(), relOp.relNumber());
+      } else {
+        return WalkResult::advance();
+      }
+      if (op->getParentOp() != forLoop || getOptionalLinkOp(fifo) ||
+          fifo.getRepeatCount().has_value())
+        return WalkResult::interrupt();
+      return WalkResult::advance();
+    });
+    if (res.wasInterrupted())
+      return std::nullopt;
+    return loop;
+  }
+
+  // Function that chooses, for each loop of the cores on objectFifoTiles that
+  // would be unrolled, between unrolling it and selecting its buffers with
+  // modulo indexing. Loops whose buffers are the same in every iteration never
+  // need unrolling. The others are unrolled by increasing code growth while
+  // the estimated code size of the core fits in program memory, as unrolled
+  // code avoids the runtime buffer selection.
+  void selectModuloIndexedLoops(DeviceOp &device,
+                                std::set<TileOp> objectFifoTiles) {
+    const auto &targetModel = device.getTargetModel();
+    if (!targetModel.hasProperty(AIETargetModel::UsesSemaphoreLocks))
+      return;
+    moduloLoops.clear();
+    int64_t maxNumOps =
+        targetModel.getProgramMemorySize() / estimatedBytesPerOp;
+    for (auto coreOp : device.getOps<CoreOp>()) {
+      if (objectFifoTiles.count(coreOp.getTileOp()) <= 0)
+        continue;
+      std::vector<std::tuple<int64_t, scf::ForOp, ModuloIndexedLoop>>
+          candidates;
+      coreOp.walk([&](scf::ForOp forLoop) {
+        std::optional<ModuloIndexedLoop> loop = getModuloIndexedLoop(forLoop);
+        if (!loop)
+          return;
+        std::set<int> objFifoSizes;
+        bool sameBuffers = true;
+        for (auto &f : loop->fifos) {
+          objFifoSizes.insert(f.fifo.size());
+          sameBuffers &= f.advance % f.fifo.size() == 0;
+        }
+        if (sameBuffers) {
+          moduloLoops[forLoop] = *loop;
+          return;
+        }
+        int64_t unrollFactor =
+            std::min<int64_t>(computeLCM(objFifoSizes), loop->tripCount);
+        // copies of the body added by unrolling, with the remainder loop
+        int64_t growth = (countOps(forLoop) - 1) *
+                         (unrollFactor - 1 + loop->tripCount % unrollFactor);
+        candidates.emplace_back(growth, forLoop, *loop);
+      });
+      llvm::stable_sort(candidates, [](const auto &a, const auto &b) {
+        return std::get<0>(a) < std::get<0>(b);
+      });
+      int64_t numOps = countOps(coreOp);
+      for (auto &[growth, forLoop, loop] : candidates) {
+        if (numOps + growth <= maxNumOps) {
+          numOps += growth;
+          continue;
+        }
+        moduloLoops[forLoop] = loop;
+      }
+    }
+  }
+
+  // Function that advances the indices of the next elements to acquire of the
+  // objectFifos of a modulo-indexed loop from the first to the last iteration,
+  // once its body has been walked.
+  void advanceModuloIndexedLoop(
+      const ModuloIndexedLoop &loop,
+      DenseMap<std::pair<ObjectFifoCreateOp, int>, int> &acqPerFifo,
+      DenseMap<std::pair<ObjectFifoCreateOp, int>, std::vector<int>>
+          &acquiresPerFifo) {
+    for (auto &f : loop.fifos) {
+      int size = f.fifo.size();
+      int shift = ((loop.tripCount - 1) * f.advance) % size;
+      std::pair<ObjectFifoCreateOp, int> key = {
+          f.fifo, f.port == ObjectFifoPort::Produce ? 0 : 1};
+      if (acqPerFifo.find(key) != acqPerFifo.end())
+        acqPerFifo[key] = (acqPerFifo[key] + shift) % size;
+      for (int &index : acquiresPerFifo[key])
+        index = (index + shift) % size;
+    }
+  }
+
+  // Function that generates the IR that selects, in a modulo-indexed loop,
+  // the buffer accessed by accessOp: bufferIndex is the buffer of the first
+  // iteration. iterations caches the iteration number of each loop.
+  Value createModuloIndexedAccess(OpBuilder &builder,
+                                  ObjectFifoSubviewAccessOp accessOp,
+                                  ObjectFifoAcquireOp acqOp, scf::ForOp forLoop,
+                                  int bufferIndex,
+                                  DenseMap<Operation *, Value> &iterations) {
+    ObjectFifoCreateOp createOp = acqOp.getObjectFifo();
+    ObjectFifoPort port = acqOp.getPort();
+    auto &buffers = buffersPerFifo[createOp];
+    int size = createOp.size();
+    int advance = 0;
+    for (auto &f : moduloLoops[forLoop].fifos)
+      if (f.fifo == createOp && f.port == port)
+        advance = f.advance % size;
+    if (advance == 0)
+      return buffers[bufferIndex].getBuffer();
+
+    // iteration = (iv - lb) / step, computed once at the start of the body
+    Value iteration = iterations.lookup(forLoop);
+    if (!iteration) {
+      builder.setInsertionPointToStart(forLoop.getBody());
+      Location loc = forLoop.getLoc();
+      Value distance = builder.create<arith::SubIOp>(
+          loc, forLoop.getInductionVar(), forLoop.getLowerBound());
+      iteration =
+          builder.create<arith::DivUIOp>(loc, distance, forLoop.getStep());
+      iterations[forLoop] = iteration;
+    }
+
+    // index = (iteration * advance + bufferIndex) % size
+    builder.setInsertionPointAfter(accessOp);
+    Location loc = accessOp.getLoc();
+    Value advanceVal = builder.create<arith::ConstantOp>(
+        loc, builder.getIndexAttr(advance));
+    Value firstVal = builder.create<arith::ConstantOp>(
+        loc, builder.getIndexAttr(bufferIndex));
+    Value sizeVal =
+        builder.create<arith::ConstantOp>(loc, builder.getIndexAttr(size));
+    Value offset = builder.create<arith::MulIOp>(loc, iteration, advanceVal);
+    Value sum = builder.create<arith::AddIOp>(loc, offset, firstVal);
+    Value switchIndex = builder.create<arith::RemUIOp>(loc, sum, sizeVal);
+
+    SmallVector<int64_t, 4> caseValues;
+    for (int i = 0; i < size; ++i)
+      caseValues.push_back(i);
+    auto switchOp = builder.create<scf::IndexSwitchOp>(
+        loc, TypeRange({buffers[0].getType()}), switchIndex,
+        DenseI64ArrayAttr::get(builder.getContext(), caseValues), size);
+    builder.createBlock(&switchOp.getDefaultRegion());
+    builder.create<scf::YieldOp>(loc, buffers[bufferIndex].getResult());
+    for (int i = 0; i < size; ++i) {
+      builder.createBlock(&switchOp.getCaseRegions()[i]);
+      builder.create<scf::YieldOp>(loc, buffers[i].getResult());
+    }
+    return switchOp.getResult(0);
+  }
+
   // Function that unrolls for-loops that contain objectFifo operations.
   LogicalResult unrollForLoops(DeviceOp &device, OpBuilder &builder,
                                std::set<TileOp> objectFifoTiles) {
@@ -942,11 +1163,18 @@ struct AIEObjectFifoStatefulTransformPass
         std::map<Operation *, bool> foundMap;
         std::map<Operation *, int64_t> remainderMap;
         std::map<Operation *, int64_t> tripCountMap;
+        // modulo-indexed loops are left as they are
+        coreOp.walk([&](scf::ForOp forLoop) {
+          if (moduloLoops.count(forLoop))
+            unrolledLoops.push_back(forLoop);
+        });
         WalkResult res = coreOp.walk([&](scf::ForOp forLoop) {
           // look for operations on objectFifos
           // when multiple fifos in same loop, must use the smallest
           // common multiplier as the unroll factor
           foundMap[forLoop.getOperation()] = false;
+          if (moduloLoops.count(forLoop))
+            return WalkResult::advance();
           std::set<int> objFifoSizes;
           Block *body = forLoop.getBody();
           remainderMap[forLoop.getOperation()] = 0;
@@ -1381,6 +1609,311 @@ struct AIEObjectFifoStatefulTransformPass
                                         builder.getBoolAttr(plio));
   }
 
+  /// Function that returns the depth of the buffers of op on a memtile, i.e.,
+  /// the number of BDs used by the DMA channel of op on that memtile.
+  int getMemTileDepth(ObjectFifoCreateOp op, TileOp memTile) {
+    if (auto linkOp = getOptionalLinkOp(op)) {
+      int depth = 0;
+      // consumer depth of the inputs, producer depth of the outputs
+      for (auto fifoIn : linkOp->getInputObjectFifos())
+        depth = std::max(depth, fifoIn.size(1));
+      for (auto fifoOut : linkOp->getOutputObjectFifos())
+        depth = std::max(depth, fifoOut.size());
+      return depth;
+    }
+    if (op.getProducerTileOp() == memTile)
+      return op.size();
+    for (auto [i, consumerTile] : llvm::enumerate(op.getConsumerTiles()))
+      if (consumerTile == memTile.getResult())
+        return op.size(i + 1);
+    return op.size();
+  }
+
+  /// DMA channels and BDs used on a memtile by the objectFifos that start or
+  /// end there and by existing DMA programs.
+  struct MemTileUsage {
+    int mm2s = 0;
+    int s2mm = 0;
+    int bds = 0;
+    int64_t bytes = 0;
+  };
+
+  MemTileUsage getMemTileUsage(DeviceOp &device, TileOp memTile) {
+    MemTileUsage usage;
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      int depth = getMemTileDepth(createOp, memTile);
+      auto memrefType = llvm::cast<MemRefType>(
+          llvm::cast<AIEObjectFifoType>(createOp.getElemType())
+              .getElementType());
+      int64_t elemBytes = memrefType.getNumElements() *
+                          memrefType.getElementTypeBitWidth() / 8;
+      if (createOp.getProducerTileOp() == memTile) {
+        usage.mm2s++;
+        usage.bds += depth;
+        usage.bytes += depth * elemBytes;
+      }
+      for (auto consumerTile : createOp.getConsumerTiles())
+        if (consumerTile == memTile.getResult()) {
+          usage.s2mm++;
+          usage.bds += depth;
+          usage.bytes += depth * elemBytes;
+        }
+    }
+    for (auto memOp : device.getOps<MemTileDMAOp>())
+      if (memOp.getTile() == memTile.getResult())
+        memOp.walk([&](DMAStartOp startOp) {
+          if (startOp.getChannelDir() == DMAChannelDir::MM2S)
+            usage.mm2s++;
+          else
+            usage.s2mm++;
+        });
+    for (auto bufferOp : device.getOps<BufferOp>())
+      if (bufferOp.getTileOp() == memTile)
+        usage.bytes += bufferOp.getAllocationSize();
+    return usage;
+  }
+
+  /// Function that splits the join and distribute links whose memtile does
+  /// not have enough DMA channels or BDs for them. The objectFifos that do
+  /// not fit are moved to a neighbouring memtile, which is chained to the
+  /// original one by a new objectFifo that carries their part of the data:
+  ///   in -> [o0, o1, o2] on memtile A becomes
+  ///   in -> [o0, fwd] on memtile A and fwd -> [o1, o2] on memtile B.
+  /// Neighbours may be split again, until every link fits. A link that
+  /// cannot be split is only an error once no other link of the device can
+  /// be split either, as splitting those may free what it needs.
+  LogicalResult splitMemTileLinks(DeviceOp &device, OpBuilder &builder) {
+    const auto &targetModel = device.getTargetModel();
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      std::optional<ObjectFifoLinkOp> failedLink;
+      std::string failure;
+      for (auto linkOp : device.getOps<ObjectFifoLinkOp>()) {
+        if (!linkOp.isJoin() && !linkOp.isDistribute())
+          continue;
+        if (linkOp.getRepeatCount().has_value())
+          continue;
+        TileOp memTile =
+            cast<TileOp>(linkOp.getOptionalSharedTile()->getDefiningOp());
+        int col = memTile.getCol();
+        int row = memTile.getRow();
+        bool isJoin = linkOp.isJoin();
+        DMAChannelDir dir = isJoin ? DMAChannelDir::S2MM : DMAChannelDir::MM2S;
+        int maxChannels =
+            isJoin ? targetModel.getNumDestSwitchboxConnections(
+                         col, row, WireBundle::DMA)
+                   : targetModel.getNumSourceSwitchboxConnections(
+                         col, row, WireBundle::DMA);
+        int maxBDs = targetModel.getNumBDs(col, row);
+        MemTileUsage usage = getMemTileUsage(device, memTile);
+        int channels = isJoin ? usage.s2mm : usage.mm2s;
+        if (channels <= maxChannels && usage.bds <= maxBDs)
+          continue;
+        std::string reason;
+        llvm::raw_string_ostream reasonStream(reason);
+        auto deferFailure = [&]() {
+          if (!failedLink) {
+            failedLink = linkOp;
+            failure = reasonStream.str();
+          }
+        };
+
+        // number of fifos to move, from the end of the link, so that what
+        // remains, plus the chaining fifo, fits
+        std::vector<ObjectFifoCreateOp> fifos =
+            isJoin ? linkOp.getInputObjectFifos()
+                   : linkOp.getOutputObjectFifos();
+        int numFifos = fifos.size();
+        std::vector<int> depths;
+        for (auto fifo : fifos)
+          depths.push_back(getMemTileDepth(fifo, memTile));
+        int fwdDepth = *llvm::max_element(depths);
+        int numMoved = 0;
+        int movedBDs = 0;
+        while (numMoved < numFifos &&
+               (channels - numMoved + 1 > maxChannels ||
+                usage.bds - movedBDs + fwdDepth > maxBDs)) {
+          movedBDs += depths[numFifos - 1 - numMoved];
+          numMoved++;
+        }
+        int numKept = numFifos - numMoved;
+        // moving every fifo would leave a 1:1 link to the neighbour, which
+        // only shifts the problem to it
+        if (numKept == 0) {
+          reasonStream << "does not fit on memtile (" << col << ", " << row
+                       << ") even when split";
+          deferFailure();
+          continue;
+        }
+
+        // transfer of the moved fifos within the full object
+        ObjectFifoCreateOp fullFifo = isJoin ? linkOp.getOutputObjectFifos()[0]
+                                             : linkOp.getInputObjectFifos()[0];
+        auto fullType = llvm::cast<MemRefType>(
+            llvm::cast<AIEObjectFifoType>(fullFifo.getElemType())
+                .getElementType());
+        ArrayAttr offsetsAttr =
+            isJoin ? linkOp.getSrcOffsets() : linkOp.getDstOffsets();
+        std::vector<int64_t> offsets;
+        for (auto offset : offsetsAttr)
+          offsets.push_back(*getConstantIntValue(offset));
+        // the moved fifos are forwarded as one range of the full object,
+        // which none of the kept fifos may overlap
+        auto getRange = [&](int i) {
+          auto type = llvm::cast<MemRefType>(
+              llvm::cast<AIEObjectFifoType>(fifos[i].getElemType())
+                  .getElementType());
+          return std::make_pair(offsets[i],
+                                offsets[i] + type.getNumElements());
+        };
+        int64_t movedOffset = std::numeric_limits<int64_t>::max();
+        int64_t movedEnd = 0;
+        for (int i = numKept; i < numFifos; i++) {
+          auto [begin, end] = getRange(i);
+          movedOffset = std::min(movedOffset, begin);
+          movedEnd = std::max(movedEnd, end);
+        }
+        bool overlaps = false;
+        for (int i = 0; i < numKept; i++) {
+          auto [begin, end] = getRange(i);
+          overlaps |= begin < movedEnd && movedOffset < end;
+        }
+        if (overlaps) {
+          reasonStream << "cannot forward its last " << numMoved
+                       << " objectFifos from memtile (" << col << ", " << row
+                       << "), as their offsets interleave with the others";
+          deferFailure();
+          continue;
+        }
+        auto fwdType = MemRefType::get({movedEnd - movedOffset},
+                                       fullType.getElementType());
+        int64_t fwdBytes =
+            fwdType.getNumElements() * fwdType.getElementTypeBitWidth() / 8;
+
+        // closest memtile in the same row that can take the moved fifos and
+        // forward further if needed
+        std::optional<TileOp> neighbour;
+        for (int dist = 1; dist < targetModel.columns() && !neighbour; dist++)
+          for (int c : {col + dist, col - dist}) {
+            if (c < 0 || c >= targetModel.columns() ||
+                !targetModel.isMemTile(c, row))
+              continue;
+            TileOp tile;
+            for (auto t : device.getOps<TileOp>())
+              if (t.getCol() == c && t.getRow() == row)
+                tile = t;
+            MemTileUsage other;
+            if (tile)
+              other = getMemTileUsage(device, tile);
+            int otherIn = isJoin ? other.mm2s : other.s2mm;
+            int otherOut = isJoin ? other.s2mm : other.mm2s;
+            int maxIn = isJoin ? targetModel.getNumSourceSwitchboxConnections(
+                                     c, row, WireBundle::DMA)
+                               : targetModel.getNumDestSwitchboxConnections(
+                                     c, row, WireBundle::DMA);
+            int maxOut = isJoin ? targetModel.getNumDestSwitchboxConnections(
+                                      c, row, WireBundle::DMA)
+                                : targetModel.getNumSourceSwitchboxConnections(
+                                      c, row, WireBundle::DMA);
+            int numOut = std::min(numMoved, 2);
+            int outBDs = 0;
+            for (int i = 0; i < numOut; i++)
+              outBDs += depths[numKept + i];
+            if (otherIn + 1 > maxIn || otherOut + numOut > maxOut ||
+                other.bds + fwdDepth + outBDs > targetModel.getNumBDs(c, row) ||
+                other.bytes + fwdDepth * fwdBytes >
+                    targetModel.getMemTileSize())
+              continue;
+            if (!tile) {
+              builder.setInsertionPointAfter(memTile);
+              tile = builder.create<TileOp>(memTile.getLoc(), c, row);
+            }
+            neighbour = tile;
+            break;
+          }
+        if (!neighbour) {
+          reasonStream << "needs " << numMoved << " more "
+                       << stringifyEnum(dir) << " channels than memtile ("
+                       << col << ", " << row
+                       << ") has, and no neighbouring memtile can take them";
+          deferFailure();
+          continue;
+        }
+
+        // chaining fifo between the two memtiles
+        std::string fwdName = fullFifo.name().str() + "_split_" +
+                              std::to_string(neighbour->getCol());
+        builder.setInsertionPointAfter(fullFifo);
+        auto fwdDepthAttr = builder.getI32IntegerAttr(fwdDepth);
+        BDDimLayoutArrayAttr emptyDims =
+            BDDimLayoutArrayAttr::get(builder.getContext(), {});
+        BDDimLayoutArrayArrayAttr emptyConsumerDims =
+            BDDimLayoutArrayArrayAttr::get(builder.getContext(), {emptyDims});
+        ObjectFifoCreateOp fwdFifo = createObjectFifo(
+            builder, AIEObjectFifoType::get(fwdType), fwdName,
+            isJoin ? neighbour->getResult() : memTile.getResult(),
+            isJoin ? memTile.getResult() : neighbour->getResult(), fwdDepthAttr,
+            emptyDims, emptyConsumerDims);
+        // neighbouring memtiles share memory, but the data has to be moved
+        fwdFifo.setVia_DMA(true);
+
+        // move the fifos to the neighbour and rebase their offsets
+        SmallVector<Attribute> keptSyms, movedSyms;
+        SmallVector<int64_t> keptOffsets, movedOffsets;
+        for (int i = 0; i < numFifos; i++) {
+          auto sym = FlatSymbolRefAttr::get(fifos[i].getSymNameAttr());
+          if (i < numKept) {
+            keptSyms.push_back(sym);
+            keptOffsets.push_back(offsets[i]);
+            continue;
+          }
+          movedSyms.push_back(sym);
+          movedOffsets.push_back(offsets[i] - movedOffset);
+          if (isJoin)
+            fifos[i].getConsumerTilesMutable().assign(neighbour->getResult());
+          else
+            fifos[i].getProducerTileMutable().assign(neighbour->getResult());
+        }
+        keptSyms.push_back(FlatSymbolRefAttr::get(fwdFifo.getSymNameAttr()));
+        keptOffsets.push_back(movedOffset);
+        auto fullSym = FlatSymbolRefAttr::get(fullFifo.getSymNameAttr());
+        auto fwdSym = FlatSymbolRefAttr::get(fwdFifo.getSymNameAttr());
+        auto offsetsOrEmpty = [&](ArrayRef<int64_t> values) {
+          if (values.size() < 2)
+            return builder.getI64ArrayAttr({});
+          return builder.getI64ArrayAttr(values);
+        };
+        builder.setInsertionPointAfter(linkOp);
+        if (isJoin) {
+          builder.create<ObjectFifoLinkOp>(
+              linkOp.getLoc(), builder.getArrayAttr(keptSyms),
+              builder.getArrayAttr({fullSym}), offsetsOrEmpty(keptOffsets),
+              builder.getI64ArrayAttr({}));
+          builder.create<ObjectFifoLinkOp>(
+              linkOp.getLoc(), builder.getArrayAttr(movedSyms),
+              builder.getArrayAttr({fwdSym}), offsetsOrEmpty(movedOffsets),
+              builder.getI64ArrayAttr({}));
+        } else {
+          builder.create<ObjectFifoLinkOp>(
+              linkOp.getLoc(), builder.getArrayAttr({fullSym}),
+              builder.getArrayAttr(keptSyms), builder.getI64ArrayAttr({}),
+              offsetsOrEmpty(keptOffsets));
+          builder.create<ObjectFifoLinkOp>(
+              linkOp.getLoc(), builder.getArrayAttr({fwdSym}),
+              builder.getArrayAttr(movedSyms), builder.getI64ArrayAttr({}),
+              offsetsOrEmpty(movedOffsets));
+        }
+        linkOp.erase();
+        changed = true;
+        break;
+      }
+      if (!changed && failedLink)
+        return failedLink->emitOpError() << failure;
+    }
+    return success();
+  }
+
   /// Function used to verify that an objectfifo is present in at most one
   /// ObjectFifoLinkOp.
   void verifyObjectFifoLinks(DeviceOp &device) {
@@ -1413,6 +1946,8 @@ struct AIEObjectFifoStatefulTransformPass
         objectFifoTiles; // track cores to check for loops during unrolling
 
     verifyObjectFifoLinks(device);
+    if (failed(splitMemTileLinks(device, builder)))
+      return signalPassFailure();
 
     //===------------------------------------------------------------------===//
     // Split objectFifos into a consumer end and producer end if needed
@@ -1644,6 +2179,8 @@ struct AIEObjectFifoStatefulTransformPass
       }
       if (failed(dynamicGlobalObjectFifos(device, builder, dynamicTiles)))
         signalPassFailure();
+      if (clHybridObjectFifos)
+        selectModuloIndexedLoops(device, unrollTiles);
       if (failed(unrollForLoops(device, builder, unrollTiles)))
         signalPassFailure();
     }
@@ -1711,7 +2248,16 @@ struct AIEObjectFifoStatefulTransformPass
       //===----------------------------------------------------------------===//
       // Replace objectFifo.acquire ops
       //===----------------------------------------------------------------===//
-      coreOp.walk([&](ObjectFifoAcquireOp acquireOp) {
+      coreOp.walk([&](Operation *walkOp) {
+        // the body of a modulo-indexed loop was walked for its first
+        // iteration, continue from the state after its last one
+        if (auto loop = moduloLoops.find(walkOp); loop != moduloLoops.end()) {
+          advanceModuloIndexedLoop(loop->second, acqPerFifo, acquiresPerFifo);
+          return;
+        }
+        auto acquireOp = dyn_cast<ObjectFifoAcquireOp>(walkOp);
+        if (!acquireOp)
+          return;
         ObjectFifoCreateOp op = acquireOp.getObjectFifo();
         builder.setInsertionPointAfter(acquireOp);
         auto port = acquireOp.getPort();
@@ -1824,8 +2370,18 @@ struct AIEObjectFifoStatefulTransformPass
       //===----------------------------------------------------------------===//
       // Replace subview.access ops
       //===----------------------------------------------------------------===//
+      DenseMap<Operation *, Value>
+          iterations; // iteration number of each modulo-indexed loop
       coreOp.walk([&](ObjectFifoSubviewAccessOp accessOp) {
         auto acqOp = accessOp.getSubview().getDefiningOp<ObjectFifoAcquireOp>();
+        if (auto forLoop = dyn_cast<scf::ForOp>(acqOp->getParentOp());
+            forLoop && moduloLoops.count(forLoop)) {
+          auto &buffers = buffersPerFifo[acqOp.getObjectFifo()];
+          int bufferIndex = subviews[acqOp][accessOp.getIndex()] - &buffers[0];
+          accessOp.getOutput().replaceAllUsesWith(createModuloIndexedAccess(
+              builder, accessOp, acqOp, forLoop, bufferIndex, iterations));
+          return;
+        }
         if (ObjectFifoCreateOp op = acqOp.getObjectFifo()) {
           if (auto linkOp = getOptionalLinkOp(op); linkOp.has_value()) {
             if (!linkOp->isDistribute() && !linkOp->isJoin()) {
@@ -11,10 +11,19 @@
 #include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
 #include "d_ary_heap.h"
 
+#include "mlir/IR/Threading.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_os_ostream.h"
 
 #include "llvm/ADT/MapVector.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <cstring>
+#include <queue>
 
 using namespace mlir;
 using namespace xilinx;
@@ -67,7 +76,8 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
                 : false; // Flows such as control packet flows are routed in
                          // priority, to ensure routing consistency.
         pathfinder->addFlow(srcCoords, srcPort, dstCoords, dstPort,
-                            /*isPktFlow*/ true, priorityFlow);
+                            /*isPktFlow*/ true, priorityFlow,
+                            pktFlowOp.getCriticality().value_or(0));
       }
     }
   }
@@ -91,7 +101,8 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
                << stringifyWireBundle(dstPort.bundle) << dstPort.channel
                << "\n");
     pathfinder->addFlow(srcCoords, srcPort, dstCoords, dstPort,
-                        /*isPktFlow*/ false, /*isPriorityFlow*/ false);
+                        /*isPktFlow*/ false, /*isPriorityFlow*/ false,
+                        flowOp.getCriticality().value_or(0));
   }
 
   // add existing connections so Pathfinder knows which resources are
@@ -101,13 +112,27 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
       return switchboxOp.emitOpError() << "Unable to add fixed connections";
   }
 
-  // all flows are now populated, call the congestion-aware pathfinder
-  // algorithm
-  // check whether the pathfinder algorithm creates a legal routing
-  if (auto maybeFlowSolutions = pathfinder->findPaths(maxIterations))
+  // reuse the routing of an identical routing problem, if cached
+  std::string cacheKey;
+  if (!cacheDir.empty())
+    cacheKey = getRoutingCacheKey(device);
+  if (!cacheKey.empty() && loadCachedRouting(cacheKey)) {
+    LLVM_DEBUG(llvm::dbgs() << "\tReusing cached routing\n");
+    numCacheHits++;
+  } else if (auto maybeFlowSolutions = pathfinder->findPaths(maxIterations)) {
+    // all flows are now populated, call the congestion-aware pathfinder
+    // algorithm
+    // check whether the pathfinder algorithm creates a legal routing
     flowSolutions = maybeFlowSolutions.value();
-  else
+    if (!cacheKey.empty()) {
+      numCacheMisses++;
+      if (failed(storeCachedRouting(cacheKey)))
+        device.emitWarning("Unable to write the routing cache in ")
+            << cacheDir;
+    }
+  } else {
     return device.emitError("Unable to find a legal routing");
+  }
 
   // initialize all flows as unprocessed to prep for rewrite
   for (const auto &[PathEndPoint, switchSetting] : flowSolutions) {
@@ -141,6 +166,271 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
   return success();
 }
 
+static void printPort(llvm::raw_ostream &os, const Port &port) {
+  os << " " << static_cast<uint32_t>(port.bundle) << " " << port.channel;
+}
+
+static void printEndPoint(llvm::raw_ostream &os, const PathEndPoint &point) {
+  os << " " << point.coords.col << " " << point.coords.row;
+  printPort(os, point.port);
+}
+
+std::string DynamicTileAnalysis::getRoutingCacheKey(DeviceOp &device) {
+  const AIETargetModel &targetModel = device.getTargetModel();
+  const RouterOptions &options = pathfinder->getOptions();
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << "aie-routing-cache " << ROUTING_CACHE_VERSION << "\n";
+  os << "router " << pathfinder->getName() << " " << options.astar << " "
+     << options.incremental << "\n";
+  os << "device " << stringifyAIEDevice(device.getDevice()) << " " << maxCol
+     << " " << maxRow << "\n";
+
+  // Fingerprint the parts of the target model the router is built from, so
+  // that changes to the model invalidate the cache.
+  std::string model;
+  llvm::raw_string_ostream ms(model);
+  const std::vector<WireBundle> bundles = {
+      WireBundle::Core,  WireBundle::DMA,  WireBundle::FIFO,
+      WireBundle::South, WireBundle::West, WireBundle::North,
+      WireBundle::East,  WireBundle::PLIO, WireBundle::NOC,
+      WireBundle::Trace, WireBundle::TileControl};
+  for (int col = 0; col <= maxCol; col++) {
+    for (int row = 0; row <= maxRow; row++) {
+      std::vector<Port> srcPorts, dstPorts;
+      for (WireBundle bundle : bundles) {
+        uint32_t srcs = std::max(
+            targetModel.getNumSourceSwitchboxConnections(col, row, bundle),
+            targetModel.getNumSourceShimMuxConnections(col, row, bundle));
+        uint32_t dsts = std::max(
+            targetModel.getNumDestSwitchboxConnections(col, row, bundle),
+            targetModel.getNumDestShimMuxConnections(col, row, bundle));
+        ms << srcs << " " << dsts << " ";
+        for (uint32_t channel = 0; channel < srcs; channel++)
+          srcPorts.push_back({bundle, static_cast<int>(channel)});
+        for (uint32_t channel = 0; channel < dsts; channel++)
+          dstPorts.push_back({bundle, static_cast<int>(channel)});
+      }
+      ms << targetModel.isShimNOCorPLTile(col, row);
+      for (const Port &src : srcPorts)
+        for (const Port &dst : dstPorts)
+          ms << targetModel.isLegalTileConnection(col, row, src.bundle,
+                                                  src.channel, dst.bundle,
+                                                  dst.channel);
+      ms << "\n";
+    }
+  }
+  os << "target-model "
+     << llvm::MD5::hash(llvm::arrayRefFromStringRef(model)).digest() << "\n";
+
+  std::vector<std::string> lines;
+  for (SwitchboxOp switchboxOp : device.getOps<SwitchboxOp>()) {
+    for (ConnectOp connectOp : switchboxOp.getOps<ConnectOp>()) {
+      std::string line;
+      llvm::raw_string_ostream ls(line);
+      ls << "connect " << switchboxOp.colIndex() << " "
+         << switchboxOp.rowIndex();
+      printPort(ls, connectOp.sourcePort());
+      printPort(ls, connectOp.destPort());
+      lines.push_back(std::move(line));
+    }
+  }
+  for (PacketFlowOp pktFlowOp : device.getOps<PacketFlowOp>()) {
+    bool priorityFlow = pktFlowOp.getPriorityRoute()
+                            ? *pktFlowOp.getPriorityRoute()
+                            : false;
+    PathEndPoint src;
+    for (Operation &op : pktFlowOp.getPorts().front()) {
+      if (auto pktSource = dyn_cast<PacketSourceOp>(op)) {
+        auto srcTile = cast<TileOp>(pktSource.getTile().getDefiningOp());
+        src = {{srcTile.colIndex(), srcTile.rowIndex()}, pktSource.port()};
+      } else if (auto pktDest = dyn_cast<PacketDestOp>(op)) {
+        auto dstTile = cast<TileOp>(pktDest.getTile().getDefiningOp());
+        std::string line;
+        llvm::raw_string_ostream ls(line);
+        ls << "packet " << priorityFlow << " "
+           << pktFlowOp.getCriticality().value_or(0);
+        printEndPoint(ls, src);
+        printEndPoint(ls, {{dstTile.colIndex(), dstTile.rowIndex()},
+                           pktDest.port()});
+        lines.push_back(std::move(line));
+      }
+    }
+  }
+  for (FlowOp flowOp : device.getOps<FlowOp>()) {
+    auto srcTile = cast<TileOp>(flowOp.getSource().getDefiningOp());
+    auto dstTile = cast<TileOp>(flowOp.getDest().getDefiningOp());
+    std::string line;
+    llvm::raw_string_ostream ls(line);
+    ls << "circuit " << flowOp.getCriticality().value_or(0);
+    printEndPoint(ls, {{srcTile.colIndex(), srcTile.rowIndex()},
+                       {flowOp.getSourceBundle(), flowOp.getSourceChannel()}});
+    printEndPoint(ls, {{dstTile.colIndex(), dstTile.rowIndex()},
+                       {flowOp.getDestBundle(), flowOp.getDestChannel()}});
+    lines.push_back(std::move(line));
+  }
+  llvm::sort(lines);
+  for (const auto &line : lines)
+    os << line << "\n";
+  return key;
+}
+
+// The cache entries are named after the hash of their key, and start with
+// the key itself to guard against hash collisions.
+static std::string getCacheEntryPath(llvm::StringRef cacheDir,
+                                     llvm::StringRef key) {
+  llvm::SmallString<128> path(cacheDir);
+  llvm::sys::path::append(
+      path, llvm::MD5::hash(llvm::arrayRefFromStringRef(key)).digest() +
+                ".routing");
+  return std::string(path);
+}
+
+bool DynamicTileAnalysis::loadCachedRouting(llvm::StringRef key) {
+  auto buffer = llvm::MemoryBuffer::getFile(getCacheEntryPath(cacheDir, key));
+  if (!buffer)
+    return false;
+  llvm::StringRef contents = (*buffer)->getBuffer();
+  if (!contents.consume_front(key) || !contents.consume_front("routing\n"))
+    return false;
+
+  std::map<PathEndPoint, SwitchSettings> solutions;
+  SwitchSettings *settings = nullptr;
+  while (!contents.empty()) {
+    llvm::StringRef line;
+    std::tie(line, contents) = contents.split('\n');
+    llvm::SmallVector<llvm::StringRef> fields;
+    line.split(fields, ' ', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+    if (fields.empty())
+      return false;
+    llvm::SmallVector<int> values;
+    for (llvm::StringRef field : llvm::drop_begin(fields))
+      if (field.getAsInteger(10, values.emplace_back()))
+        return false;
+    size_t pos = 0;
+    auto nextPort = [&](Port &port) {
+      if (pos + 2 > values.size())
+        return false;
+      auto bundle = symbolizeWireBundle(values[pos]);
+      if (!bundle)
+        return false;
+      port = {*bundle, values[pos + 1]};
+      pos += 2;
+      return true;
+    };
+    auto nextPorts = [&](std::vector<Port> &ports) {
+      if (pos >= values.size() || values[pos] < 0)
+        return false;
+      ports.resize(values[pos++]);
+      return llvm::all_of(ports, nextPort);
+    };
+    if (fields.front() == "flow") {
+      PathEndPoint src;
+      pos = 2;
+      if (values.size() != 4 || !nextPort(src.port))
+        return false;
+      src.coords = {values[0], values[1]};
+      settings = &solutions[src];
+    } else if (fields.front() == "tile" && settings && values.size() >= 2) {
+      SwitchSetting &setting = (*settings)[{values[0], values[1]}];
+      pos = 2;
+      if (!nextPorts(setting.srcs) || !nextPorts(setting.dsts) ||
+          pos != values.size())
+        return false;
+    } else {
+      return false;
+    }
+  }
+  flowSolutions = std::move(solutions);
+  return true;
+}
+
+LogicalResult DynamicTileAnalysis::storeCachedRouting(llvm::StringRef key) {
+  std::string path = getCacheEntryPath(cacheDir, key);
+  if (llvm::sys::fs::create_directories(cacheDir))
+    return failure();
+  // Write to a temporary file and rename it into place, so that concurrent
+  // compilations never see a partial entry.
+  int fd;
+  llvm::SmallString<128> tmpPath;
+  if (llvm::sys::fs::createUniqueFile(path + ".tmp%%%%%%", fd, tmpPath))
+    return failure();
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << key << "routing\n";
+    for (const auto &[src, settings] : flowSolutions) {
+      os << "flow";
+      printEndPoint(os, src);
+      os << "\n";
+      for (const auto &[tile, setting] : settings) {
+        os << "tile " << tile.col << " " << tile.row << " "
+           << setting.srcs.size();
+        for (const Port &port : setting.srcs)
+          printPort(os, port);
+        os << " " << setting.dsts.size();
+        for (const Port &port : setting.dsts)
+          printPort(os, port);
+        os << "\n";
+      }
+    }
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(tmpPath);
+      return failure();
+    }
+  }
+  if (llvm::sys::fs::rename(tmpPath, path)) {
+    llvm::sys::fs::remove(tmpPath);
+    return failure();
+  }
+  return success();
+}
+
+std::optional<unsigned>
+DynamicTileAnalysis::getRouteLength(const PathEndPoint &src,
+                                    const PathEndPoint &dst) const {
+  auto it = flowSolutions.find(src);
+  if (it == flowSolutions.end())
+    return std::nullopt;
+  const SwitchSettings &settings = it->second;
+  // breadth first walk of the route, following the wires between switchboxes
+  std::map<TileID, unsigned> length = {{src.coords, 1}};
+  std::queue<TileID> worklist;
+  worklist.push(src.coords);
+  while (!worklist.empty()) {
+    TileID tile = worklist.front();
+    worklist.pop();
+    auto setting = settings.find(tile);
+    if (setting == settings.end())
+      continue;
+    for (const Port &port : setting->second.dsts) {
+      if (tile == dst.coords && port == dst.port)
+        return length[tile];
+      TileID next = tile;
+      switch (port.bundle) {
+      case WireBundle::North:
+        next.row++;
+        break;
+      case WireBundle::South:
+        next.row--;
+        break;
+      case WireBundle::East:
+        next.col++;
+        break;
+      case WireBundle::West:
+        next.col--;
+        break;
+      default:
+        continue;
+      }
+      if (length.try_emplace(next, length[tile] + 1).second)
+        worklist.push(next);
+    }
+  }
+  return std::nullopt;
+}
+
 TileOp DynamicTileAnalysis::getTile(OpBuilder &builder, int col, int row) {
   if (coordToTile.count({col, row})) {
     return coordToTile[{col, row}];
@@ -186,6 +476,75 @@ ShimMuxOp DynamicTileAnalysis::getShimMux(OpBuilder &builder, int col) {
   return switchboxOp;
 }
 
+void SwitchboxConnect::resize() {
+  numChannels = srcPorts.size() * dstPorts.size();
+  size_t bitWords = llvm::divideCeil(numChannels, 64);
+  // lay the arrays out in decreasing order of element size, each on its own
+  // cache line
+  size_t blockSize = 0;
+  auto section = [&](size_t bytes) {
+    size_t offset = blockSize;
+    blockSize = llvm::alignTo(blockSize + bytes, BLOCK_ALIGNMENT);
+    return offset;
+  };
+  size_t demandOffset = section(numChannels * sizeof(double));
+  size_t packetGroupIdOffset = section(numChannels * sizeof(int32_t));
+  size_t overCapacityOffset = section(numChannels * sizeof(uint16_t));
+  size_t usedCapacityOffset = section(numChannels * sizeof(uint16_t));
+  size_t packetFlowCountOffset = section(numChannels * sizeof(uint8_t));
+  size_t connectivityOffset = section(bitWords * sizeof(uint64_t));
+  size_t priorityOffset = section(bitWords * sizeof(uint64_t));
+
+  block.reset(static_cast<char *>(
+      ::operator new(std::max<size_t>(blockSize, BLOCK_ALIGNMENT),
+                     std::align_val_t(BLOCK_ALIGNMENT))));
+  std::memset(block.get(), 0, blockSize);
+  demandData = reinterpret_cast<double *>(block.get() + demandOffset);
+  packetGroupIdData =
+      reinterpret_cast<int32_t *>(block.get() + packetGroupIdOffset);
+  overCapacityData =
+      reinterpret_cast<uint16_t *>(block.get() + overCapacityOffset);
+  usedCapacityData =
+      reinterpret_cast<uint16_t *>(block.get() + usedCapacityOffset);
+  packetFlowCountData =
+      reinterpret_cast<uint8_t *>(block.get() + packetFlowCountOffset);
+  connectivityBits =
+      reinterpret_cast<uint64_t *>(block.get() + connectivityOffset);
+  priorityBits = reinterpret_cast<uint64_t *>(block.get() + priorityOffset);
+  std::fill_n(packetGroupIdData, numChannels, -1);
+}
+
+void SwitchboxConnect::clearHistory() {
+  std::fill_n(usedCapacityData, numChannels, 0);
+  std::fill_n(overCapacityData, numChannels, 0);
+  std::fill_n(priorityBits, llvm::divideCeil(numChannels, 64), 0);
+}
+
+void SwitchboxConnect::ripUp() {
+  std::fill_n(usedCapacityData, numChannels, 0);
+  std::fill_n(packetFlowCountData, numChannels, 0);
+  std::fill_n(packetGroupIdData, numChannels, -1);
+}
+
+void SwitchboxConnect::updateDemand() {
+  for (size_t k = 0; k < numChannels; k++) {
+    double history = DEMAND_BASE + OVER_CAPACITY_COEFF * overCapacityData[k];
+    double congestion = DEMAND_BASE + USED_CAPACITY_COEFF * usedCapacityData[k];
+    demandData[k] = history * congestion;
+  }
+}
+
+void SwitchboxConnect::settlePacketFlows() {
+  for (size_t k = 0; k < numChannels; k++) {
+    // fix used capacity for packet flows
+    if (packetFlowCountData[k] > 0) {
+      packetFlowCountData[k] = 0;
+      usedCapacityData[k]++;
+    }
+    bumpDemand(k);
+  }
+}
+
 void Pathfinder::initialize(int maxCol, int maxRow,
                             const AIETargetModel &targetModel) {
 
@@ -229,9 +588,9 @@ void Pathfinder::initialize(int maxCol, int maxRow,
         auto &pOut = sb.dstPorts[j];
         if (targetModel.isLegalTileConnection(col, row, pIn.bundle, pIn.channel,
                                               pOut.bundle, pOut.channel))
-          sb.connectivity[i][j] = Connectivity::AVAILABLE;
+          sb.setConnectivity(i, j, Connectivity::AVAILABLE);
         else {
-          sb.connectivity[i][j] = Connectivity::INVALID;
+          sb.setConnectivity(i, j, Connectivity::INVALID);
           if (targetModel.isShimNOCorPLTile(col, row)) {
             // wordaround for shimMux
             auto isBundleInList = [](WireBundle bundle,
@@ -243,12 +602,13 @@ void Pathfinder::initialize(int maxCol, int maxRow,
                 WireBundle::DMA, WireBundle::NOC, WireBundle::PLIO};
             if (isBundleInList(pIn.bundle, bundles) ||
                 isBundleInList(pOut.bundle, bundles))
-              sb.connectivity[i][j] = Connectivity::AVAILABLE;
+              sb.setConnectivity(i, j, Connectivity::AVAILABLE);
           }
         }
       }
     }
-    graph[std::make_pair(coords, coords)] = sb;
+    switchboxIndex[std::make_pair(coords, coords)] = switchboxes.size();
+    switchboxes.push_back(std::move(sb));
   };
 
   auto interconnect = [&](int col, int row, int targetCol, int targetRow,
@@ -260,9 +620,12 @@ void Pathfinder::initialize(int maxCol, int maxRow,
     }
     sb.resize();
     for (size_t i = 0; i < sb.srcPorts.size(); i++) {
-      sb.connectivity[i][i] = Connectivity::AVAILABLE;
+      sb.setConnectivity(i, i, Connectivity::AVAILABLE);
     }
-    graph[std::make_pair(TileID{col, row}, TileID{targetCol, targetRow})] = sb;
+    switchboxIndex[std::make_pair(TileID{col, row},
+                                  TileID{targetCol, targetRow})] =
+        switchboxes.size();
+    switchboxes.push_back(std::move(sb));
   };
 
   for (int row = 0; row <= maxRow; row++) {
@@ -299,10 +662,12 @@ void Pathfinder::initialize(int maxCol, int maxRow,
 // Add a flow from src to dst can have an arbitrary number of dst locations
 // due to fanout.
 void Pathfinder::addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
-                         Port dstPort, bool isPacketFlow, bool isPriorityFlow) {
+                         Port dstPort, bool isPacketFlow, bool isPriorityFlow,
+                         int criticality) {
   // check if a flow with this source already exists
-  for (auto &[_, prioritized, src, dsts] : flows) {
+  for (auto &[_, prioritized, flowCriticality, src, dsts] : flows) {
     if (src.coords == srcCoords && src.port == srcPort) {
+      flowCriticality = std::max(flowCriticality, criticality);
       if (isPriorityFlow) {
         prioritized = true;
         dsts.emplace(dsts.begin(), PathEndPoint{dstCoords, dstPort});
@@ -319,7 +684,7 @@ void Pathfinder::addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
   int packetGroupId = -1;
   if (isPacketFlow) {
     bool found = false;
-    for (auto &[existingId, _, src, dsts] : flows) {
+    for (auto &[existingId, _, __, src, dsts] : flows) {
       if (src.coords == srcCoords && src.port == srcPort) {
         packetGroupId = existingId;
         found = true;
@@ -340,7 +705,8 @@ void Pathfinder::addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
   }
   // If no existing flow was found with this source, create a new flow.
   flows.push_back(
-      Flow{packetGroupId, isPriorityFlow, PathEndPoint{srcCoords, srcPort},
+      Flow{packetGroupId, isPriorityFlow, criticality,
+           PathEndPoint{srcCoords, srcPort},
            std::vector<PathEndPoint>{PathEndPoint{dstCoords, dstPort}}});
 }
 
@@ -398,15 +764,18 @@ bool Pathfinder::addFixedConnection(SwitchboxOp switchboxOp) {
   int col = switchboxOp.colIndex();
   int row = switchboxOp.rowIndex();
   TileID coords = {col, row};
-  auto &sb = graph[std::make_pair(coords, coords)];
+  auto it = switchboxIndex.find(std::make_pair(coords, coords));
+  if (it == switchboxIndex.end())
+    return switchboxOp.getOps<ConnectOp>().empty();
+  auto &sb = switchboxes[it->second];
   for (ConnectOp connectOp : switchboxOp.getOps<ConnectOp>()) {
     bool found = false;
     for (size_t i = 0; i < sb.srcPorts.size(); i++) {
       for (size_t j = 0; j < sb.dstPorts.size(); j++) {
         if (sb.srcPorts[i] == connectOp.sourcePort() &&
             sb.dstPorts[j] == connectOp.destPort() &&
-            sb.connectivity[i][j] == Connectivity::AVAILABLE) {
-          sb.connectivity[i][j] = Connectivity::INVALID;
+            sb.getConnectivity(i, j) == Connectivity::AVAILABLE) {
+          sb.setConnectivity(i, j, Connectivity::INVALID);
           found = true;
         }
       }
@@ -419,96 +788,404 @@ bool Pathfinder::addFixedConnection(SwitchboxOp switchboxOp) {
   return true;
 }
 
-static constexpr double INF = std::numeric_limits<double>::max();
+NodeId Pathfinder::getOrCreateNode(PathEndPoint endPoint) {
+  auto [it, inserted] = nodeIds.try_emplace(endPoint, nodes.size());
+  if (inserted)
+    nodes.push_back(endPoint);
+  return it->second;
+}
+
+// Compact the switchboxes into a graph with one node per PathEndPoint and the
+// channels between them stored in CSR form, so that the shortest path
+// searches only touch flat arrays.
+void Pathfinder::buildRoutingGraph() {
+  nodes.clear();
+  nodeIds.clear();
+  for (const auto &sb : switchboxes) {
+    if (sb.srcCoords != sb.dstCoords)
+      continue;
+    for (const Port &port : sb.srcPorts)
+      getOrCreateNode({sb.srcCoords, port});
+    for (const Port &port : sb.dstPorts)
+      getOrCreateNode({sb.dstCoords, port});
+  }
+  for (const auto &flow : flows) {
+    getOrCreateNode(flow.src);
+    for (const auto &dst : flow.dsts)
+      getOrCreateNode(dst);
+  }
 
-std::map<PathEndPoint, PathEndPoint>
-Pathfinder::dijkstraShortestPaths(PathEndPoint src) {
-  // Use std::map instead of DenseMap because DenseMap doesn't let you
-  // overwrite tombstones.
-  std::map<PathEndPoint, double> distance;
-  std::map<PathEndPoint, PathEndPoint> preds;
-  std::map<PathEndPoint, uint64_t> indexInHeap;
-  enum Color { WHITE, GRAY, BLACK };
-  std::map<PathEndPoint, Color> colors;
+  edgeBegin.clear();
+  edgeSource.clear();
+  edgeTarget.clear();
+  edgeSwitchbox.clear();
+  edgeSrcPort.clear();
+  edgeDstPort.clear();
+  struct Channel {
+    PathEndPoint target;
+    unsigned switchbox, i, j;
+  };
+  std::vector<Channel> channels;
+  // Neighbors may add nodes while iterating, which then get their own
+  // adjacency in a later iteration.
+  for (NodeId n = 0; n < nodes.size(); n++) {
+    PathEndPoint src = nodes[n];
+    channels.clear();
+    // connections within the same switchbox
+    auto it = switchboxIndex.find(std::make_pair(src.coords, src.coords));
+    if (it != switchboxIndex.end()) {
+      auto &sb = switchboxes[it->second];
+      for (size_t i = 0; i < sb.srcPorts.size(); i++) {
+        if (sb.srcPorts[i] != src.port)
+          continue;
+        for (size_t j = 0; j < sb.dstPorts.size(); j++) {
+          if (sb.getConnectivity(i, j) == Connectivity::AVAILABLE)
+            channels.push_back({PathEndPoint{src.coords, sb.dstPorts[j]},
+                                it->second, static_cast<unsigned>(i),
+                                static_cast<unsigned>(j)});
+        }
+      }
+    }
+    // connections to neighboring switchboxes
+    std::vector<std::pair<TileID, Port>> neighbors = {
+        {{src.coords.col, src.coords.row - 1},
+         {WireBundle::North, src.port.channel}},
+        {{src.coords.col - 1, src.coords.row},
+         {WireBundle::East, src.port.channel}},
+        {{src.coords.col, src.coords.row + 1},
+         {WireBundle::South, src.port.channel}},
+        {{src.coords.col + 1, src.coords.row},
+         {WireBundle::West, src.port.channel}}};
+    for (const auto &[neighborCoords, neighborPort] : neighbors) {
+      auto it = switchboxIndex.find(std::make_pair(src.coords, neighborCoords));
+      if (it == switchboxIndex.end() ||
+          src.port.bundle != getConnectingBundle(neighborPort.bundle))
+        continue;
+      auto &sb = switchboxes[it->second];
+      size_t j = std::distance(
+          sb.dstPorts.begin(),
+          std::find(sb.dstPorts.begin(), sb.dstPorts.end(), neighborPort));
+      if (j == sb.dstPorts.size())
+        continue;
+      size_t i = std::distance(
+          sb.srcPorts.begin(),
+          std::find(sb.srcPorts.begin(), sb.srcPorts.end(), src.port));
+      assert(i < sb.srcPorts.size());
+      channels.push_back({PathEndPoint{neighborCoords, neighborPort},
+                          it->second, static_cast<unsigned>(i),
+                          static_cast<unsigned>(j)});
+    }
+    // the order in which channels are visited determines tie breaking in the
+    // search
+    std::sort(channels.begin(), channels.end(),
+              [](const Channel &lhs, const Channel &rhs) {
+                return lhs.target < rhs.target;
+              });
+
+    edgeBegin.push_back(edgeTarget.size());
+    for (const auto &channel : channels) {
+      edgeSource.push_back(n);
+      edgeTarget.push_back(getOrCreateNode(channel.target));
+      edgeSwitchbox.push_back(channel.switchbox);
+      edgeSrcPort.push_back(channel.i);
+      edgeDstPort.push_back(channel.j);
+    }
+  }
+  edgeBegin.push_back(edgeTarget.size());
+
+  LLVM_DEBUG(llvm::dbgs() << "\t\tRouting graph: " << nodes.size()
+                          << " nodes, " << edgeTarget.size() << " edges\n");
+}
+
+void Pathfinder::dijkstraShortestPaths(NodeId src, ArrayRef<NodeId> dsts,
+                                       RoutingSearchState &state,
+                                       double channelCost) {
+  state.reset(nodes.size());
+  auto &distance = state.distance;
+  auto &colors = state.colors;
   typedef d_ary_heap_indirect<
-      /*Value=*/PathEndPoint, /*Arity=*/4,
-      /*IndexInHeapPropertyMap=*/std::map<PathEndPoint, uint64_t>,
-      /*DistanceMap=*/std::map<PathEndPoint, double> &,
+      /*Value=*/NodeId, /*Arity=*/4,
+      /*IndexInHeapPropertyMap=*/std::vector<uint64_t> &,
+      /*DistanceMap=*/std::vector<double> &,
       /*Compare=*/std::less<>>
       MutableQueue;
-  MutableQueue Q(distance, indexInHeap);
+  MutableQueue Q(distance, state.indexInHeap);
 
   distance[src] = 0.0;
   Q.push(src);
+  size_t unreachedDsts = dsts.size();
   while (!Q.empty()) {
     src = Q.top();
     Q.pop();
 
-    // get all channels src connects to
-    if (channels.count(src) == 0) {
-      auto &sb = graph[std::make_pair(src.coords, src.coords)];
-      for (size_t i = 0; i < sb.srcPorts.size(); i++) {
-        for (size_t j = 0; j < sb.dstPorts.size(); j++) {
-          if (sb.srcPorts[i] == src.port &&
-              sb.connectivity[i][j] == Connectivity::AVAILABLE) {
-            // connections within the same switchbox
-            channels[src].push_back(PathEndPoint{src.coords, sb.dstPorts[j]});
-          }
+    if (colors[src] != RoutingSearchState::BLACK) {
+      // The predecessor of a node can no longer change once it is popped, so
+      // the search can stop as soon as the last destination is reached.
+      if (llvm::is_contained(dsts, src) && --unreachedDsts == 0)
+        break;
+      state.expanded.push_back(src);
+    }
+
+    for (EdgeId e = edgeBegin[src]; e < edgeBegin[src + 1]; e++) {
+      NodeId dest = edgeTarget[e];
+      double demand =
+          switchboxes[edgeSwitchbox[e]].demand(edgeSrcPort[e], edgeDstPort[e]) +
+          channelCost;
+      bool relax = distance[src] + demand < distance[dest];
+      if (colors[dest] == RoutingSearchState::WHITE) {
+        if (relax) {
+          distance[dest] = distance[src] + demand;
+          state.predEdge[dest] = e;
+          colors[dest] = RoutingSearchState::GRAY;
         }
+        Q.push(dest);
+      } else if (colors[dest] == RoutingSearchState::GRAY && relax) {
+        distance[dest] = distance[src] + demand;
+        state.predEdge[dest] = e;
       }
-      // connections to neighboring switchboxes
-      std::vector<std::pair<TileID, Port>> neighbors = {
-          {{src.coords.col, src.coords.row - 1},
-           {WireBundle::North, src.port.channel}},
-          {{src.coords.col - 1, src.coords.row},
-           {WireBundle::East, src.port.channel}},
-          {{src.coords.col, src.coords.row + 1},
-           {WireBundle::South, src.port.channel}},
-          {{src.coords.col + 1, src.coords.row},
-           {WireBundle::West, src.port.channel}}};
-
-      for (const auto &[neighborCoords, neighborPort] : neighbors) {
-        if (graph.count(std::make_pair(src.coords, neighborCoords)) > 0 &&
-            src.port.bundle == getConnectingBundle(neighborPort.bundle)) {
-          auto &sb = graph[std::make_pair(src.coords, neighborCoords)];
-          if (std::find(sb.dstPorts.begin(), sb.dstPorts.end(), neighborPort) !=
-              sb.dstPorts.end())
-            channels[src].push_back({neighborCoords, neighborPort});
-        }
+    }
+    colors[src] = RoutingSearchState::BLACK;
+  }
+}
+
+void Pathfinder::aStarShortestPath(NodeId src, NodeId dst,
+                                   RoutingSearchState &state,
+                                   double channelCost) {
+  state.reset(nodes.size());
+  auto &distance = state.distance;
+  auto &colors = state.colors;
+  // Every channel costs at least DEMAND_BASE + channelCost. Reaching a tile
+  // d > 0 hops away takes d channels between switchboxes and a connection
+  // through each of the d - 1 switchboxes in between, so 2d - 1 channels
+  // never overestimate the remaining cost.
+  TileID goal = nodes[dst].coords;
+  auto heuristic = [&](NodeId n) {
+    const TileID &coords = nodes[n].coords;
+    int hops =
+        std::abs(coords.col - goal.col) + std::abs(coords.row - goal.row);
+    return hops > 0 ? (DEMAND_BASE + channelCost) * (2 * hops - 1) : 0.0;
+  };
+  std::vector<double> &estimate = state.estimate;
+  estimate.assign(nodes.size(), std::numeric_limits<double>::max());
+  typedef d_ary_heap_indirect<
+      /*Value=*/NodeId, /*Arity=*/4,
+      /*IndexInHeapPropertyMap=*/std::vector<uint64_t> &,
+      /*DistanceMap=*/std::vector<double> &,
+      /*Compare=*/std::less<>>
+      MutableQueue;
+  MutableQueue Q(estimate, state.indexInHeap);
+
+  distance[src] = 0.0;
+  estimate[src] = heuristic(src);
+  colors[src] = RoutingSearchState::GRAY;
+  Q.push(src);
+  while (!Q.empty()) {
+    NodeId curr = Q.top();
+    Q.pop();
+    if (curr == dst)
+      break;
+    state.expanded.push_back(curr);
+
+    for (EdgeId e = edgeBegin[curr]; e < edgeBegin[curr + 1]; e++) {
+      NodeId dest = edgeTarget[e];
+      double demand =
+          switchboxes[edgeSwitchbox[e]].demand(edgeSrcPort[e], edgeDstPort[e]) +
+          channelCost;
+      if (distance[curr] + demand >= distance[dest])
+        continue;
+      distance[dest] = distance[curr] + demand;
+      estimate[dest] = distance[dest] + heuristic(dest);
+      state.predEdge[dest] = e;
+      // The heuristic is admissible but not consistent (a channel between
+      // switchboxes may cost less than the 2 it takes off the estimate), so
+      // a closed node is reopened when a shorter path to it is found.
+      if (colors[dest] == RoutingSearchState::GRAY) {
+        Q.update(dest);
+      } else {
+        colors[dest] = RoutingSearchState::GRAY;
+        Q.push(dest);
       }
-      std::sort(channels[src].begin(), channels[src].end());
     }
+    colors[curr] = RoutingSearchState::BLACK;
+  }
+}
 
-    for (auto &dest : channels[src]) {
-      if (distance.count(dest) == 0)
-        distance[dest] = INF;
-      auto &sb = graph[std::make_pair(src.coords, dest.coords)];
-      size_t i = std::distance(
-          sb.srcPorts.begin(),
-          std::find(sb.srcPorts.begin(), sb.srcPorts.end(), src.port));
-      size_t j = std::distance(
-          sb.dstPorts.begin(),
-          std::find(sb.dstPorts.begin(), sb.dstPorts.end(), dest.port));
-      assert(i < sb.srcPorts.size());
-      assert(j < sb.dstPorts.size());
-      bool relax = distance[src] + sb.demand[i][j] < distance[dest];
-      if (colors.count(dest) == 0) {
-        // was WHITE
-        if (relax) {
-          distance[dest] = distance[src] + sb.demand[i][j];
-          preds[dest] = src;
-          colors[dest] = GRAY;
+void Pathfinder::searchRoute(const Flow &flow, RoutingSearchState &state) {
+  // A* only pays off for a single destination; packet flows and broadcasts
+  // need the full shortest path tree.
+  if (options.astar && flow.packetGroupId < 0 && flow.dsts.size() == 1 &&
+      !(flow.dsts.front() == flow.src)) {
+    aStarShortestPath(nodeIds.at(flow.src), nodeIds.at(flow.dsts.front()),
+                      state, LATENCY_COEFF * flow.criticality);
+    return;
+  }
+  SmallVector<NodeId> dsts;
+  for (const auto &dst : flow.dsts)
+    dsts.push_back(nodeIds.at(dst));
+  dijkstraShortestPaths(nodeIds.at(flow.src), dsts, state,
+                        LATENCY_COEFF * flow.criticality);
+}
+
+void SteinerRouter::searchRoute(const Flow &flow, RoutingSearchState &state) {
+  if (flow.dsts.size() < 2)
+    return Pathfinder::searchRoute(flow, state);
+
+  NodeId src = nodeIds.at(flow.src);
+  SmallVector<NodeId> unreached;
+  for (const auto &dst : flow.dsts)
+    if (!(dst == flow.src))
+      unreached.push_back(nodeIds.at(dst));
+
+  state.reset(nodes.size());
+  auto &distance = state.distance;
+  auto &colors = state.colors;
+  typedef d_ary_heap_indirect<
+      /*Value=*/NodeId, /*Arity=*/4,
+      /*IndexInHeapPropertyMap=*/std::vector<uint64_t> &,
+      /*DistanceMap=*/std::vector<double> &,
+      /*Compare=*/std::less<>>
+      MutableQueue;
+
+  // Nodes of the tree must keep their predecessor, and the branches of the
+  // tree can only start from nodes carrying the data into a switchbox: the
+  // source, and the ports entered from a neighboring switchbox. The output
+  // ports on the tree are already used by the channel that leaves them.
+  std::vector<bool> inTree(nodes.size(), false);
+  SmallVector<NodeId> branchPoints = {src};
+  inTree[src] = true;
+  while (!unreached.empty()) {
+    std::fill(distance.begin(), distance.end(),
+              std::numeric_limits<double>::max());
+    std::fill(colors.begin(), colors.end(), RoutingSearchState::WHITE);
+    MutableQueue Q(distance, state.indexInHeap);
+    for (NodeId n : branchPoints) {
+      distance[n] = 0.0;
+      colors[n] = RoutingSearchState::GRAY;
+      Q.push(n);
+    }
+
+    // multi-source Dijkstra from the tree to the nearest unreached
+    // destination
+    auto nearest = unreached.end();
+    while (!Q.empty()) {
+      NodeId curr = Q.top();
+      Q.pop();
+      nearest = llvm::find(unreached, curr);
+      if (nearest != unreached.end())
+        break;
+      state.expanded.push_back(curr);
+      for (EdgeId e = edgeBegin[curr]; e < edgeBegin[curr + 1]; e++) {
+        NodeId dest = edgeTarget[e];
+        if (inTree[dest] || colors[dest] == RoutingSearchState::BLACK)
+          continue;
+        double demand = switchboxes[edgeSwitchbox[e]]
+                            .demand(edgeSrcPort[e], edgeDstPort[e]) +
+                        LATENCY_COEFF * flow.criticality;
+        if (distance[curr] + demand >= distance[dest])
+          continue;
+        distance[dest] = distance[curr] + demand;
+        state.predEdge[dest] = e;
+        if (colors[dest] == RoutingSearchState::WHITE) {
+          colors[dest] = RoutingSearchState::GRAY;
+          Q.push(dest);
+        } else {
+          Q.update(dest);
         }
-        Q.push(dest);
-      } else if (colors[dest] == GRAY && relax) {
-        distance[dest] = distance[src] + sb.demand[i][j];
-        preds[dest] = src;
       }
+      colors[curr] = RoutingSearchState::BLACK;
+    }
+    // the remaining destinations are unreachable; traceRoute reports them
+    if (nearest == unreached.end())
+      return;
+
+    // graft the path onto the tree
+    for (NodeId n = *nearest; !inTree[n]; n = edgeSource[state.predEdge[n]]) {
+      inTree[n] = true;
+      if (nodes[edgeSource[state.predEdge[n]]].coords != nodes[n].coords)
+        branchPoints.push_back(n);
+    }
+    llvm::erase_if(unreached, [&](NodeId n) { return inTree[n]; });
+  }
+}
+
+bool Pathfinder::commitEdge(EdgeId edge, int packetGroupId, bool isPriority) {
+  auto &sb = switchboxes[edgeSwitchbox[edge]];
+  size_t i = edgeSrcPort[edge];
+  size_t j = edgeDstPort[edge];
+  sb.setPriority(i, j, isPriority);
+  if (packetGroupId >= 0 && (sb.packetGroupId(i, j) == -1 ||
+                             sb.packetGroupId(i, j) == packetGroupId)) {
+    // claim every channel sharing the source or destination port
+    for (size_t l = 0; l < sb.dstPorts.size(); l++)
+      sb.packetGroupId(i, l) = packetGroupId;
+    for (size_t k = 0; k < sb.srcPorts.size(); k++)
+      sb.packetGroupId(k, j) = packetGroupId;
+    sb.packetFlowCount(i, j)++;
+    // maximum packet stream sharing per channel
+    if (sb.packetFlowCount(i, j) >= MAX_PACKET_STREAM_CAPACITY) {
+      sb.packetFlowCount(i, j) = 0;
+      sb.usedCapacity(i, j)++;
     }
-    colors[src] = BLACK;
+  } else {
+    sb.usedCapacity(i, j)++;
   }
+  // if at capacity, bump demand to discourage using this Channel
+  // this means the order matters!
+  double demand = sb.demand(i, j);
+  sb.bumpDemand(i, j);
+  return sb.demand(i, j) != demand;
+}
 
-  return preds;
+void Pathfinder::speculateSearches(ArrayRef<Flow> groupFlows,
+                                   ArrayRef<size_t> flows) {
+  for (NodeId n : changedNodes)
+    demandChanged[n] = false;
+  changedNodes.clear();
+  mlir::parallelFor(options.context, 0, flows.size(), [&](size_t b) {
+    searchRoute(groupFlows[flows[b]], searchStates[b]);
+  });
+}
+
+bool Pathfinder::isOverCapacity(EdgeId edge) const {
+  const auto &sb = switchboxes[edgeSwitchbox[edge]];
+  return sb.usedCapacity(edgeSrcPort[edge], edgeDstPort[edge]) >
+         MAX_CIRCUIT_STREAM_CAPACITY;
+}
+
+SwitchSettings Pathfinder::traceRoute(const Flow &flow,
+                                      const RoutingSearchState &state,
+                                      std::vector<EdgeId> &route) {
+  SwitchSettings switchSettings;
+  NodeId srcId = nodeIds.at(flow.src);
+  std::vector<NodeId> visited = {srcId};
+  onRoute[srcId] = true;
+  for (auto endPoint : flow.dsts) {
+    if (endPoint == flow.src) {
+      // route to self
+      switchSettings[flow.src.coords].srcs.push_back(flow.src.port);
+      switchSettings[flow.src.coords].dsts.push_back(flow.src.port);
+    }
+    NodeId curr = nodeIds.at(endPoint);
+    // trace backwards until a vertex already processed is reached
+    while (!onRoute[curr]) {
+      EdgeId e = state.predEdge[curr];
+      assert(e != INVALID_EDGE && "destination is unreachable");
+      if (e == INVALID_EDGE)
+        break;
+      NodeId pred = edgeSource[e];
+      route.push_back(e);
+      if (nodes[pred].coords == nodes[curr].coords) {
+        switchSettings[nodes[pred].coords].srcs.push_back(nodes[pred].port);
+        switchSettings[nodes[curr].coords].dsts.push_back(nodes[curr].port);
+      }
+      onRoute[curr] = true;
+      visited.push_back(curr);
+      curr = pred;
+    }
+  }
+  for (NodeId n : visited)
+    onRoute[n] = false;
+  return switchSettings;
 }
 
 // Perform congestion-aware routing for all flows which have been added.
@@ -522,15 +1199,24 @@ Pathfinder::findPaths(const int maxIterations) {
   LLVM_DEBUG(llvm::dbgs() << "\t---Begin Pathfinder::findPaths---\n");
   std::map<PathEndPoint, SwitchSettings> routingSolution;
   // initialize all Channel histories to 0
-  for (auto &[_, sb] : graph) {
-    for (size_t i = 0; i < sb.srcPorts.size(); i++) {
-      for (size_t j = 0; j < sb.dstPorts.size(); j++) {
-        sb.usedCapacity[i][j] = 0;
-        sb.overCapacity[i][j] = 0;
-        sb.isPriority[i][j] = false;
-      }
-    }
-  }
+  for (auto &sb : switchboxes)
+    sb.clearHistory();
+
+  buildRoutingGraph();
+  onRoute.assign(nodes.size(), false);
+  demandChanged.assign(nodes.size(), false);
+  changedNodes.clear();
+  bool parallel = options.parallel && options.context;
+  searchStates.resize(
+      parallel ? std::max(1u, options.context->getNumThreads()) : 1);
+
+  // Route critical flows first, so that they get the shortest paths before
+  // the flows they compete with raise the demand. Priority flows stay first.
+  std::stable_sort(flows.begin(), flows.end(),
+                   [](const Flow &lhs, const Flow &rhs) {
+                     return std::tie(lhs.isPriorityFlow, lhs.criticality) >
+                            std::tie(rhs.isPriorityFlow, rhs.criticality);
+                   });
 
   // group flows based on packetGroupId
   llvm::MapVector<int, std::vector<Flow>> groupedFlows;
@@ -541,6 +1227,13 @@ Pathfinder::findPaths(const int maxIterations) {
     groupedFlows[f.packetGroupId].push_back(f);
   }
 
+  // The route of each flow (in the order of groupedFlows) from the last
+  // iteration it was routed in. Routes are kept in place across iterations in
+  // incremental mode unless they use an over capacity channel.
+  std::vector<std::vector<EdgeId>> routes(flows.size());
+  std::vector<SwitchSettings> routeSettings(flows.size());
+  std::vector<bool> needsReroute(flows.size(), true);
+
   int iterationCount = -1;
   int illegalEdges = 0;
 #ifndef NDEBUG
@@ -559,9 +1252,8 @@ Pathfinder::findPaths(const int maxIterations) {
     LLVM_DEBUG(llvm::dbgs() << "\t\t---Begin findPaths iteration #"
                             << iterationCount << "---\n");
     // update demand at the beginning of each iteration
-    for (auto &[_, sb] : graph) {
+    for (auto &sb : switchboxes)
       sb.updateDemand();
-    }
 
     // "rip up" all routes
     illegalEdges = 0;
@@ -569,106 +1261,79 @@ Pathfinder::findPaths(const int maxIterations) {
     totalPathLength = 0;
 #endif
     routingSolution.clear();
-    for (auto &[_, sb] : graph) {
-      for (size_t i = 0; i < sb.srcPorts.size(); i++) {
-        for (size_t j = 0; j < sb.dstPorts.size(); j++) {
-          sb.usedCapacity[i][j] = 0;
-          sb.packetFlowCount[i][j] = 0;
-          sb.packetGroupId[i][j] = -1;
-        }
-      }
-    }
+    for (auto &sb : switchboxes)
+      sb.ripUp();
 
     // for each flow, find the shortest path from source to destination
     // update used_capacity for the path between them
-
+#ifndef NDEBUG
+    int reroutedFlows = 0;
+#endif
+    size_t flowIndex = 0;
     for (const auto &[_, flows] : groupedFlows) {
-      for (const auto &[packetGroupId, isPriority, src, dsts] : flows) {
-        // Use dijkstra to find path given current demand from the start
-        // switchbox; find the shortest paths to each other switchbox. Output is
-        // in the predecessor map, which must then be processed to get
-        // individual switchbox settings
-        std::set<PathEndPoint> processed;
-        std::map<PathEndPoint, PathEndPoint> preds = dijkstraShortestPaths(src);
-
-        // trace the path of the flow backwards via predecessors
-        // increment used_capacity for the associated channels
-        SwitchSettings switchSettings;
-        processed.insert(src);
-        for (auto endPoint : dsts) {
-          if (endPoint == src) {
-            // route to self
-            switchSettings[src.coords].srcs.push_back(src.port);
-            switchSettings[src.coords].dsts.push_back(src.port);
-          }
-          auto curr = endPoint;
-          // trace backwards until a vertex already processed is reached
-          while (!processed.count(curr)) {
-            auto &sb = graph[std::make_pair(preds[curr].coords, curr.coords)];
-            size_t i =
-                std::distance(sb.srcPorts.begin(),
-                              std::find(sb.srcPorts.begin(), sb.srcPorts.end(),
-                                        preds[curr].port));
-            size_t j = std::distance(
-                sb.dstPorts.begin(),
-                std::find(sb.dstPorts.begin(), sb.dstPorts.end(), curr.port));
-            assert(i < sb.srcPorts.size());
-            assert(j < sb.dstPorts.size());
-            sb.isPriority[i][j] = isPriority;
-            if (packetGroupId >= 0 &&
-                (sb.packetGroupId[i][j] == -1 ||
-                 sb.packetGroupId[i][j] == packetGroupId)) {
-              for (size_t k = 0; k < sb.srcPorts.size(); k++) {
-                for (size_t l = 0; l < sb.dstPorts.size(); l++) {
-                  if (k == i || l == j) {
-                    sb.packetGroupId[k][l] = packetGroupId;
-                  }
-                }
+      // In parallel mode, the searches of a batch of flows are run
+      // concurrently against the same demand. The batch is then consumed in
+      // order: the result of a search is only used if none of the demands it
+      // read have been changed by the flows committed before it. Otherwise a
+      // new batch is started from that flow, so the routing is the same as
+      // the serial one.
+      SmallVector<size_t> batch;
+      size_t batchPos = 0;
+      for (size_t k = 0; k < flows.size(); k++, flowIndex++) {
+        const auto &flow = flows[k];
+        auto &route = routes[flowIndex];
+        if (needsReroute[flowIndex]) {
+          // Use dijkstra to find path given current demand from the start
+          // switchbox; find the shortest paths to each other switchbox.
+          // Output is in the predecessor edges, which must then be processed
+          // to get individual switchbox settings
+          RoutingSearchState *state = &searchStates.front();
+          if (!parallel) {
+            searchRoute(flow, *state);
+          } else {
+            if (batchPos == batch.size() ||
+                llvm::any_of(searchStates[batchPos].expanded,
+                             [&](NodeId n) { return demandChanged[n]; })) {
+              batch.clear();
+              batchPos = 0;
+              for (size_t next = k; next < flows.size() &&
+                                    batch.size() < searchStates.size();
+                   next++) {
+                if (needsReroute[flowIndex + next - k])
+                  batch.push_back(next);
               }
-              sb.packetFlowCount[i][j]++;
-              // maximum packet stream sharing per channel
-              if (sb.packetFlowCount[i][j] >= MAX_PACKET_STREAM_CAPACITY) {
-                sb.packetFlowCount[i][j] = 0;
-                sb.usedCapacity[i][j]++;
-              }
-            } else {
-              sb.usedCapacity[i][j]++;
-            }
-            // if at capacity, bump demand to discourage using this Channel
-            // this means the order matters!
-            sb.bumpDemand(i, j);
-            if (preds[curr].coords == curr.coords) {
-              switchSettings[preds[curr].coords].srcs.push_back(
-                  preds[curr].port);
-              switchSettings[curr.coords].dsts.push_back(curr.port);
+              speculateSearches(flows, batch);
             }
-            processed.insert(curr);
-            curr = preds[curr];
+            assert(batch[batchPos] == k);
+            state = &searchStates[batchPos++];
           }
+          route.clear();
+          routeSettings[flowIndex] = traceRoute(flow, *state, route);
+#ifndef NDEBUG
+          reroutedFlows++;
+#endif
         }
-        // add this flow to the proposed solution
-        routingSolution[src] = switchSettings;
-      }
-      for (auto &[_, sb] : graph) {
-        for (size_t i = 0; i < sb.srcPorts.size(); i++) {
-          for (size_t j = 0; j < sb.dstPorts.size(); j++) {
-            // fix used capacity for packet flows
-            if (sb.packetFlowCount[i][j] > 0) {
-              sb.packetFlowCount[i][j] = 0;
-              sb.usedCapacity[i][j]++;
-            }
-            sb.bumpDemand(i, j);
+        // increment used_capacity for the associated channels
+        for (EdgeId e : route) {
+          if (commitEdge(e, flow.packetGroupId, flow.isPriorityFlow) &&
+              parallel && !demandChanged[edgeSource[e]]) {
+            demandChanged[edgeSource[e]] = true;
+            changedNodes.push_back(edgeSource[e]);
           }
         }
+        // add this flow to the proposed solution
+        routingSolution[flow.src] = routeSettings[flowIndex];
       }
+      for (auto &sb : switchboxes)
+        sb.settlePacketFlows();
     }
 
-    for (auto &[_, sb] : graph) {
+    for (auto &sb : switchboxes) {
       for (size_t i = 0; i < sb.srcPorts.size(); i++) {
         for (size_t j = 0; j < sb.dstPorts.size(); j++) {
           // check that every channel does not exceed max capacity
-          if (sb.usedCapacity[i][j] > MAX_CIRCUIT_STREAM_CAPACITY) {
-            sb.overCapacity[i][j]++;
+          if (sb.usedCapacity(i, j) > MAX_CIRCUIT_STREAM_CAPACITY) {
+            sb.overCapacity(i, j)++;
             illegalEdges++;
             LLVM_DEBUG(
                 llvm::dbgs()
@@ -677,19 +1342,27 @@ Pathfinder::findPaths(const int maxIterations) {
                 << sb.srcPorts[i].channel << " -> (" << sb.dstCoords.col << ","
                 << sb.dstCoords.row << ") " << sb.dstPorts[j].bundle
                 << sb.dstPorts[j].channel << ", used_capacity = "
-                << sb.usedCapacity[i][j] << ", demand = " << sb.demand[i][j]
-                << ", over_capacity_count = " << sb.overCapacity[i][j] << "\n");
+                << sb.usedCapacity(i, j) << ", demand = " << sb.demand(i, j)
+                << ", over_capacity_count = " << sb.overCapacity(i, j) << "\n");
           }
 #ifndef NDEBUG
           // calculate total path length (across switchboxes)
           if (sb.srcCoords != sb.dstCoords) {
-            totalPathLength += sb.usedCapacity[i][j];
+            totalPathLength += sb.usedCapacity(i, j);
           }
 #endif
         }
       }
     }
 
+    // In incremental mode only the flows crossing congested channels are
+    // ripped up in the next iteration.
+    if (options.incremental) {
+      for (size_t k = 0; k < routes.size(); k++)
+        needsReroute[k] = llvm::any_of(
+            routes[k], [&](EdgeId e) { return isOverCapacity(e); });
+    }
+
 #ifndef NDEBUG
     for (const auto &[PathEndPoint, switchSetting] : routingSolution) {
       LLVM_DEBUG(llvm::dbgs()
@@ -700,10 +1373,12 @@ Pathfinder::findPaths(const int maxIterations) {
     LLVM_DEBUG(llvm::dbgs()
                << "\t\t---End findPaths iteration #" << iterationCount
                << " , illegal edges count = " << illegalEdges
-               << ", total path length = " << totalPathLength << "---\n");
+               << ", total path length = " << totalPathLength
+               << ", rerouted flows = " << reroutedFlows << "---\n");
 #endif
   } while (illegalEdges >
            0); // continue iterations until a legal routing is found
+  numIterations = iterationCount + 1;
 
   LLVM_DEBUG(llvm::dbgs() << "\t---End Pathfinder::findPaths---\n");
   return routingSolution;
@@ -68,6 +68,18 @@ inline void put(T& pa, K k, const V& val) { pa[k] = val;  }
 template <class K, class V>
 inline const V& get(const std::map<K, V>& pa, K k) { return pa.at(k); }
 
+// Property maps indexed by a dense integer key.
+template <class V, class K>
+inline const V& get(const std::vector<V>& pa, K k) { return pa[k]; }
+
+template <class PropMap> struct property_map_value {
+    typedef typename PropMap::mapped_type type;
+};
+
+template <class V> struct property_map_value<std::vector<V>> {
+    typedef V type;
+};
+
 // D-ary heap using an indirect compare operator (use identity_property_map
 // as DistanceMap to get a direct compare operator).  This heap appears to be
 // commonly used for Dijkstra's algorithm for its good practical performance
@@ -203,7 +215,7 @@ private:
     // distance map
     // typedef typename boost::property_traits< DistanceMap >::value_type
     //     distance_type;
-    typedef typename std::remove_reference<DistanceMap>::type::mapped_type distance_type;
+    typedef typename property_map_value<typename std::remove_reference<DistanceMap>::type>::type distance_type;
 
     // Get the parent of a given node in the heap
     static size_type parent(size_type index) { return (index - 1) / Arity; }
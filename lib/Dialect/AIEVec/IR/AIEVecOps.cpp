@@ -1020,16 +1020,20 @@ LogicalResult verifyPackUnpackOp(T op) {
   unsigned rtypeWidth = rtype.getIntOrFloatBitWidth();
 
   if (isa<PackOp>(op)) {
-    // The datatype of source must be i16, and datatype of result must be i8
-    if (stypeWidth != 16)
-      return op.emitError("input must be an int16 vector");
-    if (rtypeWidth != 8)
-      return op.emitError("output must be an int8 vector");
+    // The datatype of source must be i16 (i8 on AIE2P), and datatype of
+    // result must be i8 (i4 on AIE2P). The dialect is not target-aware, so
+    // i8 -> i4 also verifies for targets that have no lowering for it.
+    if (stypeWidth != 16 && stypeWidth != 8)
+      return op.emitError("input must be an int16 or int8 vector");
+    if (rtypeWidth != stypeWidth / 2)
+      return op.emitError("output must be an int")
+             << stypeWidth / 2 << " vector";
   } else {
-    if (stypeWidth != 8)
-      return op.emitError("input must be an int8 vector");
-    if (rtypeWidth != 16)
-      return op.emitError("output must be an int16 vector");
+    if (stypeWidth != 8 && stypeWidth != 4)
+      return op.emitError("input must be an int8 or int4 vector");
+    if (rtypeWidth != stypeWidth * 2)
+      return op.emitError("output must be an int")
+             << stypeWidth * 2 << " vector";
   }
 
   return success();
@@ -1083,6 +1087,39 @@ ParseResult UnpackOp::parse(OpAsmParser &parser, OperationState &result) {
   return parsePackUnpackOp(parser, result);
 }
 
+//===----------------------------------------------------------------------===//
+// PackBFPOp, UnpackBFPOp and MatMulBFPOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult PackBFPOp::verify() {
+  if (getSource().getType().getShape() != getResult().getType().getShape())
+    return emitError("source and result must have the same shape");
+  return success();
+}
+
+LogicalResult UnpackBFPOp::verify() {
+  if (getSource().getType().getShape() != getResult().getType().getShape())
+    return emitError("source and result must have the same shape");
+  return success();
+}
+
+LogicalResult MatMulBFPOp::verify() {
+  ArrayRef<int64_t> lhsShape = getLhs().getType().getShape();
+  ArrayRef<int64_t> rhsShape = getRhs().getType().getShape();
+  ArrayRef<int64_t> accShape = getAcc().getType().getShape();
+  if (lhsShape.size() != 2 || rhsShape.size() != 2)
+    return emitError("lhs and rhs must be matrices");
+  if (lhsShape[1] != rhsShape[0] || lhsShape[0] != accShape[0] ||
+      rhsShape[1] != accShape[1])
+    return emitError("operand shapes are not compatible with a matrix "
+                     "multiplication");
+  // The only shape of the bfp16 mmul of AIE2P.
+  if (lhsShape[0] != 8 || lhsShape[1] != 8 || rhsShape[1] != 8)
+    return emitError("unsupported matrix multiplication shape, expected "
+                     "8x8 by 8x8");
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // ExtElemOp
 //===----------------------------------------------------------------------===//
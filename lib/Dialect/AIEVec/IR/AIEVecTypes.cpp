@@ -39,3 +39,40 @@ void AIEVecDialect::registerTypes() {
 bool AIEVecType::classof(Type type) {
   return llvm::isa<AIEVecDialect>(type.getDialect());
 }
+
+//===----------------------------------------------------------------------===//
+// BFP16Type
+//===----------------------------------------------------------------------===//
+
+Type BFP16Type::parse(AsmParser &parser) {
+  SmallVector<int64_t> shape;
+  if (parser.parseLess() ||
+      parser.parseDimensionList(shape, /*allowDynamic=*/false,
+                                /*withTrailingX=*/false) ||
+      parser.parseGreater())
+    return {};
+  return parser.getChecked<BFP16Type>(parser.getContext(), shape);
+}
+
+void BFP16Type::print(AsmPrinter &printer) const {
+  printer << "<";
+  llvm::interleave(getShape(), printer.getStream(), "x");
+  printer << ">";
+}
+
+LogicalResult BFP16Type::verify(function_ref<InFlightDiagnostic()> emitError,
+                                ArrayRef<int64_t> shape) {
+  if (shape.empty())
+    return emitError() << "bfp16 vector must have at least one dimension";
+  if (llvm::any_of(shape, [](int64_t dim) { return dim <= 0; }))
+    return emitError() << "bfp16 vector dimensions must be positive";
+  if (shape.back() % getBlockSize())
+    return emitError() << "innermost dimension of a bfp16 vector must be a "
+                          "multiple of "
+                       << getBlockSize();
+  return success();
+}
+
+int64_t BFP16Type::getNumElements() const {
+  return ShapedType::getNumElements(getShape());
+}
@@ -269,8 +269,9 @@ struct AIEVecTransformationPass
 
   Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". "
+                     "This will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
 
   Option<std::string> targetBackend{
@@ -290,6 +291,8 @@ struct AIEVecTransformationPass
       std::string target = aieTarget;
       if (target == "aieml" || target == "aie2") {
         aieVersion = AIEArch::AIE2;
+      } else if (target == "aie2p") {
+        aieVersion = AIEArch::AIE2P;
       } else if (target != "aie") {
         op->emitError() << "unknown AIE target '" << aieTarget << "'";
         signalPassFailure();
@@ -366,8 +369,9 @@ struct AIEVecConvOpTransformationPass
 
   Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". "
+                     "This will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
 
   Option<std::string> targetBackend{
@@ -392,6 +396,8 @@ struct AIEVecConvOpTransformationPass
       std::string target = aieTarget;
       if (target == "aieml" || target == "aie2") {
         aieVersion = AIEArch::AIE2;
+      } else if (target == "aie2p") {
+        aieVersion = AIEArch::AIE2P;
       } else if (target != "aie") {
         op->emitError() << "unknown AIE target '" << aieTarget << "'";
         signalPassFailure();
@@ -0,0 +1,36 @@
+//===- AIEVecUtils.cpp - AIE vectorization utilities ----------------------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// Utilities of AIEVecUtils.h that depend on the AIE dialect.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/ADT/StringSwitch.h"
+
+using namespace mlir;
+
+namespace xilinx::aievec {
+
+const AIE::AIETargetModel *getTargetModel(Operation *op, StringRef aieTarget) {
+  if (auto device = op->getParentOfType<AIE::DeviceOp>())
+    return &AIE::getTargetModel(device);
+  std::optional<AIE::AIEDevice> device =
+      llvm::StringSwitch<std::optional<AIE::AIEDevice>>(aieTarget)
+          .Case("aie", AIE::AIEDevice::xcvc1902)
+          .Cases("aie2", "aieml", AIE::AIEDevice::npu1)
+          .Case("aie2p", AIE::AIEDevice::npu2)
+          .Default(std::nullopt);
+  if (!device)
+    return nullptr;
+  return &AIE::getTargetModel(*device);
+}
+
+} // namespace xilinx::aievec
@@ -0,0 +1,603 @@
+//===- FuseNormalizationLoops.cpp - Online softmax and layernorm ----------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file fuses the two reduction loops that compute the statistics of a
+// vectorized softmax or layernorm, a max and a sum of exponentials, or a sum
+// and a sum of squared deviations, into a single pass over the input.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/OperationSupport.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+#define DEBUG_TYPE "aievec-fuse-normalization-loops"
+
+namespace {
+
+enum class NormalizationKind { Softmax, Layernorm };
+
+// The two loops of a softmax or layernorm that compute its statistics:
+//
+//   %m = for %i iter_args(%a = %init) { yield combine(%a, x(%i)) }
+//   ... %bias computed from %m ...
+//   %s = for %i iter_args(%b = %init2) { yield %b + f(x(%i) - %bias) }
+//
+// where `combine` is a max and `f` an exponential, or `combine` is an add and
+// `f` a square.
+struct NormalizationLoops {
+  NormalizationKind kind;
+  scf::ForOp first, second;
+  // x, as computed in the first loop.
+  Value x;
+  Value bias;
+  // The extensions from the type of the exponential to that of the sum.
+  SmallVector<arith::ExtFOp> extensions;
+  // A store of the exponentials in the second loop, and their reload by the
+  // loop that normalizes the input, which recomputes them instead.
+  vector::TransferWriteOp store;
+  vector::TransferReadOp reload;
+};
+
+} // namespace
+
+// Collects the buffers that `op`, or an op nested in it, writes to. Fails if
+// some of its writes cannot be attributed to a buffer.
+static LogicalResult
+collectWrittenBuffers(Operation *op, llvm::SmallPtrSetImpl<Value> &written) {
+  WalkResult result = op->walk([&](Operation *nested) {
+    if (nested->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+      return WalkResult::advance();
+    auto effectOp = dyn_cast<MemoryEffectOpInterface>(nested);
+    if (!effectOp)
+      return WalkResult::interrupt();
+    SmallVector<MemoryEffects::EffectInstance> effects;
+    effectOp.getEffects(effects);
+    for (const MemoryEffects::EffectInstance &effect : effects) {
+      if (!isa<MemoryEffects::Write>(effect.getEffect()))
+        continue;
+      if (!effect.getValue())
+        return WalkResult::interrupt();
+      written.insert(getUnderlyingBuffer(effect.getValue()));
+    }
+    return WalkResult::advance();
+  });
+  return failure(result.wasInterrupted());
+}
+
+static bool mayWrite(Operation *op) {
+  llvm::SmallPtrSet<Value, 4> written;
+  return failed(collectWrittenBuffers(op, written)) || !written.empty();
+}
+
+static bool usesAnyOf(Operation *op,
+                      const llvm::SmallPtrSetImpl<Value> &values) {
+  return op
+      ->walk([&](Operation *nested) {
+        if (llvm::any_of(nested->getOperands(),
+                         [&](Value v) { return values.contains(v); }))
+          return WalkResult::interrupt();
+        return WalkResult::advance();
+      })
+      .wasInterrupted();
+}
+
+static bool haveSameBounds(scf::ForOp a, scf::ForOp b) {
+  return isEqualConstantIntOrValue(getAsOpFoldResult(a.getLowerBound()),
+                                   getAsOpFoldResult(b.getLowerBound())) &&
+         isEqualConstantIntOrValue(getAsOpFoldResult(a.getUpperBound()),
+                                   getAsOpFoldResult(b.getUpperBound())) &&
+         isEqualConstantIntOrValue(getAsOpFoldResult(a.getStep()),
+                                   getAsOpFoldResult(b.getStep()));
+}
+
+// Returns the next loop after `op` in its block, if only side effect free ops
+// separate them.
+static scf::ForOp getNextLoop(Operation *op) {
+  for (Operation *next = op->getNextNode(); next; next = next->getNextNode()) {
+    if (auto loop = dyn_cast<scf::ForOp>(next))
+      return loop;
+    if (!isMemoryEffectFree(next))
+      return {};
+  }
+  return {};
+}
+
+// Returns true if `a`, in an iteration of `loopA`, and `b`, in the same
+// iteration of `loopB`, are computed in the same way from the same values.
+static bool computeSameValue(Value a, scf::ForOp loopA, Value b,
+                             scf::ForOp loopB) {
+  if (a == loopA.getInductionVar() || b == loopB.getInductionVar())
+    return a == loopA.getInductionVar() && b == loopB.getInductionVar();
+  Operation *defA = a.getDefiningOp();
+  Operation *defB = b.getDefiningOp();
+  bool insideA = defA && defA->getBlock() == loopA.getBody();
+  bool insideB = defB && defB->getBlock() == loopB.getBody();
+  if (!insideA || !insideB)
+    return a == b;
+  if (cast<OpResult>(a).getResultNumber() !=
+          cast<OpResult>(b).getResultNumber() ||
+      defA->getNumRegions())
+    return false;
+  if (!isMemoryEffectFree(defA) && !isa<vector::TransferReadOp>(defA))
+    return false;
+  return OperationEquivalence::isEquivalentTo(
+      defA, defB,
+      [&](Value x, Value y) {
+        return success(computeSameValue(x, loopA, y, loopB));
+      },
+      /*markEquivalent=*/nullptr, OperationEquivalence::IgnoreLocations);
+}
+
+// Returns the value that the single accumulator of `loop` is combined with
+// by a `CombineOpTy` on every iteration.
+template <typename... CombineOpTys>
+static Value getCombinedValue(scf::ForOp loop) {
+  if (loop.getNumRegionIterArgs() != 1)
+    return {};
+  Value acc = loop.getRegionIterArgs()[0];
+  Operation *combine = loop.getYieldedValues()[0].getDefiningOp();
+  if (!combine || !isa<CombineOpTys...>(combine) ||
+      combine->getBlock() != loop.getBody())
+    return {};
+  if (combine->getOperand(0) == acc)
+    return combine->getOperand(1);
+  if (combine->getOperand(1) == acc)
+    return combine->getOperand(0);
+  return {};
+}
+
+// Matches `x - %bias`, with %bias defined outside of `loop`, and returns x.
+static Value matchBiased(Value value, scf::ForOp loop, Value &bias) {
+  auto subOp = value.getDefiningOp<arith::SubFOp>();
+  if (!subOp || subOp->getBlock() != loop.getBody() ||
+      !loop.isDefinedOutsideOfLoop(subOp.getRhs()))
+    return {};
+  bias = subOp.getRhs();
+  return subOp.getLhs();
+}
+
+// Returns the ops of the body of `loop` that `value` is computed from, in
+// program order.
+static SmallVector<Operation *> getSliceInBody(Value value, scf::ForOp loop) {
+  llvm::SmallPtrSet<Operation *, 8> slice;
+  if (Operation *def = value.getDefiningOp();
+      def && def->getBlock() == loop.getBody())
+    slice.insert(def);
+  SmallVector<Operation *> ops;
+  for (Operation &op : llvm::reverse(loop.getBody()->without_terminator())) {
+    if (!slice.contains(&op))
+      continue;
+    ops.push_back(&op);
+    for (Value operand : op.getOperands())
+      if (Operation *def = operand.getDefiningOp();
+          def && def->getBlock() == loop.getBody())
+        slice.insert(def);
+  }
+  std::reverse(ops.begin(), ops.end());
+  return ops;
+}
+
+static std::optional<NormalizationLoops> matchNormalizationLoops(
+    scf::ForOp first, scf::ForOp second) {
+  NormalizationLoops loops;
+  loops.first = first;
+  loops.second = second;
+  if (first->getBlock() != second->getBlock() ||
+      !first->isBeforeInBlock(second) || !haveSameBounds(first, second))
+    return std::nullopt;
+
+  // The first loop computes a max or a sum of x...
+  Value x = getCombinedValue<arith::MaximumFOp, arith::MaxNumFOp>(first);
+  loops.kind = NormalizationKind::Softmax;
+  if (!x) {
+    x = getCombinedValue<arith::AddFOp>(first);
+    loops.kind = NormalizationKind::Layernorm;
+  }
+  if (!x)
+    return std::nullopt;
+
+  // ... and the second one the sum of exp(x - bias), or (x - bias)^2.
+  Value term = getCombinedValue<arith::AddFOp>(second);
+  if (!term)
+    return std::nullopt;
+  Value y;
+  if (loops.kind == NormalizationKind::Softmax) {
+    while (auto extOp = term.getDefiningOp<arith::ExtFOp>()) {
+      loops.extensions.insert(loops.extensions.begin(), extOp);
+      term = extOp.getIn();
+    }
+    // The sum is rescaled to each new max, which only leaves its initial
+    // value unchanged if it is zero.
+    auto expOp = term.getDefiningOp<math::ExpOp>();
+    if (!expOp || !matchPattern(second.getInitArgs()[0], m_AnyZeroFloat()))
+      return std::nullopt;
+    y = matchBiased(expOp.getOperand(), second, loops.bias);
+  } else {
+    auto mulOp = term.getDefiningOp<arith::MulFOp>();
+    if (!mulOp || mulOp.getLhs() != mulOp.getRhs())
+      return std::nullopt;
+    y = matchBiased(mulOp.getLhs(), second, loops.bias);
+  }
+  if (!y || !computeSameValue(x, first, y, second))
+    return std::nullopt;
+  loops.x = x;
+
+  // The bias is replaced in the fused loop, so it must not be used to compute
+  // x, which it cannot be if it follows the first loop.
+  Operation *biasDef = loops.bias.getDefiningOp();
+  if (loops.bias != first.getResult(0) &&
+      (!biasDef || biasDef->getBlock() != first->getBlock() ||
+       !first->isBeforeInBlock(biasDef)))
+    return std::nullopt;
+
+  // The statistics are combined lane-wise, so they need the same types.
+  Type statType = first.getRegionIterArgs()[0].getType();
+  Type sumType = second.getRegionIterArgs()[0].getType();
+  if (loops.bias.getType() != statType ||
+      (loops.kind == NormalizationKind::Layernorm && sumType != statType))
+    return std::nullopt;
+  // A layernorm computes its pivot as x in the first iteration, which must
+  // exist and not depend on the accumulator.
+  if (loops.kind == NormalizationKind::Layernorm) {
+    if (constantTripCount(getAsOpFoldResult(second.getLowerBound()),
+                          getAsOpFoldResult(second.getUpperBound()),
+                          getAsOpFoldResult(second.getStep()))
+            .value_or(0) < 1)
+      return std::nullopt;
+    Value acc = first.getRegionIterArgs()[0];
+    if (x == acc || llvm::any_of(getSliceInBody(x, first), [&](Operation *op) {
+          return llvm::is_contained(op->getOperands(), acc);
+        }))
+      return std::nullopt;
+  }
+
+  // The first loop moves down to the second one, past side effect free ops
+  // only, and must not write to memory itself.
+  if (mayWrite(first))
+    return std::nullopt;
+
+  // The second loop may only store the exponentials, if they are reloaded by
+  // the next loop, which then recomputes them.
+  for (Operation &op : second.getBody()->without_terminator()) {
+    if (!mayWrite(&op))
+      continue;
+    auto storeOp = dyn_cast<vector::TransferWriteOp>(op);
+    if (loops.store || !storeOp || loops.kind != NormalizationKind::Softmax)
+      return std::nullopt;
+    loops.store = storeOp;
+  }
+  return loops;
+}
+
+// Collects the ops of `loop` that `value` is computed from, in one iteration
+// and without its loop-carried values. Returns false if any of them could not
+// be recomputed later, with `written` buffers modified.
+static bool collectRecomputedSlice(Value value, scf::ForOp loop,
+                                   const llvm::SmallPtrSetImpl<Value> &written,
+                                   llvm::SetVector<Operation *> &slice) {
+  if (auto arg = dyn_cast<BlockArgument>(value))
+    return arg.getOwner() != loop.getBody() || arg == loop.getInductionVar();
+  Operation *def = value.getDefiningOp();
+  if (def->getBlock() != loop.getBody() || slice.contains(def))
+    return true;
+  if (auto readOp = dyn_cast<vector::TransferReadOp>(def)) {
+    if (written.contains(getUnderlyingBuffer(readOp.getSource())))
+      return false;
+  } else if (def->getNumRegions() || !isMemoryEffectFree(def)) {
+    return false;
+  }
+  for (Value operand : def->getOperands())
+    if (!collectRecomputedSlice(operand, loop, written, slice))
+      return false;
+  slice.insert(def);
+  return true;
+}
+
+static bool isInBounds(VectorTransferOpInterface op) {
+  if (op.getMask())
+    return false;
+  for (unsigned dim = 0, e = op.getTransferRank(); dim < e; ++dim)
+    if (!op.isDimInBounds(dim))
+      return false;
+  return true;
+}
+
+// Finds the reload of the exponentials stored by the second loop, in the loop
+// that follows it. The store can be dropped if that loop overwrites them as
+// it reads them, or if nothing else reads the buffer.
+static LogicalResult
+matchReload(NormalizationLoops &loops,
+            llvm::SetVector<Operation *> &recomputedSlice) {
+  vector::TransferWriteOp store = loops.store;
+  scf::ForOp next = getNextLoop(loops.second);
+  if (!next || !haveSameBounds(loops.second, next) || !isInBounds(store))
+    return failure();
+
+  Value buffer = store.getSource();
+  vector::TransferReadOp reload;
+  vector::TransferWriteOp overwrite;
+  bool otherUses = false;
+  next.getBody()->walk([&](Operation *op) {
+    if (llvm::none_of(op->getOperands(), [&](Value operand) {
+          return isa<MemRefType>(operand.getType()) &&
+                 getUnderlyingBuffer(operand) == getUnderlyingBuffer(buffer);
+        }))
+      return;
+    auto readOp = dyn_cast<vector::TransferReadOp>(op);
+    auto writeOp = dyn_cast<vector::TransferWriteOp>(op);
+    if (readOp && !reload && readOp.getSource() == buffer &&
+        readOp->getBlock() == next.getBody())
+      reload = readOp;
+    else if (writeOp && !overwrite && writeOp.getSource() == buffer &&
+             writeOp->getBlock() == next.getBody())
+      overwrite = writeOp;
+    else
+      otherUses = true;
+  });
+  if (otherUses || !reload || !isInBounds(reload) ||
+      reload.getVectorType() != store.getVectorType() ||
+      reload.getPermutationMap() != store.getPermutationMap())
+    return failure();
+  for (auto [storeIdx, reloadIdx] :
+       llvm::zip_equal(store.getIndices(), reload.getIndices()))
+    if (!computeSameValue(storeIdx, loops.second, reloadIdx, next))
+      return failure();
+
+  if (overwrite) {
+    if (!reload->isBeforeInBlock(overwrite) ||
+        overwrite.getVectorType() != reload.getVectorType() ||
+        overwrite.getPermutationMap() != reload.getPermutationMap())
+      return failure();
+    for (auto [reloadIdx, overwriteIdx] :
+         llvm::zip_equal(reload.getIndices(), overwrite.getIndices()))
+      if (!computeSameValue(reloadIdx, next, overwriteIdx, next))
+        return failure();
+  } else {
+    // Otherwise the buffer must be a scratch one that only holds the
+    // exponentials.
+    if (!buffer.getDefiningOp<memref::AllocOp>() &&
+        !buffer.getDefiningOp<memref::AllocaOp>())
+      return failure();
+    for (Operation *user : buffer.getUsers())
+      if (user != store && user != reload && !isa<memref::DeallocOp>(user))
+        return failure();
+  }
+
+  llvm::SmallPtrSet<Value, 4> written;
+  if (failed(collectWrittenBuffers(next, written)) ||
+      !collectRecomputedSlice(store.getVector(), loops.second, written,
+                              recomputedSlice))
+    return failure();
+  loops.reload = reload;
+  return success();
+}
+
+static Value createFloatConstant(OpBuilder &builder, Location loc, Type type,
+                                 double value) {
+  Type elementType = getElementTypeOrSelf(type);
+  TypedAttr attr = builder.getFloatAttr(elementType, value);
+  if (auto vectorType = dyn_cast<VectorType>(type))
+    attr = DenseElementsAttr::get(vectorType, attr);
+  return builder.create<arith::ConstantOp>(loc, type, attr);
+}
+
+// Replaces the lanes of a running max that are still -inf, i.e. `lowest`,
+// by 0. Subtracting a -inf max from itself, or from a -inf input, would
+// otherwise yield NaN, where the unfused loops would have added exp(-inf) = 0.
+static Value createFiniteMax(OpBuilder &builder, Location loc, Value max,
+                             Value lowest, Value zero) {
+  Value isLowest = builder.create<arith::CmpFOp>(
+      loc, arith::CmpFPredicate::OEQ, max, lowest);
+  return builder.create<arith::SelectOp>(loc, isLowest, zero, max);
+}
+
+// exp(from - to), extended like the terms of the sum of exponentials.
+static Value createRescale(OpBuilder &builder, Location loc,
+                           const NormalizationLoops &loops, Value from,
+                           Value to) {
+  Value diff = builder.create<arith::SubFOp>(loc, from, to);
+  Value rescale = builder.create<math::ExpOp>(loc, diff);
+  for (arith::ExtFOp extOp : loops.extensions)
+    rescale = builder.create<arith::ExtFOp>(loc, extOp.getType(), rescale);
+  return rescale;
+}
+
+static void fuseNormalizationLoops(RewriterBase &rewriter,
+                                   NormalizationLoops &loops,
+                                   const llvm::SetVector<Operation *> &slice) {
+  scf::ForOp first = loops.first, second = loops.second;
+  Value firstInit = first.getInitArgs()[0];
+  Location loc = second.getLoc();
+
+  // Recompute the stored exponentials where they are reloaded.
+  if (loops.store) {
+    scf::ForOp next = loops.reload->getParentOfType<scf::ForOp>();
+    IRMapping map;
+    map.map(second.getInductionVar(), next.getInductionVar());
+    rewriter.setInsertionPoint(loops.reload);
+    for (Operation *op : slice)
+      rewriter.clone(*op, map);
+    rewriter.replaceOp(loops.reload,
+                       map.lookupOrDefault(loops.store.getVector()));
+    rewriter.eraseOp(loops.store);
+  }
+
+  // A layernorm sums x - pivot and its squares, from which it computes the
+  // sum of squared deviations afterwards. The pivot is x in the first
+  // iteration, which is close enough to the mean that the squares do not
+  // cancel out, as those of x would for inputs with a large mean. A softmax
+  // compares its running max with -inf.
+  rewriter.setInsertionPoint(second);
+  Type statType = loops.bias.getType();
+  Value zero = createFloatConstant(rewriter, loc, statType, 0.0);
+  Value lowest, pivot;
+  SmallVector<Value> inits = {firstInit, second.getInitArgs()[0]};
+  if (loops.kind == NormalizationKind::Softmax) {
+    lowest = createFloatConstant(rewriter, loc, statType,
+                                 -std::numeric_limits<double>::infinity());
+  } else {
+    IRMapping map;
+    map.map(first.getInductionVar(), second.getLowerBound());
+    for (Operation *op : getSliceInBody(loops.x, first))
+      rewriter.clone(*op, map);
+    pivot = map.lookupOrDefault(loops.x);
+    inits.push_back(zero);
+  }
+
+  auto fused = rewriter.create<scf::ForOp>(
+      loc, second.getLowerBound(), second.getUpperBound(), second.getStep(),
+      inits, [&](OpBuilder &b, Location bodyLoc, Value iv, ValueRange accs) {
+        IRMapping map;
+        map.map(first.getInductionVar(), iv);
+        map.map(first.getRegionIterArgs()[0], accs[0]);
+        for (Operation &op : first.getBody()->without_terminator())
+          b.clone(op, map);
+        Value stat = map.lookup(first.getYieldedValues()[0]);
+
+        map.map(second.getInductionVar(), iv);
+        if (loops.kind == NormalizationKind::Softmax) {
+          // Rescale the sum of exponentials to the new running max.
+          Value max = createFiniteMax(b, bodyLoc, stat, lowest, zero);
+          Value rescale = createRescale(b, bodyLoc, loops, accs[0], max);
+          map.map(second.getRegionIterArgs()[0],
+                  b.create<arith::MulFOp>(bodyLoc, accs[1], rescale));
+          map.map(loops.bias, max);
+        } else {
+          map.map(second.getRegionIterArgs()[0], accs[1]);
+          map.map(loops.bias, pivot);
+        }
+        for (Operation &op : second.getBody()->without_terminator())
+          b.clone(op, map);
+        SmallVector<Value> yielded = {
+            stat, map.lookup(second.getYieldedValues()[0])};
+        if (loops.kind == NormalizationKind::Layernorm) {
+          Value shifted =
+              b.create<arith::SubFOp>(bodyLoc, map.lookup(loops.x), pivot);
+          yielded.push_back(
+              b.create<arith::AddFOp>(bodyLoc, accs[2], shifted));
+        }
+        b.create<scf::YieldOp>(bodyLoc, yielded);
+      });
+
+  // The ops in between that depend on the first loop now follow the fused
+  // one.
+  Value bias = loops.bias;
+  if (bias == first.getResult(0))
+    bias = fused.getResult(0);
+  llvm::SmallPtrSet<Value, 8> dependent = {first.getResult(0)};
+  Operation *insertAfter = fused;
+  for (Operation *op = first->getNextNode(); op != fused;) {
+    Operation *nextOp = op->getNextNode();
+    if (usesAnyOf(op, dependent)) {
+      dependent.insert(op->getResults().begin(), op->getResults().end());
+      rewriter.moveOpAfter(op, insertAfter);
+      insertAfter = op;
+    }
+    op = nextOp;
+  }
+  rewriter.replaceAllUsesWith(first.getResult(0), fused.getResult(0));
+
+  rewriter.setInsertionPointAfter(insertAfter);
+  Value stat = fused.getResult(0), sum = fused.getResult(1), result;
+  if (loops.kind == NormalizationKind::Softmax) {
+    // sum(exp(x - stat)) * exp(stat - bias) = sum(exp(x - bias)), where the
+    // rescale is 1 if the bias is the max itself.
+    result = sum;
+    if (bias != stat)
+      result = rewriter.create<arith::MulFOp>(
+          loc, sum,
+          createRescale(rewriter, loc, loops,
+                        createFiniteMax(rewriter, loc, stat, lowest, zero),
+                        bias));
+  } else {
+    // With d = bias - pivot, sum((x - bias)^2) =
+    //   sum((x - pivot)^2) - 2 * d * sum(x - pivot) + n * d^2
+    Type type = bias.getType();
+    int64_t tripCount = *constantTripCount(
+        getAsOpFoldResult(second.getLowerBound()),
+        getAsOpFoldResult(second.getUpperBound()),
+        getAsOpFoldResult(second.getStep()));
+    Value two = createFloatConstant(rewriter, loc, type, 2.0);
+    Value count = createFloatConstant(rewriter, loc, type, tripCount);
+    Value shift = rewriter.create<arith::SubFOp>(loc, bias, pivot);
+    Value cross = rewriter.create<arith::MulFOp>(
+        loc, two,
+        rewriter.create<arith::MulFOp>(loc, shift, fused.getResult(2)));
+    Value square = rewriter.create<arith::MulFOp>(
+        loc, count, rewriter.create<arith::MulFOp>(loc, shift, shift));
+    result = rewriter.create<arith::AddFOp>(
+        loc, rewriter.create<arith::SubFOp>(loc, sum, cross), square);
+  }
+  rewriter.replaceOp(second, result);
+  rewriter.eraseOp(first);
+}
+
+// Returns true if `loops.second` uses, other than through the bias, a value
+// computed from the result of `loops.first`.
+static bool usesFirstResult(const NormalizationLoops &loops) {
+  llvm::SmallPtrSet<Value, 8> dependent = {loops.first.getResult(0)};
+  for (Operation *op = loops.first->getNextNode(); op != loops.second;
+       op = op->getNextNode())
+    if (usesAnyOf(op, dependent))
+      dependent.insert(op->getResults().begin(), op->getResults().end());
+  dependent.erase(loops.bias);
+  return usesAnyOf(loops.second, dependent);
+}
+
+struct AIEVecFuseNormalizationLoops
+    : AIEVecFuseNormalizationLoopsBase<AIEVecFuseNormalizationLoops> {
+  void runOnOperation() override {
+    IRRewriter rewriter(&getContext());
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      getOperation()->walk([&](scf::ForOp first) {
+        scf::ForOp second = getNextLoop(first);
+        if (!second)
+          return WalkResult::advance();
+        std::optional<NormalizationLoops> loops =
+            matchNormalizationLoops(first, second);
+        llvm::SetVector<Operation *> slice;
+        if (!loops || usesFirstResult(*loops) ||
+            (loops->store && failed(matchReload(*loops, slice))))
+          return WalkResult::advance();
+        LLVM_DEBUG(llvm::dbgs() << "Fusing " << first << "\nand " << second
+                                << "\n");
+        fuseNormalizationLoops(rewriter, *loops, slice);
+        changed = true;
+        return WalkResult::interrupt();
+      });
+    }
+  }
+};
+
+std::unique_ptr<Pass> aievec::createAIEVecFuseNormalizationLoopsPass() {
+  return std::make_unique<AIEVecFuseNormalizationLoops>();
+}
@@ -0,0 +1,457 @@
+//===- MatMulRegisterBlocking.cpp - Register-block matmul loop nests ------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file unrolls the parallel loops around a vector.contract matmul into
+// micro-kernels that keep several accumulators in registers across the
+// reduction loop, and reuse each loaded lhs and rhs tile for several of them.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/Debug.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+#define DEBUG_TYPE "aievec-matmul-register-blocking"
+
+namespace {
+
+// The ops inside a loop nest that a value is computed from, and the values
+// from which they compute it: block arguments, such as induction variables,
+// and values defined outside of the nest.
+struct Slice {
+  llvm::SmallPtrSet<Operation *, 16> ops;
+  llvm::DenseSet<Value> leaves;
+
+  Slice(ValueRange values, Operation *root) {
+    for (Value value : values)
+      collect(value, root);
+  }
+
+  bool dependsOn(Value value) const { return leaves.contains(value); }
+
+  // Returns true if the slice can be cloned elsewhere in the nest. Loads are
+  // only allowed if `allowReads`, and must not read from the buffer that
+  // `written` is a view of, nor from an argument that may alias it.
+  bool isClonable(bool allowReads, Value written) const {
+    Value writtenBuffer = getUnderlyingBuffer(written);
+    return llvm::all_of(ops, [&](Operation *op) {
+      if (op->getNumRegions())
+        return false;
+      if (auto readOp = dyn_cast<vector::TransferReadOp>(op)) {
+        Value buffer = getUnderlyingBuffer(readOp.getSource());
+        return allowReads && buffer != writtenBuffer &&
+               !(isAliasingArgument(buffer) &&
+                 isAliasingArgument(writtenBuffer));
+      }
+      return isMemoryEffectFree(op);
+    });
+  }
+
+private:
+  void collect(Value value, Operation *root) {
+    Operation *def = value.getDefiningOp();
+    if (!def || !root->isProperAncestor(def)) {
+      leaves.insert(value);
+      return;
+    }
+    if (!ops.insert(def).second)
+      return;
+    for (Value operand : def->getOperands())
+      collect(operand, root);
+  }
+};
+
+// A vector.contract in the innermost of three perfectly nested loops, which
+// reads its accumulator from memory and writes it back on every iteration.
+template <typename ForOpTy>
+struct ContractNest {
+  // The parallel loops that the lhs and rhs tiles are indexed by.
+  ForOpTy mLoop, nLoop;
+  ForOpTy kLoop;
+  vector::ContractionOp contract;
+  vector::TransferReadOp accRead;
+  vector::TransferWriteOp accWrite;
+  int64_t mTrips, nTrips;
+};
+
+} // namespace
+
+static std::optional<int64_t> getConstantTripCount(LoopLikeOpInterface loop) {
+  std::optional<OpFoldResult> lb = loop.getSingleLowerBound();
+  std::optional<OpFoldResult> ub = loop.getSingleUpperBound();
+  std::optional<OpFoldResult> step = loop.getSingleStep();
+  if (!lb || !ub || !step)
+    return std::nullopt;
+  return constantTripCount(*lb, *ub, *step);
+}
+
+// Returns true if every op in the body of `loop`, other than `nested` and the
+// terminator, can be recomputed freely.
+static bool isPerfectlyNested(Operation *loop, Operation *nested) {
+  return llvm::all_of(loop->getRegion(0).front().without_terminator(),
+                      [&](Operation &op) {
+                        return &op == nested ||
+                               (!op.getNumRegions() && isMemoryEffectFree(&op));
+                      });
+}
+
+template <typename ForOpTy>
+static std::optional<ContractNest<ForOpTy>>
+matchContractNest(vector::ContractionOp contract) {
+  auto kLoop = dyn_cast<ForOpTy>(contract->getParentOp());
+  if (!kLoop)
+    return std::nullopt;
+  auto innerLoop = dyn_cast<ForOpTy>(kLoop->getParentOp());
+  if (!innerLoop)
+    return std::nullopt;
+  auto outerLoop = dyn_cast<ForOpTy>(innerLoop->getParentOp());
+  if (!outerLoop)
+    return std::nullopt;
+  if (kLoop->getNumResults() || innerLoop->getNumResults() ||
+      outerLoop->getNumResults())
+    return std::nullopt;
+  if (!isPerfectlyNested(outerLoop, innerLoop) ||
+      !isPerfectlyNested(innerLoop, kLoop))
+    return std::nullopt;
+
+  auto accRead = contract.getAcc().getDefiningOp<vector::TransferReadOp>();
+  if (!accRead || accRead->getBlock() != contract->getBlock() ||
+      !accRead->hasOneUse() || accRead.getMask())
+    return std::nullopt;
+  if (!contract->hasOneUse())
+    return std::nullopt;
+  auto accWrite = dyn_cast<vector::TransferWriteOp>(
+      *contract->getResult(0).getUsers().begin());
+  if (!accWrite || accWrite->getBlock() != contract->getBlock() ||
+      accWrite.getMask() || accWrite.getSource() != accRead.getSource() ||
+      !llvm::equal(accWrite.getIndices(), accRead.getIndices()) ||
+      accWrite.getPermutationMap() != accRead.getPermutationMap() ||
+      accWrite.getVectorType() != accRead.getVectorType())
+    return std::nullopt;
+
+  // The accumulator round trip must be the only memory write of the
+  // reduction loop, and the contraction the only one in it.
+  for (Operation &op : kLoop.getBody()->without_terminator()) {
+    if (&op == accWrite || isa<vector::TransferReadOp>(op))
+      continue;
+    if (op.getNumRegions() || !isMemoryEffectFree(&op))
+      return std::nullopt;
+    if (isa<vector::ContractionOp>(op) && &op != contract)
+      return std::nullopt;
+  }
+
+  Value written = accWrite.getSource();
+  Slice lhs(contract.getLhs(), outerLoop);
+  Slice rhs(contract.getRhs(), outerLoop);
+  Slice acc(accRead->getOperands(), outerLoop);
+  if (!lhs.isClonable(/*allowReads=*/true, written) ||
+      !rhs.isClonable(/*allowReads=*/true, written) ||
+      !acc.isClonable(/*allowReads=*/false, written))
+    return std::nullopt;
+
+  Value outerIv = outerLoop.getInductionVar();
+  Value innerIv = innerLoop.getInductionVar();
+  if (acc.dependsOn(kLoop.getInductionVar()))
+    return std::nullopt;
+
+  ContractNest<ForOpTy> nest;
+  if (!lhs.dependsOn(innerIv) && !rhs.dependsOn(outerIv)) {
+    nest.mLoop = outerLoop;
+    nest.nLoop = innerLoop;
+  } else if (!lhs.dependsOn(outerIv) && !rhs.dependsOn(innerIv)) {
+    nest.mLoop = innerLoop;
+    nest.nLoop = outerLoop;
+  } else {
+    return std::nullopt;
+  }
+
+  // Each iteration of the parallel loops must update its own accumulator,
+  // which holds if both induction variables index it directly.
+  auto indexes = [&](Value iv) {
+    return llvm::is_contained(accRead.getIndices(), iv);
+  };
+  if (!indexes(outerIv) || !indexes(innerIv))
+    return std::nullopt;
+
+  std::optional<int64_t> mTrips = getConstantTripCount(nest.mLoop);
+  std::optional<int64_t> nTrips = getConstantTripCount(nest.nLoop);
+  if (!mTrips || !nTrips || *mTrips <= 0 || *nTrips <= 0)
+    return std::nullopt;
+
+  nest.kLoop = kLoop;
+  nest.contract = contract;
+  nest.accRead = accRead;
+  nest.accWrite = accWrite;
+  nest.mTrips = *mTrips;
+  nest.nTrips = *nTrips;
+  return nest;
+}
+
+// Returns the number of bits of a contraction operand as it is loaded, before
+// it is widened for the contraction. aievec.matmul widens its operands itself.
+static int64_t getLoadedBits(Value operand) {
+  if (isa_and_nonnull<arith::ExtSIOp, arith::ExtUIOp, arith::ExtFOp>(
+          operand.getDefiningOp()))
+    operand = operand.getDefiningOp()->getOperand(0);
+  auto type = cast<VectorType>(operand.getType());
+  return type.getNumElements() * type.getElementTypeBitWidth();
+}
+
+// Chooses the number of lhs and rhs tiles of a micro-kernel. It keeps as many
+// accumulators live as possible, so that each loaded tile is reused the most,
+// while the accumulators fit in the accumulator registers and the loaded
+// tiles in half the vector registers, leaving the other half for the tiles of
+// the next reduction step. Ties go to the fewer loaded bits.
+static std::pair<int64_t, int64_t>
+chooseBlocking(const AIE::AIETargetModel &targetModel, int64_t lhsBits,
+               int64_t rhsBits, int64_t accBits, int64_t mTrips,
+               int64_t nTrips) {
+  int64_t maxAccs = targetModel.getNumAccumulatorRegisters() *
+                    targetModel.getAccumulatorCascadeSize() / accBits;
+  int64_t maxLoadBits = targetModel.getVectorRegisterFileSize() / 2;
+
+  std::pair<int64_t, int64_t> best = {1, 1};
+  int64_t bestLoadBits = lhsBits + rhsBits;
+  for (int64_t bm = 1; bm <= mTrips; bm++) {
+    if (mTrips % bm)
+      continue;
+    for (int64_t bn = 1; bn <= nTrips; bn++) {
+      if (nTrips % bn)
+        continue;
+      int64_t accs = bm * bn;
+      int64_t loadBits = bm * lhsBits + bn * rhsBits;
+      if (accs > maxAccs || loadBits > maxLoadBits)
+        continue;
+      int64_t bestAccs = best.first * best.second;
+      if (accs > bestAccs || (accs == bestAccs && loadBits < bestLoadBits)) {
+        best = {bm, bn};
+        bestLoadBits = loadBits;
+      }
+    }
+  }
+  return best;
+}
+
+//===----------------------------------------------------------------------===//
+// Loop kind specific helpers
+//===----------------------------------------------------------------------===//
+
+static void multiplyStep(scf::ForOp loop, int64_t factor) {
+  OpBuilder builder(loop);
+  int64_t step = *getConstantIntValue(loop.getStep());
+  loop.setStep(
+      builder.create<arith::ConstantIndexOp>(loop.getLoc(), step * factor));
+}
+
+static void multiplyStep(affine::AffineForOp loop, int64_t factor) {
+  loop.setStep(loop.getStepAsInt() * factor);
+}
+
+static Value offsetInductionVar(OpBuilder &builder, scf::ForOp loop,
+                                int64_t offset) {
+  Location loc = loop.getLoc();
+  return builder.create<arith::AddIOp>(
+      loc, loop.getInductionVar(),
+      builder.create<arith::ConstantIndexOp>(loc, offset));
+}
+
+static Value offsetInductionVar(OpBuilder &builder, affine::AffineForOp loop,
+                                int64_t offset) {
+  AffineExpr d0 = builder.getAffineDimExpr(0);
+  return builder.create<affine::AffineApplyOp>(
+      loop.getLoc(), AffineMap::get(1, 0, d0 + offset),
+      ValueRange{loop.getInductionVar()});
+}
+
+using LoopBodyBuilderFn =
+    function_ref<SmallVector<Value>(OpBuilder &, Value, ValueRange)>;
+
+static scf::ForOp createLoopLike(OpBuilder &builder, scf::ForOp loop,
+                                 ValueRange inits,
+                                 LoopBodyBuilderFn bodyBuilder) {
+  return builder.create<scf::ForOp>(
+      loop.getLoc(), loop.getLowerBound(), loop.getUpperBound(),
+      loop.getStep(), inits,
+      [&](OpBuilder &b, Location loc, Value iv, ValueRange iterArgs) {
+        b.create<scf::YieldOp>(loc, bodyBuilder(b, iv, iterArgs));
+      });
+}
+
+static affine::AffineForOp createLoopLike(OpBuilder &builder,
+                                          affine::AffineForOp loop,
+                                          ValueRange inits,
+                                          LoopBodyBuilderFn bodyBuilder) {
+  return builder.create<affine::AffineForOp>(
+      loop.getLoc(), loop.getLowerBoundOperands(), loop.getLowerBoundMap(),
+      loop.getUpperBoundOperands(), loop.getUpperBoundMap(),
+      loop.getStepAsInt(), inits,
+      [&](OpBuilder &b, Location loc, Value iv, ValueRange iterArgs) {
+        b.create<affine::AffineYieldOp>(loc, bodyBuilder(b, iv, iterArgs));
+      });
+}
+
+//===----------------------------------------------------------------------===//
+// Register blocking
+//===----------------------------------------------------------------------===//
+
+// Clones the ops inside `root` that `value` is computed from, with `map`
+// applied to their operands, and returns the clone of `value`.
+static Value cloneSlice(OpBuilder &builder, Value value, Operation *root,
+                        IRMapping &map) {
+  if (Value mapped = map.lookupOrNull(value))
+    return mapped;
+  Operation *def = value.getDefiningOp();
+  if (!def || !root->isProperAncestor(def))
+    return value;
+  for (Value operand : def->getOperands())
+    cloneSlice(builder, operand, root, map);
+  builder.clone(*def, map);
+  return map.lookup(value);
+}
+
+template <typename ForOpTy>
+static LogicalResult blockContractNest(vector::ContractionOp contract,
+                                       const AIE::AIETargetModel &targetModel,
+                                       int64_t blockM, int64_t blockN) {
+  std::optional<ContractNest<ForOpTy>> match =
+      matchContractNest<ForOpTy>(contract);
+  if (!match)
+    return failure();
+  ContractNest<ForOpTy> &nest = *match;
+
+  int64_t bm, bn;
+  std::tie(bm, bn) = chooseBlocking(
+      targetModel, getLoadedBits(contract.getLhs()),
+      getLoadedBits(contract.getRhs()), getLoadedBits(contract.getAcc()),
+      nest.mTrips, nest.nTrips);
+  if (blockM)
+    bm = blockM;
+  if (blockN)
+    bn = blockN;
+  if (nest.mTrips % bm || nest.nTrips % bn || bm * bn == 1)
+    return failure();
+
+  LLVM_DEBUG(llvm::dbgs() << "blocking " << contract << " by " << bm << "x"
+                          << bn << "\n");
+
+  Operation *root = nest.mLoop->isProperAncestor(nest.nLoop) ? nest.mLoop
+                                                             : nest.nLoop;
+  Value mIv = nest.mLoop.getInductionVar();
+  Value nIv = nest.nLoop.getInductionVar();
+  Value kIv = nest.kLoop.getInductionVar();
+  int64_t mStep = *getConstantIntValue(*nest.mLoop.getSingleStep());
+  int64_t nStep = *getConstantIntValue(*nest.nLoop.getSingleStep());
+
+  OpBuilder builder(nest.kLoop);
+  SmallVector<Value> mIvs = {mIv}, nIvs = {nIv};
+  for (int64_t i = 1; i < bm; i++)
+    mIvs.push_back(offsetInductionVar(builder, nest.mLoop, i * mStep));
+  for (int64_t j = 1; j < bn; j++)
+    nIvs.push_back(offsetInductionVar(builder, nest.nLoop, j * nStep));
+
+  // Load the accumulators before the reduction loop.
+  SmallVector<IRMapping> accMaps(bm * bn);
+  SmallVector<Value> inits;
+  for (int64_t i = 0; i < bm; i++) {
+    for (int64_t j = 0; j < bn; j++) {
+      IRMapping &map = accMaps[i * bn + j];
+      map.map(mIv, mIvs[i]);
+      map.map(nIv, nIvs[j]);
+      for (Value operand : nest.accRead->getOperands())
+        cloneSlice(builder, operand, root, map);
+      inits.push_back(builder.clone(*nest.accRead, map)->getResult(0));
+    }
+  }
+
+  // Load each lhs and rhs tile once per reduction step, and contract every
+  // pair of them into its own accumulator.
+  auto newLoop = createLoopLike(
+      builder, nest.kLoop, inits,
+      [&](OpBuilder &b, Value newKIv, ValueRange accs) {
+        SmallVector<Value> lhsTiles, rhsTiles;
+        for (int64_t i = 0; i < bm; i++) {
+          IRMapping map;
+          map.map(mIv, mIvs[i]);
+          map.map(kIv, newKIv);
+          lhsTiles.push_back(cloneSlice(b, contract.getLhs(), root, map));
+        }
+        for (int64_t j = 0; j < bn; j++) {
+          IRMapping map;
+          map.map(nIv, nIvs[j]);
+          map.map(kIv, newKIv);
+          rhsTiles.push_back(cloneSlice(b, contract.getRhs(), root, map));
+        }
+        SmallVector<Value> results;
+        for (int64_t i = 0; i < bm; i++) {
+          for (int64_t j = 0; j < bn; j++) {
+            IRMapping map;
+            map.map(contract.getLhs(), lhsTiles[i]);
+            map.map(contract.getRhs(), rhsTiles[j]);
+            map.map(contract.getAcc(), accs[i * bn + j]);
+            results.push_back(b.clone(*contract, map)->getResult(0));
+          }
+        }
+        return results;
+      });
+
+  // Store the accumulators after it.
+  for (auto [idx, map] : llvm::enumerate(accMaps)) {
+    map.map(contract.getResult(), newLoop->getResult(idx));
+    builder.clone(*nest.accWrite, map);
+  }
+
+  nest.kLoop->erase();
+  multiplyStep(nest.mLoop, bm);
+  multiplyStep(nest.nLoop, bn);
+  return success();
+}
+
+struct AIEVecMatMulRegisterBlocking
+    : AIEVecMatMulRegisterBlockingBase<AIEVecMatMulRegisterBlocking> {
+  void runOnOperation() override {
+    func::FuncOp func = getOperation();
+    const AIE::AIETargetModel *targetModel = getTargetModel(func, aieTarget);
+    if (!targetModel) {
+      func.emitError() << "unknown AIE target '" << aieTarget << "'";
+      signalPassFailure();
+      return;
+    }
+
+    // Each nest holds a single contraction, so blocking one nest does not
+    // invalidate the others.
+    SmallVector<vector::ContractionOp> contracts;
+    func.walk([&](vector::ContractionOp op) { contracts.push_back(op); });
+    for (vector::ContractionOp contract : contracts) {
+      if (succeeded(blockContractNest<scf::ForOp>(contract, *targetModel,
+                                                  blockM, blockN)))
+        continue;
+      (void)blockContractNest<affine::AffineForOp>(contract, *targetModel,
+                                                   blockM, blockN);
+    }
+  }
+};
+
+std::unique_ptr<Pass> aievec::createAIEVecMatMulRegisterBlockingPass() {
+  return std::make_unique<AIEVecMatMulRegisterBlocking>();
+}
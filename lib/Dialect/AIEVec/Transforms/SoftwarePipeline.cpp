@@ -0,0 +1,310 @@
+//===- SoftwarePipeline.cpp - Software-pipeline vector loops --------------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file splits the body of innermost scf.for loops into two stages, the
+// loads and the computation on their results, and pipelines them so that the
+// loads of one iteration are issued alongside the computation of the previous
+// one. A per-architecture latency table decides whether this shortens the
+// critical path of an iteration, and gives a static estimate of it.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Transforms/Patterns.h"
+#include "mlir/Dialect/SCF/Transforms/Transforms.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+#define DEBUG_TYPE "aievec-software-pipeline"
+
+namespace {
+
+// Approximate result latencies, in cycles, of the classes of ops found in
+// vectorized loop bodies.
+struct LatencyTable {
+  unsigned vectorLoad;
+  unsigned scalarLoad;
+  unsigned store;
+  unsigned multiply;
+  unsigned shiftRoundSaturate;
+  unsigned vectorAlu;
+  unsigned scalar;
+};
+
+} // namespace
+
+static constexpr LatencyTable aie2Latencies = {
+    /*vectorLoad=*/7,        /*scalarLoad=*/6, /*store=*/1, /*multiply=*/6,
+    /*shiftRoundSaturate=*/4, /*vectorAlu=*/2,  /*scalar=*/1};
+
+static constexpr LatencyTable aie2pLatencies = {
+    /*vectorLoad=*/7,        /*scalarLoad=*/6, /*store=*/1, /*multiply=*/7,
+    /*shiftRoundSaturate=*/4, /*vectorAlu=*/2,  /*scalar=*/1};
+
+static const LatencyTable *getLatencyTable(AIE::AIEArch arch) {
+  switch (arch) {
+  case AIE::AIEArch::AIE2:
+    return &aie2Latencies;
+  case AIE::AIEArch::AIE2p:
+    return &aie2pLatencies;
+  default:
+    return nullptr;
+  }
+}
+
+static unsigned getLatency(Operation *op, const LatencyTable &table) {
+  return llvm::TypeSwitch<Operation *, unsigned>(op)
+      .Case<vector::TransferReadOp, vector::LoadOp, aievec::UPDOp>(
+          [&](auto) { return table.vectorLoad; })
+      .Case<memref::LoadOp>([&](auto) { return table.scalarLoad; })
+      .Case<vector::TransferWriteOp, vector::StoreOp, memref::StoreOp>(
+          [&](auto) { return table.store; })
+      .Case<aievec::MatMulOp, aievec::FMAElemOp, aievec::MulElemOp,
+            aievec::FMAConvOp, aievec::MulConvOp, vector::ContractionOp,
+            vector::FMAOp>([&](auto) { return table.multiply; })
+      .Case<aievec::SRSOp, aievec::UPSOp, aievec::PackOp, aievec::UnpackOp>(
+          [&](auto) { return table.shiftRoundSaturate; })
+      .Default([&](Operation *op) {
+        if (isa_and_nonnull<aievec::AIEVecDialect, vector::VectorDialect>(
+                op->getDialect()))
+          return table.vectorAlu;
+        return table.scalar;
+      });
+}
+
+// Returns the length, in cycles, of the longest chain of dependences through
+// one iteration of `body`. The results of the ops in `ready` are taken to be
+// available when the iteration starts.
+static unsigned getCriticalPath(Block &body, const LatencyTable &table,
+                                const llvm::DenseSet<Operation *> &ready) {
+  llvm::DenseMap<Operation *, unsigned> finish;
+  unsigned length = 0;
+  for (Operation &op : body.without_terminator()) {
+    unsigned start = 0;
+    for (Value operand : op.getOperands()) {
+      Operation *def = operand.getDefiningOp();
+      if (def && def->getBlock() == &body && !ready.contains(def))
+        start = std::max(start, finish.lookup(def));
+    }
+    unsigned end = start + getLatency(&op, table);
+    finish[&op] = end;
+    length = std::max(length, end);
+  }
+  return length;
+}
+
+// Returns the memref read by a load, or a null value for other ops.
+static Value getLoadedMemRef(Operation *op) {
+  Value memref =
+      llvm::TypeSwitch<Operation *, Value>(op)
+          .Case<vector::TransferReadOp, aievec::UPDOp>(
+              [](auto loadOp) { return loadOp.getSource(); })
+          .Case<vector::LoadOp>([](auto loadOp) { return loadOp.getBase(); })
+          .Case<memref::LoadOp>(
+              [](auto loadOp) { return loadOp.getMemRef(); })
+          .Default([](Operation *) { return Value(); });
+  if (memref && isa<MemRefType>(memref.getType()))
+    return memref;
+  return {};
+}
+
+namespace {
+
+// Splits the body of an innermost loop into the loads that can be issued one
+// iteration early, along with the address computations they depend on, and
+// everything else.
+class LoopStages {
+public:
+  explicit LoopStages(scf::ForOp loop) : loop(loop) {}
+
+  // Fills the first stage. Returns failure if the body has side effects on
+  // memory that cannot be attributed to a buffer.
+  LogicalResult analyze() {
+    bool unknownWrites = false;
+    loop.getBody()->walk([&](Operation *op) {
+      if (op->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+        return;
+      auto effectOp = dyn_cast<MemoryEffectOpInterface>(op);
+      if (!effectOp) {
+        unknownWrites = true;
+        return;
+      }
+      SmallVector<MemoryEffects::EffectInstance> effects;
+      effectOp.getEffects(effects);
+      for (const MemoryEffects::EffectInstance &effect : effects) {
+        if (!isa<MemoryEffects::Write>(effect.getEffect()))
+          continue;
+        if (Value value = effect.getValue())
+          written.insert(getUnderlyingBuffer(value));
+        else
+          unknownWrites = true;
+      }
+    });
+    if (unknownWrites)
+      return failure();
+    writesAliasingArgument = llvm::any_of(written, isAliasingArgument);
+
+    for (Operation &op : loop.getBody()->without_terminator()) {
+      if (!getLoadedMemRef(&op))
+        continue;
+      llvm::DenseSet<Operation *> stage = firstStage;
+      llvm::DenseSet<Value> visitedArgs;
+      if (addToFirstStage(op.getResult(0), stage, visitedArgs))
+        firstStage = std::move(stage);
+    }
+    return success();
+  }
+
+  const llvm::DenseSet<Operation *> &getFirstStage() const {
+    return firstStage;
+  }
+
+  // The schedule expected by the SCF pipeliner: the ops of the first stage,
+  // then those of the second, each in program order.
+  void getSchedule(std::vector<std::pair<Operation *, unsigned>> &schedule) {
+    for (Operation &op : loop.getBody()->without_terminator())
+      if (firstStage.contains(&op))
+        schedule.emplace_back(&op, 0);
+    for (Operation &op : loop.getBody()->without_terminator())
+      if (!firstStage.contains(&op))
+        schedule.emplace_back(&op, 1);
+  }
+
+private:
+  // Returns true if `op` may move to the first stage: a load from a buffer
+  // that the loop does not write, or a side effect free op without regions.
+  // A buffer that is a memref argument is written by the loop if it writes
+  // any argument that the buffer may alias.
+  bool isFirstStageOp(Operation *op) const {
+    if (Value memref = getLoadedMemRef(op)) {
+      Value buffer = getUnderlyingBuffer(memref);
+      return !written.contains(buffer) &&
+             !(writesAliasingArgument && isAliasingArgument(buffer));
+    }
+    return !op->getNumRegions() && isMemoryEffectFree(op);
+  }
+
+  // Adds the ops that `value` is computed from, within one iteration and
+  // through the loop-carried values, to `stage`. Returns false if any of them
+  // cannot move to the first stage.
+  bool addToFirstStage(Value value, llvm::DenseSet<Operation *> &stage,
+                       llvm::DenseSet<Value> &visitedArgs) {
+    if (auto arg = dyn_cast<BlockArgument>(value)) {
+      OpOperand *yielded = loop.getTiedLoopYieldedValue(arg);
+      if (!yielded || !visitedArgs.insert(arg).second)
+        return true;
+      return addToFirstStage(yielded->get(), stage, visitedArgs);
+    }
+    Operation *def = value.getDefiningOp();
+    if (def->getBlock() != loop.getBody())
+      return true;
+    if (stage.contains(def))
+      return true;
+    if (!isFirstStageOp(def))
+      return false;
+    stage.insert(def);
+    return llvm::all_of(def->getOperands(), [&](Value operand) {
+      return addToFirstStage(operand, stage, visitedArgs);
+    });
+  }
+
+  scf::ForOp loop;
+  llvm::DenseSet<Value> written;
+  bool writesAliasingArgument = false;
+  llvm::DenseSet<Operation *> firstStage;
+};
+
+} // namespace
+
+static bool isInnermost(scf::ForOp loop) {
+  WalkResult result = loop.getBody()->walk(
+      [](LoopLikeOpInterface) { return WalkResult::interrupt(); });
+  return !result.wasInterrupted();
+}
+
+static std::optional<int64_t> getConstantTripCount(scf::ForOp loop) {
+  return constantTripCount(getAsOpFoldResult(loop.getLowerBound()),
+                           getAsOpFoldResult(loop.getUpperBound()),
+                           getAsOpFoldResult(loop.getStep()));
+}
+
+struct AIEVecSoftwarePipeline
+    : AIEVecSoftwarePipelineBase<AIEVecSoftwarePipeline> {
+  void runOnOperation() override {
+    SmallVector<scf::ForOp> loops;
+    getOperation().walk([&](scf::ForOp loop) {
+      if (isInnermost(loop))
+        loops.push_back(loop);
+    });
+
+    IRRewriter rewriter(&getContext());
+    for (scf::ForOp loop : loops) {
+      const AIE::AIETargetModel *targetModel = getTargetModel(loop, aieTarget);
+      if (!targetModel) {
+        getOperation().emitError() << "unknown AIE target '" << aieTarget
+                                   << "'";
+        signalPassFailure();
+        return;
+      }
+      const LatencyTable *table =
+          getLatencyTable(targetModel->getTargetArch());
+      if (!table)
+        continue;
+
+      LoopStages stages(loop);
+      bool canPipeline = succeeded(stages.analyze()) &&
+                         !stages.getFirstStage().empty() &&
+                         getConstantTripCount(loop).value_or(0) > 1;
+      unsigned before = getCriticalPath(*loop.getBody(), *table, {});
+      unsigned after =
+          canPipeline ? getCriticalPath(*loop.getBody(), *table,
+                                        stages.getFirstStage())
+                      : before;
+      if (emitEstimates) {
+        InFlightDiagnostic remark = loop.emitRemark()
+                                    << "estimated " << before
+                                    << " cycles per iteration";
+        if (after < before)
+          remark << ", " << after << " when software pipelined";
+      }
+      if (after >= before)
+        continue;
+
+      LLVM_DEBUG(llvm::dbgs() << "Pipelining " << loop << "\n");
+      scf::PipeliningOption options;
+      options.getScheduleFn =
+          [&](scf::ForOp,
+              std::vector<std::pair<Operation *, unsigned>> &schedule) {
+            stages.getSchedule(schedule);
+          };
+      rewriter.setInsertionPoint(loop);
+      if (failed(scf::pipelineForLoop(rewriter, loop, options)))
+        LLVM_DEBUG(llvm::dbgs() << "Could not pipeline the loop\n");
+    }
+  }
+};
+
+std::unique_ptr<Pass> aievec::createAIEVecSoftwarePipelinePass() {
+  return std::make_unique<AIEVecSoftwarePipeline>();
+}
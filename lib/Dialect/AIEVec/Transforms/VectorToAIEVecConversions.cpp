@@ -2972,6 +2972,69 @@ struct LowerVectorContractionOpToAIEVecMatMulPattern
   bool matMoveToAcc;
 };
 
+// Convert a `vector.contract` op with an operand unpacked from bfp16 to an
+// `aievec.matmul_bfp` op for AIE2P. The block floating point mmul takes both
+// operands in bfp16, so the other one is packed. That loses precision: each
+// block of 8 elements is scaled to the exponent of its largest one, so the
+// smaller elements keep fewer significant bits than in bf16, and f32
+// operands are rounded to 8-bit mantissas. Contractions without a bfp16
+// operand are left to the bf16 patterns, which keep their precision.
+// The bfp16 ops cannot be lowered to LLVM IR or C++ yet, so this pattern
+// only runs with the `bfp16-matmul` option.
+struct LowerVectorContractionOpToAIEVecMatMulBFPPattern
+    : OpConversionPattern<vector::ContractionOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LowerVectorContractionOpToAIEVecMatMulBFPPattern(MLIRContext *context)
+      : OpConversionPattern(context, /*benefit=*/2) {}
+
+  LogicalResult
+  matchAndRewrite(vector::ContractionOp contractOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    MLIRContext *ctx = contractOp.getContext();
+    if (contractOp.getKind() != vector::CombiningKind::ADD)
+      return failure();
+    AffineExpr m, n, k;
+    bindDims(ctx, m, n, k);
+    if (contractOp.getIndexingMapsArray() !=
+        AffineMap::inferFromExprList({{m, k}, {k, n}, {m, n}}, ctx))
+      return failure();
+
+    auto lhsUnpack = adaptor.getLhs().getDefiningOp<aievec::UnpackBFPOp>();
+    auto rhsUnpack = adaptor.getRhs().getDefiningOp<aievec::UnpackBFPOp>();
+    if (!lhsUnpack && !rhsUnpack)
+      return failure();
+
+    // The only shape of the bfp16 mmul is 8x8x8, accumulated in f32.
+    auto isBFPMatMulOperand = [](Type type, Type elemTy = nullptr) {
+      auto vecTy = dyn_cast<VectorType>(type);
+      if (!vecTy || vecTy.getShape() != ArrayRef<int64_t>{8, 8})
+        return false;
+      if (elemTy)
+        return vecTy.getElementType() == elemTy;
+      return vecTy.getElementType().isBF16() || vecTy.getElementType().isF32();
+    };
+    if (!isBFPMatMulOperand(adaptor.getLhs().getType()) ||
+        !isBFPMatMulOperand(adaptor.getRhs().getType()) ||
+        !isBFPMatMulOperand(adaptor.getAcc().getType(), rewriter.getF32Type()))
+      return failure();
+
+    Location loc = contractOp.getLoc();
+    auto getBFPOperand = [&](Value v, aievec::UnpackBFPOp unpack) -> Value {
+      if (unpack)
+        return unpack.getSource();
+      auto bfpTy = aievec::BFP16Type::get(
+          ctx, cast<VectorType>(v.getType()).getShape());
+      return rewriter.create<aievec::PackBFPOp>(loc, bfpTy, v);
+    };
+    Value lhs = getBFPOperand(adaptor.getLhs(), lhsUnpack);
+    Value rhs = getBFPOperand(adaptor.getRhs(), rhsUnpack);
+    rewriter.replaceOpWithNewOp<aievec::MatMulBFPOp>(
+        contractOp, adaptor.getAcc().getType(), lhs, rhs, adaptor.getAcc());
+    return success();
+  }
+};
+
 // Convert a `vector.transpose` op to an `aievec.shuffle` op for AIE2.
 struct LowerVectorTransposeOpToAIEVecShuffleOpPattern
     : OpConversionPattern<vector::TransposeOp> {
@@ -3144,6 +3207,13 @@ static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
   // clang-format on
 }
 
+static void populateAIEVecV2PConversionPatterns(RewritePatternSet &patterns,
+                                                TargetBackend backend) {
+  populateAIEVecV2ConversionPatterns(patterns, backend);
+  patterns.add<LowerVectorContractionOpToAIEVecMatMulBFPPattern>(
+      patterns.getContext());
+}
+
 //===----------------------------------------------------------------------===//
 // Legalizations
 //===----------------------------------------------------------------------===//
@@ -3791,6 +3861,7 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
       : LowerVectorToAIEVec() {
     aieTarget = options.aieTarget;
     targetBackend = options.targetBackend;
+    bfp16MatMul = options.bfp16MatMul;
   }
 
   // In case we want to register this pass as a standalone pass for test
@@ -3809,8 +3880,9 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
 
   Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". "
+                     "This will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
 
   Option<std::string> targetBackend{
@@ -3820,6 +3892,13 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
                      "from vector dialect."),
       llvm::cl::init("cpp")};
 
+  Option<bool> bfp16MatMul{
+      *this, "bfp16-matmul",
+      llvm::cl::desc("Lower contractions with a bfp16 operand to "
+                     "aievec.matmul_bfp on AIE2P. Experimental: the bfp16 "
+                     "ops have no LLVM IR or C++ lowering yet."),
+      llvm::cl::init(false)};
+
   void runOnOperation() override {
     auto *op = getOperation();
     MLIRContext *context = &getContext();
@@ -3830,6 +3909,8 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
       std::string target = aieTarget;
       if (target == "aieml" || target == "aie2")
         aieVersion = AIEArch::AIE2;
+      else if (target == "aie2p")
+        aieVersion = AIEArch::AIE2P;
       else if (target != "aie") {
         op->emitError() << "unknown AIE target '" << aieTarget << "'";
         return signalPassFailure();
@@ -3859,7 +3940,10 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
       populateAIEVecV1ConversionPatterns(patterns, backend);
       configureAIEVecV1Legalizations(target, backend);
     } else {
-      populateAIEVecV2ConversionPatterns(patterns, backend);
+      if (aieVersion == AIEArch::AIE2P && bfp16MatMul)
+        populateAIEVecV2PConversionPatterns(patterns, backend);
+      else
+        populateAIEVecV2ConversionPatterns(patterns, backend);
       configureAIEVecV2Legalizations(target, backend);
     }
 
@@ -13,6 +13,7 @@
 
 #include "aie/Dialect/AIEVec/AIEVecUtils.h"
 #include "aie/Dialect/AIEVec/Pipelines/Passes.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
 #include "aie/Dialect/AIEVec/Utils/Utils.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
 #include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
@@ -53,6 +54,8 @@ static AIEArch decodeAIETarget(const std::string &target) {
   if (!target.empty()) {
     if (target == "aieml" || target == "aie2")
       return AIEArch::AIE2;
+    if (target == "aie2p")
+      return AIEArch::AIE2P;
     if (target != "aie")
       return AIEArch::UNKNOWN;
   }
@@ -805,8 +808,9 @@ struct CanonicalizeVectorForAIEVecPass
 
   Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". "
+                     "This will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
 
   Option<std::string> targetBackend{
@@ -916,6 +920,9 @@ void xilinx::aievec::buildCanonicalizeVectorForAIEVec(
   // Add `Vector` code canonicalization passes
   // TODO: Add passes to unroll vector with unsupported types
   // TODO: Add passes to split vectors that won't fit in registers
+  if (options.fuseNormalizationLoops &&
+      decodeAIETarget(options.aieTarget) == AIEArch::AIE2)
+    pm.addPass(createAIEVecFuseNormalizationLoopsPass());
   if (decodeTargetBackend(options.targetBackend) == TargetBackend::LLVMIR)
     pm.addPass(createReorderOperationsPass());
   pm.addPass(createCopyRemovalPass());
@@ -302,10 +302,10 @@ int64_t AIEX::NpuDmaMemcpyNdOp::getOffsetInBytes() {
       llvm::map_to_vector(llvm::reverse(getMixedOffsets()), [](OpFoldResult s) {
         return getConstantIntValue(s).value();
       });
-  llvm::SmallVector<int64_t, 4> strides =
-      llvm::map_to_vector(llvm::reverse(getMixedStrides()), [](OpFoldResult s) {
-        return getConstantIntValue(s).value();
-      });
+  // The offset is zero in the dimensions with a runtime stride.
+  llvm::SmallVector<int64_t, 4> sizes;
+  llvm::SmallVector<int64_t, 4> strides;
+  getTemplateSizesAndStrides(sizes, strides);
   size_t offset = 0;
   BaseMemRefType my_memref = getMemref().getType();
   size_t R = offsets.size();
@@ -318,19 +318,56 @@ int64_t AIEX::NpuDmaMemcpyNdOp::getOffsetInBytes() {
   return offset;
 }
 
+// Returns the index of the runtime sequence argument that gives a size or
+// stride, if it is one.
+static std::optional<unsigned> getRuntimeParameter(OpFoldResult value) {
+  auto arg = llvm::dyn_cast_if_present<BlockArgument>(
+      llvm::dyn_cast_if_present<Value>(value));
+  if (!arg || !isa<AIEX::RuntimeSequenceOp>(arg.getOwner()->getParentOp()) ||
+      !arg.getType().isInteger(64))
+    return std::nullopt;
+  return arg.getArgNumber();
+}
+
+llvm::SmallVector<std::optional<unsigned>, 4>
+AIEX::NpuDmaMemcpyNdOp::getSizeParameters() {
+  return llvm::map_to_vector<4>(llvm::reverse(getMixedSizes()),
+                                getRuntimeParameter);
+}
+
+llvm::SmallVector<std::optional<unsigned>, 4>
+AIEX::NpuDmaMemcpyNdOp::getStrideParameters() {
+  return llvm::map_to_vector<4>(llvm::reverse(getMixedStrides()),
+                                getRuntimeParameter);
+}
+
+void AIEX::NpuDmaMemcpyNdOp::getTemplateSizesAndStrides(
+    llvm::SmallVector<int64_t, 4> &sizes,
+    llvm::SmallVector<int64_t, 4> &strides) {
+  // One unit of address granularity, in elements
+  const auto &targetModel = AIE::getTargetModel(*this);
+  int64_t granule =
+      std::max<int64_t>(1, targetModel.getAddressGenGranularity() /
+                               getMemref().getType().getElementTypeBitWidth());
+  sizes = llvm::map_to_vector<4>(llvm::reverse(getMixedSizes()),
+                                 [](OpFoldResult s) {
+                                   return getConstantIntValue(s).value_or(2);
+                                 });
+  if (!getConstantIntValue(getMixedSizes().back()))
+    sizes[0] = granule;
+  strides = llvm::map_to_vector<4>(
+      llvm::reverse(getMixedStrides()),
+      [&](OpFoldResult s) { return getConstantIntValue(s).value_or(granule); });
+}
+
 // dma_memcpy_nd transfers of the form [*, 1, 1, len][*, 0, 0, 1] do not
 // specify any data layout transformation, but simply express a contiguous
 // transfer of `len`. We exclude checks to 4th dimension, because repeat count
 // is still possible without a data layout transformation.
 bool AIEX::NpuDmaMemcpyNdOp::isLinearTransferWithoutTransformation() {
-  llvm::SmallVector<int64_t, 4> inputSizes =
-      llvm::map_to_vector(llvm::reverse(getMixedSizes()), [](OpFoldResult s) {
-        return getConstantIntValue(s).value();
-      });
-  llvm::SmallVector<int64_t, 4> inputStrides =
-      llvm::map_to_vector(llvm::reverse(getMixedStrides()), [](OpFoldResult s) {
-        return getConstantIntValue(s).value();
-      });
+  llvm::SmallVector<int64_t, 4> inputSizes;
+  llvm::SmallVector<int64_t, 4> inputStrides;
+  getTemplateSizesAndStrides(inputSizes, inputStrides);
   return (inputSizes[1] == 1 && inputSizes[2] == 1 && inputStrides[0] == 1 &&
           inputStrides[1] == 0 && inputStrides[2] == 0);
 }
@@ -349,27 +386,50 @@ LogicalResult AIEX::NpuDmaMemcpyNdOp::verify() {
     return emitOpError("Minimum data transfer size required is ")
            << addressGranularity << "bits. ";
   }
-  if (!llvm::all_of(getMixedStrides(), [](OpFoldResult s) {
-        return getConstantIntValue(s).has_value();
-      }))
-    return emitOpError("Only constant strides currently supported.");
-  if (!llvm::all_of(getMixedSizes(), [](OpFoldResult s) {
-        return getConstantIntValue(s).has_value();
-      }))
-    return emitOpError("Only constant sizes currently supported.");
+  llvm::SmallVector<std::optional<unsigned>, 4> sizeParams =
+      getSizeParameters();
+  llvm::SmallVector<std::optional<unsigned>, 4> strideParams =
+      getStrideParameters();
+  auto reversedStrides = llvm::to_vector(llvm::reverse(getMixedStrides()));
+  auto reversedSizes = llvm::to_vector(llvm::reverse(getMixedSizes()));
+  for (int i = 0; i < 4; i++)
+    if (!strideParams[i] && !getConstantIntValue(reversedStrides[i]))
+      return emitOpError("Only constant strides or runtime sequence "
+                         "arguments currently supported.");
+  for (int i = 0; i < 4; i++)
+    if (!sizeParams[i] && !getConstantIntValue(reversedSizes[i]))
+      return emitOpError("Only constant sizes or runtime sequence arguments "
+                         "currently supported.");
   if (!llvm::all_of(getMixedOffsets(), [](OpFoldResult s) {
         return getConstantIntValue(s).has_value();
       }))
     return emitOpError("Only constant offsets currently supported.");
 
-  llvm::SmallVector<int64_t, 4> inputSizes =
-      llvm::map_to_vector(llvm::reverse(getMixedSizes()), [](OpFoldResult s) {
-        return getConstantIntValue(s).value();
-      });
-  llvm::SmallVector<int64_t, 4> inputStrides =
-      llvm::map_to_vector(llvm::reverse(getMixedStrides()), [](OpFoldResult s) {
-        return getConstantIntValue(s).value();
-      });
+  // Sizes and strides given by runtime parameters are patched into the BD by
+  // the host, so each BD field may only depend on one of them.
+  bool hasParams = llvm::any_of(sizeParams, [](auto p) { return p; }) ||
+                   llvm::any_of(strideParams, [](auto p) { return p; });
+  if (hasParams) {
+    if (targetModel.getTargetArch() == AIE::AIEArch::AIE1)
+      return emitOpError("Runtime sizes and strides are not supported on "
+                         "AIE1.");
+    if (sizeParams[3])
+      return emitOpError("Size 3 cannot be a runtime parameter.");
+    if (strideParams[0])
+      return emitOpError("Stride 0 cannot be a runtime parameter.");
+    if (llvm::count_if(sizeParams, [](auto p) { return p; }) > 1)
+      return emitOpError("At most one size can be a runtime parameter.");
+    auto offsets = llvm::to_vector(llvm::reverse(getMixedOffsets()));
+    for (int i = 0; i < 4; i++)
+      if (strideParams[i] && getConstantIntValue(offsets[i]) != 0)
+        return emitOpError("Offset ")
+               << i << " must be zero when stride " << i
+               << " is a runtime parameter.";
+  }
+
+  llvm::SmallVector<int64_t, 4> inputSizes;
+  llvm::SmallVector<int64_t, 4> inputStrides;
+  getTemplateSizesAndStrides(inputSizes, inputStrides);
   llvm::SmallVector<int64_t, 4> hardwareSizes(4);
   llvm::SmallVector<int64_t, 4> hardwareStrides(4);
   getHardwareStridesWraps(targetModel, buffer, inputSizes, inputStrides,
@@ -414,6 +474,18 @@ LogicalResult AIEX::NpuDmaMemcpyNdOp::verify() {
   return success();
 }
 
+//===----------------------------------------------------------------------===//
+// NpuFieldPatchOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult AIEX::NpuFieldPatchOp::verify() {
+  if (getWidth() < 1 || getShift() < 0 || getShift() + getWidth() > 32)
+    return emitOpError("Field must lie within a 32-bit register.");
+  if (getDiv() < 1)
+    return emitOpError("Divisor must be a positive integer.");
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // NpuDmaWaitOp
 //===----------------------------------------------------------------------===//
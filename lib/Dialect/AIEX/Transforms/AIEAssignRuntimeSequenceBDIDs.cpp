@@ -16,152 +16,267 @@
 #include "mlir/Pass/Pass.h"
 #include "llvm/ADT/TypeSwitch.h"
 
+#include <limits>
+
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIEX;
 
+namespace {
+
+// The task queue of a DMA channel: column, row, direction and channel.
+using TaskQueue = std::tuple<int, int, AIE::DMAChannelDir, int>;
+
+// The range of the runtime sequence over which the BD IDs of a configured
+// task are in use. `start` is the position of the configure operation; `end`
+// is the position of the first operation after which the task is known to
+// have completed or been freed, so that its BD IDs can be reused.
+struct TaskLiveness {
+  DMAConfigureTaskOp task;
+  unsigned start;
+  unsigned end = std::numeric_limits<unsigned>::max();
+  std::optional<unsigned> started;
+  SmallVector<uint32_t> bdIds;
+
+  bool overlaps(const TaskLiveness &other) const {
+    return start < other.end && other.start < end;
+  }
+};
+
+TaskQueue getTaskQueue(DMAConfigureTaskOp op) {
+  AIE::TileOp tile = op.getTileOp();
+  return {tile.getCol(), tile.getRow(), op.getDirection(),
+          static_cast<int>(op.getChannel())};
+}
+
+} // namespace
+
 struct AIEAssignRuntimeSequenceBDIDsPass
     : AIEAssignRuntimeSequenceBDIDsBase<AIEAssignRuntimeSequenceBDIDsPass> {
 
-  BdIdGenerator &
-  getGeneratorForTile(AIE::TileOp tile,
-                      std::map<AIE::TileOp, BdIdGenerator> &gens) {
-    const AIETargetModel &targetModel =
-        tile->getParentOfType<AIE::DeviceOp>().getTargetModel();
-    auto genIt = gens.find(tile);
-    if (genIt == gens.end()) {
-      gens.insert(std::pair(
-          tile, BdIdGenerator(tile.getCol(), tile.getRow(), targetModel)));
+  std::vector<TaskLiveness> tasks;
+  DenseMap<Operation *, unsigned> taskIndex;
+  // Indices of started tasks, in the order they were started, per queue.
+  std::map<TaskQueue, SmallVector<unsigned>> queues;
+  // Number of tasks at the front of each queue known to have completed.
+  std::map<TaskQueue, unsigned> completed;
+
+  LogicalResult verifyTaskReference(Operation *op, Value task) {
+    if (isa_and_nonnull<DMAConfigureTaskOp>(task.getDefiningOp())) {
+      return success();
     }
-    BdIdGenerator &gen = std::get<1>(*gens.find(tile));
-    return gen;
+    auto err =
+        op->emitOpError("does not reference a valid configure_task operation.");
+    Operation *task_op = task.getDefiningOp();
+    if (llvm::isa_and_nonnull<DMAStartBdChainOp>(task_op)) {
+      err.attachNote(task_op->getLoc())
+          << "Lower this operation first using the "
+             "--aie-materialize-bd-chains pass.";
+    }
+    if (llvm::isa_and_nonnull<DMAConfigureTaskForOp>(task_op)) {
+      err.attachNote(task_op->getLoc())
+          << "Lower this operation first using the "
+             "--aie-substitute-shim-dma-allocations pass.";
+    }
+    return err;
   }
 
-  LogicalResult runOnConfigureBDs(DMAConfigureTaskOp op,
-                                  std::map<AIE::TileOp, BdIdGenerator> &gens) {
-    AIE::TileOp tile = op.getTileOp();
-    BdIdGenerator &gen = getGeneratorForTile(tile, gens);
-
-    // First, honor all the user-specified BD IDs
-    WalkResult result = op.walk<WalkOrder::PreOrder>([&](AIE::DMABDOp bd_op) {
-      if (bd_op.getBdId().has_value()) {
-        if (gen.bdIdAlreadyAssigned(bd_op.getBdId().value())) {
-          op.emitOpError("Specified buffer descriptor ID ")
-              << bd_op.getBdId().value()
-              << " is already in use. Emit an aiex.dma_free_task operation to "
-                 "reuse BDs.";
-          return WalkResult::interrupt();
-        }
-        gen.assignBdId(bd_op.getBdId().value());
-      }
-      return WalkResult::advance();
+  void endLiveness(unsigned index, unsigned position) {
+    tasks[index].end = std::min(tasks[index].end, position);
+  }
+
+  // Numbers the operations of the device in order and computes the liveness
+  // of each configured task. A task's BDs are live until it is freed, until it
+  // is awaited, or until a task started after it on the same queue is awaited,
+  // since a queue completes its tasks in order. A sync on a queue consumes a
+  // single task completion token, so it only completes the oldest task
+  // started on it that is not known to have completed yet.
+  LogicalResult computeLiveness(AIE::DeviceOp device) {
+    unsigned position = 0;
+    WalkResult result = device.walk<WalkOrder::PreOrder>([&](Operation *op) {
+      position++;
+      LogicalResult result =
+          llvm::TypeSwitch<Operation *, LogicalResult>(op)
+              .Case<DMAConfigureTaskOp>([&](DMAConfigureTaskOp op) {
+                taskIndex[op] = tasks.size();
+                tasks.push_back({op, position});
+                return success();
+              })
+              .Case<DMAStartTaskOp>([&](DMAStartTaskOp op) {
+                DMAConfigureTaskOp task_op = op.getTaskOp();
+                if (!task_op) {
+                  return success();
+                }
+                unsigned index = taskIndex[task_op];
+                if (!tasks[index].started) {
+                  tasks[index].started = position;
+                  queues[getTaskQueue(task_op)].push_back(index);
+                }
+                return success();
+              })
+              .Case<DMAAwaitTaskOp>([&](DMAAwaitTaskOp op) {
+                if (failed(verifyTaskReference(op, op.getTask()))) {
+                  return failure();
+                }
+                DMAConfigureTaskOp task_op = op.getTaskOp();
+                unsigned index = taskIndex[task_op];
+                endLiveness(index, position);
+                if (!tasks[index].started) {
+                  return success();
+                }
+                TaskQueue queue = getTaskQueue(task_op);
+                for (auto [i, other] : llvm::enumerate(queues[queue])) {
+                  if (*tasks[other].started < *tasks[index].started) {
+                    endLiveness(other, position);
+                  } else if (other == index) {
+                    completed[queue] =
+                        std::max<unsigned>(completed[queue], i + 1);
+                  }
+                }
+                return success();
+              })
+              .Case<DMAFreeTaskOp>([&](DMAFreeTaskOp op) {
+                if (failed(verifyTaskReference(op, op.getTask()))) {
+                  return failure();
+                }
+                endLiveness(taskIndex[op.getTaskOp()], position);
+                return success();
+              })
+              .Case<NpuSyncOp>([&](NpuSyncOp op) {
+                for (auto &[queue, started] : queues) {
+                  auto [col, row, direction, channel] = queue;
+                  if (col < (int)op.getColumn() ||
+                      col >= (int)(op.getColumn() + op.getColumnNum()) ||
+                      row < (int)op.getRow() ||
+                      row >= (int)(op.getRow() + op.getRowNum()) ||
+                      static_cast<uint32_t>(direction) != op.getDirection() ||
+                      channel != (int)op.getChannel()) {
+                    continue;
+                  }
+                  unsigned &done = completed[queue];
+                  if (done < started.size()) {
+                    endLiveness(started[done++], position);
+                  }
+                }
+                return success();
+              })
+              .Default([](Operation *op) { return success(); });
+      return failed(result) ? WalkResult::interrupt() : WalkResult::advance();
     });
-    if (result.wasInterrupted()) {
-      return failure();
-    }
+    return failure(result.wasInterrupted());
+  }
 
-    // Now, allocate BD IDs for all unspecified BDs
-    result =
-        op.walk<WalkOrder::PreOrder>([&](AIE::DMABDOp bd_op) {
-          if (bd_op.getBdId().has_value()) {
+  // Honors the user-specified BD IDs, which may only be reused by tasks whose
+  // liveness does not overlap.
+  LogicalResult assignSpecifiedBdIds(ArrayRef<unsigned> tileTasks) {
+    for (auto [i, index] : llvm::enumerate(tileTasks)) {
+      TaskLiveness &live = tasks[index];
+      WalkResult result =
+          live.task.walk<WalkOrder::PreOrder>([&](AIE::DMABDOp bd_op) {
+            if (!bd_op.getBdId().has_value()) {
+              return WalkResult::advance();
+            }
+            uint32_t bdId = bd_op.getBdId().value();
+            bool inUse = llvm::is_contained(live.bdIds, bdId) ||
+                         llvm::any_of(tileTasks.take_front(i), [&](unsigned o) {
+                           return tasks[o].overlaps(live) &&
+                                  llvm::is_contained(tasks[o].bdIds, bdId);
+                         });
+            if (inUse) {
+              live.task.emitOpError("Specified buffer descriptor ID ")
+                  << bdId
+                  << " is already in use. Emit an aiex.dma_free_task "
+                     "operation to reuse BDs.";
+              return WalkResult::interrupt();
+            }
+            live.bdIds.push_back(bdId);
             return WalkResult::advance();
-          }
-          // FIXME: use correct channelIndex here
-          std::optional<int32_t> next_id = gen.nextBdId(/*channelIndex=*/0);
-          if (!next_id) {
-            op.emitOpError()
-                << "Allocator exhausted available buffer descriptor IDs.";
-            return WalkResult::interrupt();
-          }
-          bd_op.setBdId(*next_id);
-          return WalkResult::advance();
-        });
-    if (result.wasInterrupted()) {
-      return failure();
+          });
+      if (result.wasInterrupted()) {
+        return failure();
+      }
     }
-
     return success();
   }
 
-  LogicalResult runOnFreeBDs(DMAFreeTaskOp op,
-                             std::map<AIE::TileOp, BdIdGenerator> &gens) {
-    DMAConfigureTaskOp task_op = op.getTaskOp();
-    if (!task_op) {
-      auto err = op.emitOpError(
-          "does not reference a valid configure_task operation.");
-      Operation *task_op = op.getTask().getDefiningOp();
-      if (llvm::isa<DMAStartBdChainOp>(task_op)) {
-        err.attachNote(task_op->getLoc())
-            << "Lower this operation first using the "
-               "--aie-materialize-bd-chains pass.";
-      }
-      if (llvm::isa<DMAConfigureTaskForOp>(task_op)) {
-        err.attachNote(task_op->getLoc())
-            << "Lower this operation first using the "
-               "--aie-substitute-shim-dma-allocations pass.";
+  // Allocates the remaining BD IDs by coloring the interval graph of task
+  // liveness: tasks are visited in order of their start and take the lowest
+  // ID not held by any task they overlap with, which needs no more IDs than
+  // the largest number of BDs live at once.
+  LogicalResult assignFreeBdIds(ArrayRef<unsigned> tileTasks,
+                                const AIETargetModel &targetModel) {
+    for (unsigned index : tileTasks) {
+      TaskLiveness &live = tasks[index];
+      AIE::TileOp tile = live.task.getTileOp();
+      BdIdGenerator gen(tile.getCol(), tile.getRow(), targetModel);
+      for (unsigned other : tileTasks) {
+        if (other != index && !tasks[other].overlaps(live)) {
+          continue;
+        }
+        for (uint32_t bdId : tasks[other].bdIds) {
+          if (!gen.bdIdAlreadyAssigned(bdId)) {
+            gen.assignBdId(bdId);
+          }
+        }
       }
-      return err;
-    }
 
-    AIE::TileOp tile = task_op.getTileOp();
-    BdIdGenerator &gen = getGeneratorForTile(tile, gens);
-
-    // First, honor all the hard-coded BD IDs
-    WalkResult result =
-        task_op.walk<WalkOrder::PreOrder>([&](AIE::DMABDOp bd_op) {
-          if (!bd_op.getBdId().has_value()) {
-            bd_op.emitOpError("Free called on BD chain with unassigned IDs.");
-            return WalkResult::interrupt();
-          }
-          if (!gen.bdIdAlreadyAssigned(bd_op.getBdId().value())) {
-            // Ignore double-frees.
+      WalkResult result =
+          live.task.walk<WalkOrder::PreOrder>([&](AIE::DMABDOp bd_op) {
+            if (bd_op.getBdId().has_value()) {
+              return WalkResult::advance();
+            }
+            std::optional<int32_t> next_id =
+                gen.nextBdId(live.task.getChannel());
+            if (!next_id) {
+              live.task.emitOpError()
+                  << "Allocator exhausted available buffer descriptor IDs.";
+              return WalkResult::interrupt();
+            }
+            bd_op.setBdId(*next_id);
+            live.bdIds.push_back(*next_id);
             return WalkResult::advance();
-          }
-          gen.freeBdId(bd_op.getBdId().value());
-          return WalkResult::advance();
-        });
-    if (result.wasInterrupted()) {
-      return failure();
+          });
+      if (result.wasInterrupted()) {
+        return failure();
+      }
     }
-
-    op.erase();
-
     return success();
   }
 
   void runOnOperation() override {
 
-    // This pass currently assigns BD IDs with a simple linear pass. IDs are
-    // assigned in sequence, and issuing an aiex.free_bds or aiex.await_bds op
-    // kills the correspondings IDs use. If in the future we support
-    // branching/jumping in the sequence function, a proper liveness analysis
-    // will become necessary here.
+    // This pass assigns BD IDs from the liveness of each configured task
+    // along the sequence. If in the future we support branching/jumping in
+    // the sequence function, the liveness will have to be computed over its
+    // control flow graph instead.
 
     AIE::DeviceOp device = getOperation();
-    std::map<AIE::TileOp, BdIdGenerator> gens;
-
-    // Insert a free_bds operation for each await_bds
-    // After waiting for BD IDs, they can definitely safely be reused
-    device.walk([&](DMAAwaitTaskOp op) {
-      OpBuilder builder(op);
-      builder.setInsertionPointAfter(op);
-      builder.create<DMAFreeTaskOp>(op.getLoc(), op.getTask());
-    });
+    const AIETargetModel &targetModel = device.getTargetModel();
+    tasks.clear();
+    taskIndex.clear();
+    queues.clear();
+    completed.clear();
 
     // TODO: Only walk the sequence function
-    device.walk([&](Operation *op) {
-      LogicalResult result =
-          llvm::TypeSwitch<Operation *, LogicalResult>(op)
-              .Case<DMAConfigureTaskOp>([&](DMAConfigureTaskOp op) {
-                return runOnConfigureBDs(op, gens);
-              })
-              .Case<DMAFreeTaskOp>(
-                  [&](DMAFreeTaskOp op) { return runOnFreeBDs(op, gens); })
-              .Default([](Operation *op) { return success(); });
-      if (failed(result)) {
+    if (failed(computeLiveness(device))) {
+      return signalPassFailure();
+    }
+
+    std::map<std::pair<int, int>, SmallVector<unsigned>> tileTasks;
+    for (auto [index, live] : llvm::enumerate(tasks)) {
+      AIE::TileOp tile = live.task.getTileOp();
+      tileTasks[{tile.getCol(), tile.getRow()}].push_back(index);
+    }
+    for (auto &[tile, indices] : tileTasks) {
+      if (failed(assignSpecifiedBdIds(indices)) ||
+          failed(assignFreeBdIds(indices, targetModel))) {
         return signalPassFailure();
       }
-    });
+    }
+
+    // The BD IDs have been assigned; the free operations have served their
+    // purpose.
+    device.walk([&](DMAFreeTaskOp op) { op.erase(); });
   }
 };
 
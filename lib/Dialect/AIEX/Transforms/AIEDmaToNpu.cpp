@@ -22,6 +22,53 @@ using namespace xilinx::AIEX;
 
 namespace {
 
+// The BD fields that can be given by runtime parameters.
+enum class BdField {
+  BufferLength,
+  D0Size,
+  D1Size,
+  D1Stride,
+  D2Stride,
+  IterationStride
+};
+
+struct BdFieldLayout {
+  uint32_t word;
+  uint32_t shift;
+  uint32_t width;
+};
+
+// Returns where WriteBdToBlockWritePattern places a field in the words of a
+// shim tile BD. npu.dma_memcpy_nd only programs shim tile BDs, so only their
+// layout is needed.
+BdFieldLayout getBdFieldLayout(BdField field) {
+  switch (field) {
+  case BdField::BufferLength:
+    return {0, 0, 32};
+  case BdField::D0Size:
+    return {3, 20, 10};
+  case BdField::D1Size:
+    return {4, 20, 10};
+  case BdField::D1Stride:
+    return {4, 0, 20};
+  case BdField::D2Stride:
+    return {5, 0, 20};
+  case BdField::IterationStride:
+    return {6, 0, 20};
+  }
+  llvm_unreachable("unknown BD field");
+}
+
+// A BD field given by the runtime sequence argument `argIdx`, as
+// argIdx * mul / div + add.
+struct BdFieldPatch {
+  BdField field;
+  unsigned argIdx;
+  int32_t mul;
+  int32_t div;
+  int32_t add;
+};
+
 struct Write32SymToAddr : OpConversionPattern<NpuWrite32Op> {
   using OpConversionPattern::OpConversionPattern;
 
@@ -294,12 +341,9 @@ public:
 
     auto issue_token = BoolAttr::get(ctx, false);
     auto repeat_count = zero;
-    llvm::SmallVector<int64_t, 4> inputSizes = llvm::map_to_vector(
-        llvm::reverse(op.getMixedSizes()),
-        [](OpFoldResult s) { return getConstantIntValue(s).value(); });
-    llvm::SmallVector<int64_t, 4> inputStrides = llvm::map_to_vector(
-        llvm::reverse(op.getMixedStrides()),
-        [](OpFoldResult s) { return getConstantIntValue(s).value(); });
+    llvm::SmallVector<int64_t, 4> inputSizes;
+    llvm::SmallVector<int64_t, 4> inputStrides;
+    op.getTemplateSizesAndStrides(inputSizes, inputStrides);
     llvm::SmallVector<int64_t, 4> sizes(4);
     llvm::SmallVector<int64_t, 4> strides(4);
     getHardwareStridesWraps(targetModel, bufferType, inputSizes, inputStrides,
@@ -440,6 +484,53 @@ public:
     if (!isMM2S)
       issue_token = BoolAttr::get(ctx, true);
 
+    // The fields given by runtime parameters are left zero and patched by the
+    // host, see npu.field_patch.
+    SmallVector<BdFieldPatch> fieldPatches;
+    auto sizeParams = op.getSizeParameters();
+    auto strideParams = op.getStrideParameters();
+    int32_t elemWidth = bufferType.getElementTypeBitWidth();
+    int32_t granularity = targetModel.getAddressGenGranularity();
+    for (int i = 0; i < 3; i++) {
+      if (!sizeParams[i])
+        continue;
+      int32_t mul = elemWidth;
+      for (int j = 0; j < 3; j++)
+        if (j != i)
+          mul *= inputSizes[j];
+      buffer_length = zero;
+      fieldPatches.push_back(
+          {BdField::BufferLength, *sizeParams[i], mul, granularity, 0});
+      if (skipTransformationChecks)
+        continue;
+      if (i == 0) {
+        d0_size = zero;
+        fieldPatches.push_back(
+            {BdField::D0Size, *sizeParams[i], elemWidth, granularity, 0});
+      } else if (i == 1) {
+        d1_size = zero;
+        fieldPatches.push_back({BdField::D1Size, *sizeParams[i], 1, 1, 0});
+      }
+    }
+    for (int i = 1; i < 4; i++) {
+      // A stride is only programmed if its dimension is used. The iteration
+      // stride is programmed for linear transfers too.
+      if (!strideParams[i] || inputSizes[i] <= 1 ||
+          (i < 3 && skipTransformationChecks))
+        continue;
+      BdField field = i == 1   ? BdField::D1Stride
+                      : i == 2 ? BdField::D2Stride
+                               : BdField::IterationStride;
+      if (i == 1)
+        d1_stride = zero;
+      else if (i == 2)
+        d2_stride = zero;
+      else
+        iteration_stride = zero;
+      fieldPatches.push_back(
+          {field, *strideParams[i], elemWidth, granularity, -1});
+    }
+
     if (targetModel.isMemTile(col, 0) && (!isMM2S) &&
         (op.getD0ZeroBefore() != 0 || op.getD0ZeroAfter() != 0 ||
          op.getD1ZeroBefore() != 0 || op.getD1ZeroAfter() != 0 ||
@@ -460,6 +551,15 @@ public:
 
     rewriter.create<NpuAddressPatchOp>(op->getLoc(), addr, arg_idx, offset);
 
+    // the address register is the second word of the BD
+    uint64_t bdAddr = addr - sizeof(uint32_t);
+    for (const BdFieldPatch &patch : fieldPatches) {
+      BdFieldLayout layout = getBdFieldLayout(patch.field);
+      rewriter.create<NpuFieldPatchOp>(
+          op->getLoc(), bdAddr + layout.word * sizeof(uint32_t), patch.argIdx,
+          layout.shift, layout.width, patch.mul, patch.div, patch.add);
+    }
+
     rewriter.create<NpuPushQueueOp>(
         op->getLoc(), column, row, infoOp->getChannelDirAttr(),
         infoOp->getChannelIndexAttr(), issue_token, repeat_count, bd_id);
@@ -0,0 +1,317 @@
+//===- AIENpuPeephole.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "aie-npu-peephole"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+namespace {
+
+// The registers written by a write32, maskwrite32 or blockwrite, as full
+// array addresses.
+struct RegisterWrite {
+  uint32_t address;
+  uint32_t numWords;
+  // bits written, for maskwrite32
+  uint32_t mask = 0xFFFFFFFF;
+};
+
+// Returns true if the register at the given address only holds state, so
+// that writing it has no effect besides setting its value: buffer descriptor
+// words and stream switch configuration. Every other register (DMA channel
+// control and task queues, locks, event generation, timers, core control,
+// ...) may act on the array when written, so it orders the writes around it.
+bool isPlainStateRegister(uint32_t address, const AIE::AIETargetModel &tm) {
+  uint32_t col = address >> tm.getColumnShift();
+  uint32_t row = (address >> tm.getRowShift()) &
+                 ((1u << (tm.getColumnShift() - tm.getRowShift())) - 1);
+  uint32_t offset = address & ((1u << tm.getRowShift()) - 1);
+  if (col < static_cast<uint32_t>(tm.columns()) &&
+      row < static_cast<uint32_t>(tm.rows()) && tm.isMemTile(col, row))
+    // memtile buffer descriptors and stream switch configuration
+    return (offset >= 0xA0000 && offset < 0xA0600) ||
+           (offset >= 0xB0000 && offset < 0xB0400);
+  // shim tile and compute tile buffer descriptors and stream switch
+  // configuration
+  return (offset >= 0x1D000 && offset < 0x1D200) ||
+         (offset >= 0x3F000 && offset < 0x3F400);
+}
+
+template <typename OpTy>
+std::optional<uint32_t> getArrayAddress(OpTy op,
+                                        const AIE::AIETargetModel &tm) {
+  if (op.getBuffer())
+    return std::nullopt;
+  uint32_t address = op.getAddress();
+  auto col = op.getColumn();
+  auto row = op.getRow();
+  if (col && row)
+    address = ((*col & 0xff) << tm.getColumnShift()) |
+              ((*row & 0xff) << tm.getRowShift()) | (address & 0xFFFFF);
+  return address;
+}
+
+// Returns the words written by a blockwrite, if they are known.
+std::optional<SmallVector<uint32_t>> getBlockWriteData(NpuBlockWriteOp op) {
+  auto getGlobal = op.getData().getDefiningOp<memref::GetGlobalOp>();
+  if (!getGlobal)
+    return std::nullopt;
+  auto global = dyn_cast_if_present<memref::GlobalOp>(
+      op->getParentOfType<AIE::DeviceOp>().lookupSymbol(getGlobal.getName()));
+  if (!global || !global.getInitialValue())
+    return std::nullopt;
+  auto data = dyn_cast<DenseIntElementsAttr>(*global.getInitialValue());
+  if (!data || data.getElementType().getIntOrFloatBitWidth() != 32)
+    return std::nullopt;
+  SmallVector<uint32_t> words;
+  for (auto d : data)
+    words.push_back(d.getZExtValue());
+  return words;
+}
+
+// Returns the registers written by the given operation, or std::nullopt if it
+// is not a write this pass can reason about. Such operations (syncs, address
+// patches, writes relative to a buffer, writes to registers that are not
+// plain state, ...)
+// are barriers that no write is moved, merged or removed across.
+std::optional<RegisterWrite> getRegisterWrite(Operation *op,
+                                              const AIE::AIETargetModel &tm) {
+  std::optional<RegisterWrite> write =
+      llvm::TypeSwitch<Operation *, std::optional<RegisterWrite>>(op)
+          .Case<NpuWrite32Op>(
+              [&](auto op) -> std::optional<RegisterWrite> {
+                if (auto address = getArrayAddress(op, tm))
+                  return RegisterWrite{*address, 1};
+                return std::nullopt;
+              })
+          .Case<NpuMaskWrite32Op>(
+              [&](auto op) -> std::optional<RegisterWrite> {
+                if (auto address = getArrayAddress(op, tm))
+                  return RegisterWrite{*address, 1, op.getMask()};
+                return std::nullopt;
+              })
+          .Case<NpuBlockWriteOp>(
+              [&](auto op) -> std::optional<RegisterWrite> {
+                auto address = getArrayAddress(op, tm);
+                auto data = getBlockWriteData(op);
+                if (address && data)
+                  return RegisterWrite{
+                      *address, static_cast<uint32_t>(data->size())};
+                return std::nullopt;
+              })
+          .Default([](Operation *) { return std::nullopt; });
+  if (!write)
+    return std::nullopt;
+  for (uint32_t i = 0; i < write->numWords; i++)
+    if (!isPlainStateRegister(write->address + i * sizeof(uint32_t), tm))
+      return std::nullopt;
+  return write;
+}
+
+// Operations such as constants and memref.get_global that do not touch the
+// array and so do not separate the writes around them.
+bool isTransparent(Operation &op) { return isMemoryEffectFree(&op); }
+
+struct AIENpuPeepholePass : AIENpuPeepholeBase<AIENpuPeepholePass> {
+
+  // Remove the writes whose registers are all fully written again before the
+  // next barrier.
+  void removeDeadWrites(Block &block, const AIE::AIETargetModel &tm) {
+    llvm::DenseSet<uint32_t> overwritten;
+    for (Operation &op : llvm::make_early_inc_range(llvm::reverse(block))) {
+      if (isTransparent(op))
+        continue;
+      auto write = getRegisterWrite(&op, tm);
+      if (!write) {
+        overwritten.clear();
+        continue;
+      }
+      bool dead = true;
+      for (uint32_t i = 0; i < write->numWords; i++)
+        dead &= overwritten.contains(write->address + i * sizeof(uint32_t));
+      if (dead) {
+        LLVM_DEBUG(llvm::dbgs() << "removing dead write " << op << "\n");
+        op.erase();
+        continue;
+      }
+      if (write->mask == 0xFFFFFFFF)
+        for (uint32_t i = 0; i < write->numWords; i++)
+          overwritten.insert(write->address + i * sizeof(uint32_t));
+    }
+  }
+
+  // Fold each maskwrite32 into the write32 or maskwrite32 to the same
+  // register right before it.
+  void foldMaskWrites(Block &block, const AIE::AIETargetModel &tm) {
+    Operation *prev = nullptr;
+    std::optional<RegisterWrite> prevWrite;
+    for (Operation &op : llvm::make_early_inc_range(block)) {
+      if (isTransparent(op))
+        continue;
+      auto write = getRegisterWrite(&op, tm);
+      auto maskWrite = dyn_cast<NpuMaskWrite32Op>(op);
+      if (!maskWrite || !write || !prevWrite || prevWrite->numWords != 1 ||
+          prevWrite->address != write->address ||
+          isa<NpuBlockWriteOp>(prev)) {
+        prev = &op;
+        prevWrite = write;
+        continue;
+      }
+
+      OpBuilder builder(prev);
+      uint32_t mask = maskWrite.getMask();
+      if (auto prevWrite32 = dyn_cast<NpuWrite32Op>(prev)) {
+        uint32_t value = (prevWrite32.getValue() & ~mask) |
+                         (maskWrite.getValue() & mask);
+        prevWrite32.setValueAttr(builder.getUI32IntegerAttr(value));
+      } else {
+        auto prevMaskWrite = cast<NpuMaskWrite32Op>(prev);
+        uint32_t prevMask = prevMaskWrite.getMask();
+        uint32_t value = (prevMaskWrite.getValue() & prevMask & ~mask) |
+                         (maskWrite.getValue() & mask);
+        if ((prevMask | mask) == 0xFFFFFFFF) {
+          prev = builder.create<NpuWrite32Op>(
+              prevMaskWrite.getLoc(), prevMaskWrite.getAddress(), value,
+              nullptr, prevMaskWrite.getColumnAttr(),
+              prevMaskWrite.getRowAttr());
+          prevMaskWrite.erase();
+          prevWrite->mask = 0xFFFFFFFF;
+        } else {
+          prevMaskWrite.setValueAttr(builder.getUI32IntegerAttr(value));
+          prevMaskWrite.setMaskAttr(
+              builder.getUI32IntegerAttr(prevMask | mask));
+          prevWrite->mask = prevMask | mask;
+        }
+      }
+      LLVM_DEBUG(llvm::dbgs() << "folded mask write into " << *prev << "\n");
+      maskWrite.erase();
+    }
+  }
+
+  // Returns a constant global holding the given words, reusing an existing
+  // one with the same contents.
+  memref::GlobalOp getOrCreateDataGlobal(OpBuilder &builder,
+                                         AIE::DeviceOp device,
+                                         RuntimeSequenceOp sequence,
+                                         ArrayRef<uint32_t> words) {
+    MemRefType memrefType =
+        MemRefType::get({static_cast<int64_t>(words.size())},
+                        builder.getI32Type());
+    TensorType tensorType = RankedTensorType::get(
+        {static_cast<int64_t>(words.size())}, builder.getI32Type());
+    auto initVal = DenseElementsAttr::get<uint32_t>(tensorType, words);
+    for (auto global : device.getOps<memref::GlobalOp>())
+      if (global.getType() == memrefType && global.getInitialValue() &&
+          *global.getInitialValue() == initVal)
+        return global;
+
+    OpBuilder::InsertionGuard guard(builder);
+    builder.setInsertionPoint(sequence);
+    std::string name = "blockwrite_data_";
+    int id = 0;
+    while (device.lookupSymbol(name + std::to_string(id)))
+      id++;
+    return builder.create<memref::GlobalOp>(
+        sequence.getLoc(), name + std::to_string(id),
+        builder.getStringAttr("private"), memrefType, initVal, true, nullptr);
+  }
+
+  // Replace each run of write32s to consecutive registers by one blockwrite.
+  void coalesceWrites(Block &block, const AIE::AIETargetModel &tm,
+                      AIE::DeviceOp device, RuntimeSequenceOp sequence) {
+    SmallVector<NpuWrite32Op> run;
+    uint32_t runAddress = 0;
+    auto flush = [&]() {
+      if (run.size() >= 2) {
+        SmallVector<uint32_t> words;
+        for (auto write : run)
+          words.push_back(write.getValue());
+        OpBuilder builder(run.front());
+        auto global = getOrCreateDataGlobal(builder, device, sequence, words);
+        auto data = builder.create<memref::GetGlobalOp>(
+            run.front().getLoc(), global.getType(), global.getName());
+        builder.create<NpuBlockWriteOp>(
+            run.front().getLoc(), builder.getUI32IntegerAttr(runAddress),
+            data.getResult(), nullptr, nullptr, nullptr);
+        LLVM_DEBUG(llvm::dbgs() << "coalesced " << run.size()
+                                << " writes into a blockwrite\n");
+        for (auto write : run)
+          write.erase();
+      }
+      run.clear();
+    };
+    for (Operation &op : llvm::make_early_inc_range(block)) {
+      if (isTransparent(op))
+        continue;
+      auto write32 = dyn_cast<NpuWrite32Op>(op);
+      auto write = getRegisterWrite(&op, tm);
+      if (!write32 || !write) {
+        flush();
+        continue;
+      }
+      if (!run.empty() &&
+          write->address != runAddress + run.size() * sizeof(uint32_t))
+        flush();
+      if (run.empty())
+        runAddress = write->address;
+      run.push_back(write32);
+    }
+    flush();
+  }
+
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    const AIE::AIETargetModel &tm = device.getTargetModel();
+
+    llvm::SmallSet<StringRef, 4> dataGlobals;
+    for (auto sequence : device.getOps<RuntimeSequenceOp>()) {
+      Block &block = sequence.getBody().front();
+      removeDeadWrites(block, tm);
+      foldMaskWrites(block, tm);
+      coalesceWrites(block, tm, device, sequence);
+
+      // Drop the data of the blockwrites that were removed.
+      for (auto getGlobal : llvm::make_early_inc_range(
+               block.getOps<memref::GetGlobalOp>())) {
+        if (getGlobal->use_empty()) {
+          dataGlobals.insert(getGlobal.getName());
+          getGlobal.erase();
+        }
+      }
+    }
+    for (StringRef name : dataGlobals) {
+      auto global = device.lookupSymbol<memref::GlobalOp>(name);
+      if (global && global.isPrivate() &&
+          SymbolTable::symbolKnownUseEmpty(global, device))
+        global.erase();
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+AIEX::createAIENpuPeepholePass() {
+  return std::make_unique<AIENpuPeepholePass>();
+}
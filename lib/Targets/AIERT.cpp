@@ -12,6 +12,7 @@
 #include "aie/Targets/AIETargetShared.h"
 
 #include "mlir/Support/LogicalResult.h"
+#include "llvm/BinaryFormat/ELF.h"
 
 extern "C" {
 #include "xaiengine/xaie_core.h"
@@ -27,6 +28,7 @@ extern "C" {
 #include "xaiengine/xaiegbl_defs.h"
 }
 
+#include <cstring>
 #include <filesystem>
 
 using namespace mlir;
@@ -673,18 +675,95 @@ LogicalResult AIERTControl::addCoreEnable(DeviceOp &targetOp) {
   return success();
 }
 
+// Returns the size of the executable segments of an ELF, which are the ones
+// loaded into program memory.
+static uint64_t getProgramBytes(const llvm::MemoryBuffer &image) {
+  using namespace llvm::ELF;
+  StringRef data = image.getBuffer();
+  Elf32_Ehdr header;
+  if (data.size() < sizeof(header))
+    return 0;
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (!header.checkMagic() || header.getFileClass() != ELFCLASS32)
+    return 0;
+  uint64_t bytes = 0;
+  for (unsigned i = 0; i < header.e_phnum; i++) {
+    uint64_t offset = header.e_phoff + (uint64_t)i * header.e_phentsize;
+    Elf32_Phdr segment;
+    if (offset + sizeof(segment) > data.size())
+      break;
+    std::memcpy(&segment, data.data() + offset, sizeof(segment));
+    if (segment.p_type == PT_LOAD && (segment.p_flags & PF_X))
+      bytes += segment.p_filesz;
+  }
+  return bytes;
+}
+
+ElfLoadStats &ElfLoadStats::operator+=(const ElfLoadStats &other) {
+  cores += other.cores;
+  images += other.images;
+  programBytes += other.programBytes;
+  imageProgramBytes += other.imageProgramBytes;
+  return *this;
+}
+
+void ElfLoadStats::print(llvm::raw_ostream &os) const {
+  os << "cores: " << cores << ", distinct ELF images: " << images
+     << ", program bytes written: " << programBytes << " ("
+     << imageProgramBytes << " in distinct images)\n";
+}
+
+const llvm::MemoryBuffer *AIERTControl::getElfImage(StringRef elfPath) {
+  auto it = imagesByPath.find(elfPath);
+  if (it != imagesByPath.end())
+    return it->second;
+
+  auto file = llvm::MemoryBuffer::getFile(elfPath, /*IsText=*/false,
+                                          /*RequiresNullTerminator=*/false);
+  if (!file) {
+    llvm::errs() << "cannot read " << elfPath << ": "
+                 << file.getError().message() << "\n";
+    return nullptr;
+  }
+  const llvm::MemoryBuffer *&image = imagesByContents[(*file)->getBuffer()];
+  if (!image) {
+    image = file->get();
+    elfImages.push_back(std::move(*file));
+    elfStats.images++;
+    elfStats.imageProgramBytes += getProgramBytes(*image);
+  }
+  imagesByPath[elfPath] = image;
+  return image;
+}
+
 LogicalResult AIERTControl::addAieElf(uint8_t col, uint8_t row,
-                                      const StringRef elfPath, bool aieSim) {
+                                      const StringRef elfPath, bool aieSim,
+                                      bool loadElfFromPath) {
+  const llvm::MemoryBuffer *image = getElfImage(elfPath);
+  if (!image)
+    return failure();
+  elfStats.cores++;
+  elfStats.programBytes += getProgramBytes(*image);
+
   TRY_XAIE_API_LOGICAL_RESULT(XAie_CoreDisable, &devInst,
                               XAie_TileLoc(col, row));
   TRY_XAIE_API_LOGICAL_RESULT(XAie_DmaChannelResetAll, &devInst,
                               XAie_TileLoc(col, row),
                               XAie_DmaChReset::DMA_CHANNEL_RESET);
 
+  // Cores running the same kernel load it from the one image that was read,
+  // which saves reading the file again but not any of the writes.
   // loadSym: Load symbols from .map file. This argument is not used when
-  // __AIESIM__ is not defined.
-  TRY_XAIE_API_LOGICAL_RESULT(XAie_LoadElf, &devInst, XAie_TileLoc(col, row),
-                              elfPath.str().c_str(), /*loadSym*/ aieSim);
+  // __AIESIM__ is not defined, and needs the path of the ELF when it is.
+  if (aieSim || loadElfFromPath) {
+    TRY_XAIE_API_LOGICAL_RESULT(XAie_LoadElf, &devInst, XAie_TileLoc(col, row),
+                                elfPath.str().c_str(), /*loadSym*/ aieSim);
+  } else {
+    auto *elfMem =
+        reinterpret_cast<const unsigned char *>(image->getBufferStart());
+    TRY_XAIE_API_LOGICAL_RESULT(XAie_LoadElfMem, &devInst,
+                                XAie_TileLoc(col, row), elfMem);
+  }
 
   TRY_XAIE_API_LOGICAL_RESULT(XAie_DmaChannelResetAll, &devInst,
                               XAie_TileLoc(col, row),
@@ -693,8 +772,21 @@ LogicalResult AIERTControl::addAieElf(uint8_t col, uint8_t row,
   return success();
 }
 
+std::string getCoreElfPath(CoreOp coreOp, StringRef elfDir) {
+  std::string fileName;
+  if (auto fileAttr = coreOp.getElfFile())
+    fileName = fileAttr->str();
+  else
+    fileName = (llvm::Twine("core_") + std::to_string(coreOp.colIndex()) + "_" +
+                std::to_string(coreOp.rowIndex()) + ".elf")
+                   .str();
+  auto ps = std::filesystem::path::preferred_separator;
+  return (llvm::Twine(elfDir) + std::string(1, ps) + fileName).str();
+}
+
 LogicalResult AIERTControl::addAieElfs(DeviceOp &targetOp,
-                                       const StringRef elfPath, bool aieSim) {
+                                       const StringRef elfPath, bool aieSim,
+                                       bool loadElfFromPath) {
   for (auto tileOp : targetOp.getOps<TileOp>())
     if (tileOp.isShimNOCorPLTile()) {
       // Resets no needed with V2 kernel driver
@@ -702,18 +794,8 @@ LogicalResult AIERTControl::addAieElfs(DeviceOp &targetOp,
       int col = tileOp.colIndex();
       int row = tileOp.rowIndex();
       if (auto coreOp = tileOp.getCoreOp()) {
-        std::string fileName;
-        if (auto fileAttr = coreOp.getElfFile())
-          fileName = fileAttr->str();
-        else
-          fileName = (llvm::Twine("core_") + std::to_string(col) + "_" +
-                      std::to_string(row) + ".elf")
-                         .str();
-        auto ps = std::filesystem::path::preferred_separator;
-        if (failed(addAieElf(
-                col, row,
-                (llvm::Twine(elfPath) + std::string(1, ps) + fileName).str(),
-                aieSim)))
+        if (failed(addAieElf(col, row, getCoreElfPath(coreOp, elfPath),
+                             aieSim, loadElfFromPath)))
           return failure();
       }
     }
@@ -18,6 +18,7 @@ extern "C" {
 #include "mlir/IR/Block.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
 
@@ -30,7 +31,9 @@ extern "C" {
 #include <cassert>
 #include <filesystem>
 #include <functional>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifndef NDEBUG
@@ -73,99 +76,238 @@ generateCDOBinary(const StringRef outputPath,
   return success();
 }
 
-static LogicalResult generateCDOBinariesSeparately(AIERTControl &ctl,
-                                                   const StringRef workDirPath,
-                                                   DeviceOp &targetOp,
-                                                   bool aieSim,
-                                                   bool enableCores) {
+namespace {
+
+// A CDO file of one device and the configuration it holds.
+struct CDOFile {
+  std::string path;
+  DeviceOp targetOp;
+  std::function<LogicalResult(AIERTControl &)> generate;
+  // The configuration recorded as a libxaie transaction, when the file is
+  // generated concurrently with others.
+  XAie_TxnInst *txn = nullptr;
+  uint64_t baseAddr = 0;
+  ElfLoadStats elfStats;
+};
+
+} // namespace
+
+static void addCDOFilesSeparately(SmallVectorImpl<CDOFile> &files,
+                                  const StringRef outputDir, DeviceOp targetOp,
+                                  bool aieSim, bool enableCores,
+                                  bool loadElfFromPath) {
   auto ps = std::filesystem::path::preferred_separator;
+  std::string elfDir = outputDir.str();
 
-  LLVM_DEBUG(llvm::dbgs() << "Generating aie_cdo_elfs.bin");
-  if (failed(generateCDOBinary(
-          (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo_elfs.bin")
-              .str(),
-          [&ctl, &targetOp, &workDirPath, &aieSim] {
-            return ctl.addAieElfs(targetOp, workDirPath, aieSim);
-          })))
-    return failure();
+  files.push_back(
+      {(llvm::Twine(outputDir) + std::string(1, ps) + "aie_cdo_elfs.bin").str(),
+       targetOp,
+       [targetOp, elfDir, aieSim, loadElfFromPath](AIERTControl &ctl) mutable {
+         return ctl.addAieElfs(targetOp, elfDir, aieSim, loadElfFromPath);
+       }});
 
-  LLVM_DEBUG(llvm::dbgs() << "Generating aie_cdo_init.bin");
-  if (failed(generateCDOBinary(
-          (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo_init.bin")
-              .str(),
-          [&ctl, &targetOp] { return ctl.addInitConfig(targetOp); })))
-    return failure();
+  files.push_back(
+      {(llvm::Twine(outputDir) + std::string(1, ps) + "aie_cdo_init.bin").str(),
+       targetOp, [targetOp](AIERTControl &ctl) mutable {
+         return ctl.addInitConfig(targetOp);
+       }});
 
-  LLVM_DEBUG(llvm::dbgs() << "Generating aie_cdo_enable.bin");
-  if (enableCores &&
-      failed(generateCDOBinary(
-          (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo_enable.bin")
-              .str(),
-          [&ctl, &targetOp] { return ctl.addCoreEnable(targetOp); })))
-    return failure();
+  if (enableCores)
+    files.push_back({(llvm::Twine(outputDir) + std::string(1, ps) +
+                      "aie_cdo_enable.bin")
+                         .str(),
+                     targetOp, [targetOp](AIERTControl &ctl) mutable {
+                       return ctl.addCoreEnable(targetOp);
+                     }});
+}
+
+static void addCDOFileUnified(SmallVectorImpl<CDOFile> &files,
+                              const StringRef outputDir, DeviceOp targetOp,
+                              bool aieSim, bool enableCores,
+                              bool loadElfFromPath) {
+  auto ps = std::filesystem::path::preferred_separator;
+  std::string elfDir = outputDir.str();
+
+  files.push_back(
+      {(llvm::Twine(outputDir) + std::string(1, ps) + "aie_cdo.bin").str(),
+       targetOp,
+       [targetOp, elfDir, aieSim, enableCores,
+        loadElfFromPath](AIERTControl &ctl) mutable {
+         if (!targetOp.getOps<CoreOp>().empty() &&
+             failed(ctl.addAieElfs(targetOp, elfDir, aieSim, loadElfFromPath)))
+           return failure();
+         if (failed(ctl.addInitConfig(targetOp)))
+           return failure();
+         if (enableCores && !targetOp.getOps<CoreOp>().empty() &&
+             failed(ctl.addCoreEnable(targetOp)))
+           return failure();
+         return success();
+       }});
+}
+
+static const BaseNPUTargetModel &getNPUTargetModel(DeviceOp targetOp) {
+  return (const BaseNPUTargetModel &)targetOp.getTargetModel();
+}
 
+// Writes the configuration recorded in a transaction to the current CDO file
+// stream, as the CDO IO backend of libxaie would have.
+static LogicalResult writeTransaction(const CDOFile &file) {
+  for (uint32_t i = 0; i < file.txn->NumCmds; i++) {
+    const XAie_TxnCmd &cmd = file.txn->CmdBuf[i];
+    uint64_t address = file.baseAddr + cmd.RegOff;
+    switch (cmd.Opcode) {
+    case XAie_TxnOpcode::XAIE_IO_WRITE:
+      cdo_Write32(address, cmd.Value);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_MASKWRITE:
+      cdo_MaskWrite32(address, cmd.Mask, cmd.Value);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_BLOCKWRITE:
+      cdo_BlockWrite32(address, reinterpret_cast<uint32_t *>(cmd.DataPtr),
+                       cmd.Size);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_BLOCKSET:
+      cdo_BlockSet32(address, cmd.Value, cmd.Size);
+      break;
+    default:
+      return file.targetOp.emitOpError("cannot write ")
+             << AIETXNOPCODETOSTR.at(cmd.Opcode) << " to " << file.path;
+    }
+  }
   return success();
 }
 
-static LogicalResult generateCDOUnified(AIERTControl &ctl,
-                                        const StringRef workDirPath,
-                                        DeviceOp &targetOp, bool aieSim,
-                                        bool enableCores) {
-  auto ps = std::filesystem::path::preferred_separator;
+// Generates the CDO files one after the other through the CDO IO backend of
+// libxaie, which writes to the single global stream of the CDO driver.
+static LogicalResult generateCDOFilesSerially(MutableArrayRef<CDOFile> files,
+                                              bool aieSim, bool xaieDebug) {
+  std::optional<AIERTControl> ctl;
+  DeviceOp currentOp;
+  for (CDOFile &file : files) {
+    // The files of a device share the libxaie device instance.
+    if (file.targetOp != currentOp) {
+      currentOp = file.targetOp;
+      ctl.emplace(getNPUTargetModel(currentOp));
+      if (failed(ctl->setIOBackend(aieSim, xaieDebug)))
+        return failure();
+    }
+    LLVM_DEBUG(llvm::dbgs() << "Generating " << file.path << "\n");
+    if (failed(generateCDOBinary(file.path,
+                                 [&] { return file.generate(*ctl); })))
+      return failure();
+    file.elfStats = std::exchange(ctl->elfStats, ElfLoadStats());
+  }
+  return success();
+}
 
-  return generateCDOBinary(
-      (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo.bin").str(),
-      [&ctl, &targetOp, &workDirPath, &aieSim, &enableCores] {
-        if (!targetOp.getOps<CoreOp>().empty() &&
-            failed(ctl.addAieElfs(targetOp, workDirPath, aieSim)))
-          return failure();
-        if (failed(ctl.addInitConfig(targetOp)))
+// Generates the CDO files concurrently. Each file is recorded as a libxaie
+// transaction with its own device instance, which is where the time goes, and
+// only writing the recorded transactions to the files goes through the
+// global stream of the CDO driver, one file after the other.
+static LogicalResult
+generateCDOFilesConcurrently(MLIRContext *ctx, MutableArrayRef<CDOFile> files) {
+  LogicalResult result =
+      failableParallelForEach(ctx, files, [](CDOFile &file) {
+        AIERTControl ctl(getNPUTargetModel(file.targetOp));
+        if (failed(ctl.setIOBackend(/*aieSim=*/false, /*xaieDebug=*/false)))
           return failure();
-        if (enableCores && !targetOp.getOps<CoreOp>().empty() &&
-            failed(ctl.addCoreEnable(targetOp)))
+        ctl.startTransaction();
+        if (failed(file.generate(ctl)))
           return failure();
-        return success();
+        file.txn = XAie_ExportTransactionInstance(&ctl.devInst);
+        file.baseAddr = ctl.devInst.BaseAddr;
+        file.elfStats = ctl.elfStats;
+        return success(file.txn != nullptr);
       });
+
+  for (const CDOFile &file : files) {
+    if (failed(result) || !file.txn)
+      break;
+    LLVM_DEBUG(llvm::dbgs() << "Generating " << file.path << "\n");
+    if (failed(generateCDOBinary(file.path,
+                                 [&] { return writeTransaction(file); })))
+      result = failure();
+  }
+
+  for (CDOFile &file : files)
+    if (file.txn)
+      XAie_FreeTransactionInstance(file.txn);
+  return result;
+}
+
+// Prints the ELFs loaded into the cores of each device.
+static void printElfReport(ArrayRef<DeviceOp> devOps, ArrayRef<CDOFile> files,
+                           llvm::raw_ostream &os) {
+  for (auto [index, targetOp] : llvm::enumerate(devOps)) {
+    ElfLoadStats stats;
+    for (const CDOFile &file : files)
+      if (file.targetOp == targetOp)
+        stats += file.elfStats;
+    os << "device " << index << ": ";
+    stats.print(os);
+  }
 }
 
 static LogicalResult
 translateToCDODirect(ModuleOp m, llvm::StringRef workDirPath,
                      byte_ordering endianness, bool emitUnified, bool cdoDebug,
-                     bool aieSim, bool xaieDebug, bool enableCores) {
-
-  auto devOps = m.getOps<DeviceOp>();
-  assert(llvm::range_size(devOps) == 1 &&
-         "only exactly 1 device op supported.");
-  DeviceOp targetOp = *devOps.begin();
-  const BaseNPUTargetModel &targetModel =
-      (const BaseNPUTargetModel &)targetOp.getTargetModel();
-
-  // things like XAIE_MEM_TILE_ROW_START and the missing
-  // shim dma on tile (0,0) are hard-coded assumptions about NPU...
-  assert(targetModel.hasProperty(AIETargetModel::IsNPU) &&
-         "Only NPU currently supported");
-
-  AIERTControl ctl(targetModel);
-  if (failed(ctl.setIOBackend(aieSim, xaieDebug)))
-    return failure();
-  initializeCDOGenerator(endianness, cdoDebug);
+                     bool aieSim, bool xaieDebug, bool enableCores,
+                     llvm::raw_ostream *elfReport, bool loadElfFromPath) {
+
+  auto devOps = llvm::to_vector(m.getOps<DeviceOp>());
+  if (devOps.empty())
+    return m.emitOpError("has no device to generate CDO files for");
+
+  // With several devices, the ELFs and CDO files of each device are in the
+  // subdirectory device_<index> of the work directory.
+  auto ps = std::filesystem::path::preferred_separator;
+  SmallVector<CDOFile> files;
+  for (auto [index, targetOp] : llvm::enumerate(devOps)) {
+    // things like XAIE_MEM_TILE_ROW_START and the missing
+    // shim dma on tile (0,0) are hard-coded assumptions about NPU...
+    if (!targetOp.getTargetModel().hasProperty(AIETargetModel::IsNPU))
+      return targetOp.emitOpError("Only NPU currently supported");
 
-  auto result = [&]() {
-    if (emitUnified) {
-      return generateCDOUnified(ctl, workDirPath, targetOp, aieSim,
-                                enableCores);
+    std::string outputDir = workDirPath.str();
+    if (devOps.size() > 1) {
+      outputDir = (llvm::Twine(workDirPath) + std::string(1, ps) + "device_" +
+                   llvm::Twine(index))
+                      .str();
+      std::error_code ec;
+      std::filesystem::create_directories(outputDir, ec);
+      if (ec)
+        return targetOp.emitOpError("cannot create ")
+               << outputDir << ": " << ec.message();
     }
-    return generateCDOBinariesSeparately(ctl, workDirPath, targetOp, aieSim,
-                                         enableCores);
-  }();
+
+    if (emitUnified)
+      addCDOFileUnified(files, outputDir, targetOp, aieSim, enableCores,
+                        loadElfFromPath);
+    else
+      addCDOFilesSeparately(files, outputDir, targetOp, aieSim, enableCores,
+                            loadElfFromPath);
+  }
+
+  initializeCDOGenerator(endianness, cdoDebug);
+
+  // The simulation and debug IO backends of libxaie act on each operation as
+  // it is issued, so they cannot be recorded.
+  LogicalResult result =
+      aieSim || xaieDebug || !m.getContext()->isMultithreadingEnabled()
+          ? generateCDOFilesSerially(files, aieSim, xaieDebug)
+          : generateCDOFilesConcurrently(m.getContext(), files);
+  if (succeeded(result) && elfReport)
+    printElfReport(devOps, files, *elfReport);
   return result;
 }
 
 LogicalResult xilinx::AIE::AIETranslateToCDODirect(
     ModuleOp m, llvm::StringRef workDirPath, bool bigEndian, bool emitUnified,
-    bool cdoDebug, bool aieSim, bool xaieDebug, bool enableCores) {
+    bool cdoDebug, bool aieSim, bool xaieDebug, bool enableCores,
+    llvm::raw_ostream *elfReport, bool loadElfFromPath) {
   byte_ordering endianness =
       bigEndian ? byte_ordering::Big_Endian : byte_ordering::Little_Endian;
   return translateToCDODirect(m, workDirPath, endianness, emitUnified, cdoDebug,
-                              aieSim, xaieDebug, enableCores);
+                              aieSim, xaieDebug, enableCores, elfReport,
+                              loadElfFromPath);
 }
@@ -17,8 +17,10 @@
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
 
 #include <vector>
 
@@ -183,12 +185,41 @@ void appendBlockWrite(std::vector<uint32_t> &instructions, NpuBlockWriteOp op) {
     words[i++] = d.getZExtValue();
 }
 
-} // namespace
+// A BD field given by a runtime sequence argument, located by the index of
+// the instruction word that holds it.
+struct FieldPatch {
+  uint32_t argIdx;
+  size_t word;
+  uint32_t shift;
+  uint32_t width;
+  int32_t mul;
+  int32_t div;
+  int32_t add;
+};
+
+// Records the instruction word that last wrote each register, from the
+// operation that starts at `start`.
+void recordWrittenWords(ArrayRef<uint32_t> instructions, size_t start,
+                        llvm::DenseMap<uint32_t, size_t> &writtenWords) {
+  if (start + 3 > instructions.size())
+    return;
+  uint32_t address = instructions[start + 1];
+  switch (instructions[start] & 0xff) {
+  case TXN_OPC_WRITE:
+  case TXN_OPC_MASKWRITE:
+    writtenWords[address] = start + 2;
+    break;
+  case TXN_OPC_BLOCKWRITE:
+    for (size_t i = start + 3; i < instructions.size(); i++)
+      writtenWords[address + (i - start - 3) * sizeof(uint32_t)] = i;
+    break;
+  }
+}
 
-LogicalResult
-xilinx::AIE::AIETranslateNpuToBinary(ModuleOp module,
-                                     std::vector<uint32_t> &instructions,
-                                     StringRef sequenceName) {
+LogicalResult translateNpuToBinary(ModuleOp module,
+                                   std::vector<uint32_t> &instructions,
+                                   StringRef sequenceName,
+                                   SmallVectorImpl<FieldPatch> *fieldPatches) {
 
   auto words = reserveAndGetTail(instructions, 4);
 
@@ -206,12 +237,15 @@ xilinx::AIE::AIETranslateNpuToBinary(ModuleOp module,
   words[0] = (numRows << 24) | (devGen << 16) | (minor << 8) | major;
   words[1] = (numMemTileRows << 8) | numCols;
 
+  bool hasError = false;
+  llvm::DenseMap<uint32_t, size_t> writtenWords;
   auto sequenceOps = deviceOp.getOps<AIEX::RuntimeSequenceOp>();
   for (auto seq : sequenceOps) {
     if (sequenceName.size() && sequenceName != seq.getSymName())
       continue;
     Block &entry = seq.getBody().front();
     for (auto &o : entry) {
+      size_t start = instructions.size();
       llvm::TypeSwitch<Operation *>(&o)
           .Case<NpuSyncOp>([&](auto op) {
             count++;
@@ -232,14 +266,39 @@ xilinx::AIE::AIETranslateNpuToBinary(ModuleOp module,
           .Case<NpuAddressPatchOp>([&](auto op) {
             count++;
             appendAddressPatch(instructions, op);
+          })
+          .Case<NpuFieldPatchOp>([&](auto op) {
+            if (!fieldPatches)
+              return;
+            auto word = writtenWords.find(op.getAddr());
+            if (word == writtenWords.end()) {
+              op.emitOpError("patches a register that is not written before");
+              hasError = true;
+              return;
+            }
+            fieldPatches->push_back(
+                {static_cast<uint32_t>(op.getArgIdx()), word->second,
+                 static_cast<uint32_t>(op.getShift()),
+                 static_cast<uint32_t>(op.getWidth()), op.getMul(),
+                 op.getDiv(), op.getAdd()});
           });
+      recordWrittenWords(instructions, start, writtenWords);
     }
   }
 
   // write size fields of the txn header
   instructions[2] = count;
   instructions[3] = instructions.size() * sizeof(uint32_t); // size of the txn
-  return success();
+  return failure(hasError);
+}
+
+} // namespace
+
+LogicalResult
+xilinx::AIE::AIETranslateNpuToBinary(ModuleOp module,
+                                     std::vector<uint32_t> &instructions,
+                                     StringRef sequenceName) {
+  return translateNpuToBinary(module, instructions, sequenceName, nullptr);
 }
 
 LogicalResult xilinx::AIE::AIETranslateNpuToBinary(ModuleOp module,
@@ -254,6 +313,36 @@ LogicalResult xilinx::AIE::AIETranslateNpuToBinary(ModuleOp module,
   return success();
 }
 
+LogicalResult xilinx::AIE::AIETranslateNpuToPatchTable(ModuleOp module,
+                                                       raw_ostream &output,
+                                                       StringRef sequenceName) {
+  std::vector<uint32_t> instructions;
+  SmallVector<FieldPatch> fieldPatches;
+  if (failed(translateNpuToBinary(module, instructions, sequenceName,
+                                  &fieldPatches)))
+    return failure();
+
+  llvm::json::OStream json(output, 2);
+  json.object([&] {
+    json.attribute("instructions", static_cast<int64_t>(instructions.size()));
+    json.attributeArray("fields", [&] {
+      for (const FieldPatch &patch : fieldPatches) {
+        json.object([&] {
+          json.attribute("arg", patch.argIdx);
+          json.attribute("word", static_cast<int64_t>(patch.word));
+          json.attribute("shift", patch.shift);
+          json.attribute("width", patch.width);
+          json.attribute("mul", patch.mul);
+          json.attribute("div", patch.div);
+          json.attribute("add", patch.add);
+        });
+      }
+    });
+  });
+  output << "\n";
+  return success();
+}
+
 LogicalResult xilinx::AIE::AIETranslateControlPacketsToUI32Vec(
     ModuleOp module, std::vector<uint32_t> &instructions,
     StringRef sequenceName) {
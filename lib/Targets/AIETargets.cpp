@@ -152,6 +152,14 @@ void registerAIETranslations() {
   static llvm::cl::opt<size_t> cdoEnableCores(
       "cdo-enable-cores", llvm::cl::init(true),
       llvm::cl::desc("Enable cores in CDO"));
+  static llvm::cl::opt<bool> cdoElfReport(
+      "cdo-elf-report", llvm::cl::init(false),
+      llvm::cl::desc("Report the ELF images and program bytes loaded into "
+                     "the cores"));
+  static llvm::cl::opt<bool> cdoLoadElfFromPath(
+      "cdo-load-elf-from-path", llvm::cl::init(false),
+      llvm::cl::desc("Load each core ELF from its file rather than from the "
+                     "image shared by the cores with the same ELF"));
 
   static llvm::cl::opt<bool> outputBinary(
       "aie-output-binary", llvm::cl::init(false),
@@ -329,7 +337,7 @@ void registerAIETranslations() {
       AIETranslateShimSolution, registerDialects);
   TranslateFromMLIRRegistration registrationCDODirect(
       "aie-generate-cdo", "Generate libxaie for CDO directly",
-      [](ModuleOp module, raw_ostream &) {
+      [](ModuleOp module, raw_ostream &output) {
         SmallString<128> workDirPath_;
         if (workDirPath.getNumOccurrences() == 0) {
           if (llvm::sys::fs::current_path(workDirPath_))
@@ -340,7 +348,9 @@ void registerAIETranslations() {
         LLVM_DEBUG(llvm::dbgs() << "work-dir-path: " << workDirPath_ << "\n");
         return AIETranslateToCDODirect(module, workDirPath_.c_str(), bigEndian,
                                        cdoUnified, cdoDebug, cdoAieSim,
-                                       cdoXaieDebug, cdoEnableCores);
+                                       cdoXaieDebug, cdoEnableCores,
+                                       cdoElfReport ? &output : nullptr,
+                                       cdoLoadElfFromPath);
       },
       registerDialects);
   TranslateFromMLIRRegistration registrationNPU(
@@ -358,6 +368,13 @@ void registerAIETranslations() {
         return AIETranslateNpuToBinary(module, output, sequenceName);
       },
       registerDialects);
+  TranslateFromMLIRRegistration registrationNPUPatchTable(
+      "aie-npu-to-patch-table",
+      "Translate npu.field_patch ops to a table of instruction fields",
+      [](ModuleOp module, raw_ostream &output) {
+        return AIETranslateNpuToPatchTable(module, output, sequenceName);
+      },
+      registerDialects);
   TranslateFromMLIRRegistration registrationCtrlPkt(
       "aie-ctrlpkt-to-bin", "Translate aiex.control_packet ops to binary",
       [](ModuleOp module, raw_ostream &output) {
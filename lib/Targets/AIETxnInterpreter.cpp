@@ -0,0 +1,464 @@
+//===- AIETxnInterpreter.cpp ------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Targets/AIETxnInterpreter.h"
+
+#include "llvm/Support/Format.h"
+
+#include <set>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+// The register offsets of the state the interpreter reports for a tile.
+// These are the same for all the tiles of a kind on AIE2 and AIE2P.
+struct TileRegisterMap {
+  StringRef kind;
+  uint32_t bdBase;
+  uint32_t bdWords;
+  uint32_t lockBase;
+  uint32_t masterBase;
+  uint32_t slaveBase;
+  uint32_t slotBase;
+  // DMA channel control and task queue registers
+  uint32_t dmaBegin;
+  uint32_t dmaEnd;
+};
+
+constexpr TileRegisterMap shimRegisters{
+    "shim", 0x1D000, 8, 0x14000, 0x3F000, 0x3F100, 0x3F200, 0x1D200, 0x1D220};
+constexpr TileRegisterMap memTileRegisters{
+    "mem", 0xA0000, 8, 0xC0000, 0xB0000, 0xB0100, 0xB0200, 0xA0600, 0xA0660};
+constexpr TileRegisterMap coreRegisters{
+    "core", 0x1D000, 6, 0x1F000, 0x3F000, 0x3F100, 0x3F200, 0x1DE00, 0x1DE20};
+
+constexpr uint32_t bdStride = 0x20;
+constexpr uint32_t lockStride = 0x10;
+constexpr uint32_t portRegionSize = 0x100;
+constexpr uint32_t slotRegionSize = 0x200;
+constexpr uint32_t slotsPerPort = 4;
+
+struct TileAddress {
+  int col;
+  int row;
+  uint32_t offset;
+};
+
+TileAddress decodeAddress(uint64_t address, const AIETargetModel &tm) {
+  uint32_t rowMask = (1u << (tm.getColumnShift() - tm.getRowShift())) - 1;
+  return {static_cast<int>(address >> tm.getColumnShift()),
+          static_cast<int>((address >> tm.getRowShift()) & rowMask),
+          static_cast<uint32_t>(address & ((1u << tm.getRowShift()) - 1))};
+}
+
+const TileRegisterMap *getRegisterMap(int col, int row,
+                                      const AIETargetModel &tm) {
+  if (tm.getTargetArch() == AIEArch::AIE1 || !tm.isValidTile({col, row}))
+    return nullptr;
+  if (tm.isShimNOCorPLTile(col, row))
+    return &shimRegisters;
+  if (tm.isMemTile(col, row))
+    return &memTileRegisters;
+  if (tm.isCoreTile(col, row))
+    return &coreRegisters;
+  return nullptr;
+}
+
+StringRef getOpcodeName(TxnOpcode opcode) {
+  switch (opcode) {
+  case TxnOpcode::Write:
+    return "write";
+  case TxnOpcode::BlockWrite:
+    return "blockwrite";
+  case TxnOpcode::MaskWrite:
+    return "maskwrite";
+  case TxnOpcode::Tct:
+    return "sync";
+  case TxnOpcode::DdrPatch:
+    return "ddr_patch";
+  }
+  llvm_unreachable("unknown transaction opcode");
+}
+
+} // namespace
+
+TxnInterpreter::TxnInterpreter(const AIETargetModel &targetModel)
+    : targetModel(targetModel) {}
+
+std::optional<AIEDevice>
+TxnInterpreter::inferDevice(llvm::ArrayRef<uint32_t> words) {
+  if (words.size() < 4)
+    return std::nullopt;
+  switch (words[1] & 0xff) {
+  case 1:
+    return AIEDevice::npu1_1col;
+  case 2:
+    return AIEDevice::npu1_2col;
+  case 3:
+    return AIEDevice::npu1_3col;
+  case 4:
+    return AIEDevice::npu1_4col;
+  case 5:
+    return AIEDevice::npu1;
+  case 8:
+    return AIEDevice::npu2;
+  default:
+    return std::nullopt;
+  }
+}
+
+TileID TxnInterpreter::getTile(uint64_t address) const {
+  TileAddress tile = decodeAddress(address, targetModel);
+  return {tile.col, tile.row};
+}
+
+bool TxnInterpreter::isDmaChannelRegister(uint64_t address) const {
+  TileAddress tile = decodeAddress(address, targetModel);
+  const TileRegisterMap *map = getRegisterMap(tile.col, tile.row, targetModel);
+  return map && tile.offset >= map->dmaBegin && tile.offset < map->dmaEnd;
+}
+
+bool TxnInterpreter::isStreamSwitchRegister(uint64_t address) const {
+  TileAddress tile = decodeAddress(address, targetModel);
+  const TileRegisterMap *map = getRegisterMap(tile.col, tile.row, targetModel);
+  return map && tile.offset >= map->masterBase &&
+         tile.offset < map->slotBase + slotRegionSize;
+}
+
+bool TxnInterpreter::isBdRegister(uint64_t address) const {
+  TileAddress tile = decodeAddress(address, targetModel);
+  const TileRegisterMap *map = getRegisterMap(tile.col, tile.row, targetModel);
+  return map && tile.offset >= map->bdBase &&
+         tile.offset < map->bdBase + targetModel.getNumBDs(tile.col, tile.row) *
+                                         bdStride;
+}
+
+bool TxnInterpreter::isLockRegister(uint64_t address) const {
+  TileAddress tile = decodeAddress(address, targetModel);
+  const TileRegisterMap *map = getRegisterMap(tile.col, tile.row, targetModel);
+  return map && tile.offset >= map->lockBase &&
+         tile.offset < map->lockBase +
+                           targetModel.getNumLocks(tile.col, tile.row) *
+                               lockStride;
+}
+
+void TxnInterpreter::write(uint64_t address, uint32_t value, uint32_t mask) {
+  stats.registerWrites++;
+  auto it = registers.find(address);
+  uint32_t oldValue = it != registers.end() ? it->second : 0;
+  uint32_t newValue = (oldValue & ~mask) | (value & mask);
+  if (it != registers.end() && newValue == oldValue)
+    stats.redundantWrites++;
+  registers[address] = newValue;
+
+  // A write to a DMA channel starts or changes a transfer, which may read any
+  // register written before it.
+  if (isDmaChannelRegister(address))
+    sync();
+  else if (mask == 0xFFFFFFFF && !pendingWrites.insert(address).second)
+    stats.overwrittenWrites++;
+}
+
+void TxnInterpreter::sync() { pendingWrites.clear(); }
+
+std::optional<uint32_t> TxnInterpreter::readRegister(uint64_t address) const {
+  auto it = registers.find(address);
+  if (it == registers.end())
+    return std::nullopt;
+  return it->second;
+}
+
+LogicalResult TxnInterpreter::run(llvm::ArrayRef<uint32_t> words,
+                                  llvm::raw_ostream &errs) {
+  if (words.size() < 4) {
+    errs << "transaction binary is too short for its header\n";
+    return failure();
+  }
+  uint32_t major = words[0] & 0xff;
+  uint32_t minor = (words[0] >> 8) & 0xff;
+  uint32_t numOps = words[2];
+  uint32_t txnSize = words[3];
+  if (txnSize < 4 * sizeof(uint32_t) || txnSize % sizeof(uint32_t)) {
+    errs << "invalid transaction size " << txnSize << " in the header\n";
+    return failure();
+  }
+  if (txnSize > words.size() * sizeof(uint32_t)) {
+    errs << "transaction binary is truncated: the header gives " << txnSize
+         << " bytes but there are " << words.size() * sizeof(uint32_t)
+         << "\n";
+    return failure();
+  }
+
+  uint64_t opsBefore = 0;
+  for (auto &[opcode, s] : stats.ops)
+    opsBefore += s.count;
+
+  llvm::ArrayRef<uint32_t> ops =
+      words.slice(4, txnSize / sizeof(uint32_t) - 4);
+  LogicalResult result = failure();
+  if (major == 1 && minor == 0) {
+    result = runV1(ops, errs);
+  } else if (major == 0 && minor == 1) {
+    result = runV01(ops, errs);
+  } else {
+    errs << "unsupported transaction binary version " << major << "." << minor
+         << "\n";
+    return failure();
+  }
+  if (failed(result))
+    return failure();
+
+  uint64_t opsAfter = 0;
+  for (auto &[opcode, s] : stats.ops)
+    opsAfter += s.count;
+  if (opsAfter - opsBefore != numOps) {
+    errs << "the header gives " << numOps << " operations but there are "
+         << opsAfter - opsBefore << "\n";
+    return failure();
+  }
+  return success();
+}
+
+// Version 1.0, as generated by AIETranslateNpuToBinary:
+//   write:      opcode, address, value
+//   blockwrite: opcode, address, size in bytes, data...
+//   maskwrite:  opcode, address, value, mask
+//   tct:        opcode, size in bytes, direction/row/column, counts/channel
+//   ddr_patch:  opcode, size in bytes, address, argument, offset, 0
+LogicalResult TxnInterpreter::runV1(llvm::ArrayRef<uint32_t> ops,
+                                    llvm::raw_ostream &errs) {
+  size_t i = 0;
+  while (i < ops.size()) {
+    auto start = std::chrono::steady_clock::now();
+    auto opcode = static_cast<TxnOpcode>(ops[i] & 0xff);
+    size_t size = 0;
+    switch (opcode) {
+    case TxnOpcode::Write:
+      size = 3;
+      break;
+    case TxnOpcode::MaskWrite:
+      size = 4;
+      break;
+    case TxnOpcode::BlockWrite:
+      if (i + 2 < ops.size())
+        size = ops[i + 2] / sizeof(uint32_t);
+      if (size < 3)
+        size = 0;
+      break;
+    case TxnOpcode::Tct:
+    case TxnOpcode::DdrPatch:
+      if (i + 1 < ops.size())
+        size = ops[i + 1] / sizeof(uint32_t);
+      if (size < (opcode == TxnOpcode::Tct ? 4u : 6u))
+        size = 0;
+      break;
+    default:
+      errs << "unknown transaction opcode " << llvm::format_hex(ops[i], 10)
+           << " at word " << i + 4 << "\n";
+      return failure();
+    }
+    if (size == 0 || i + size > ops.size()) {
+      errs << "malformed " << getOpcodeName(opcode) << " at word " << i + 4
+           << "\n";
+      return failure();
+    }
+
+    llvm::ArrayRef<uint32_t> op = ops.slice(i, size);
+    switch (opcode) {
+    case TxnOpcode::Write:
+      write(op[1], op[2]);
+      break;
+    case TxnOpcode::MaskWrite:
+      write(op[1], op[2], op[3]);
+      break;
+    case TxnOpcode::BlockWrite:
+      for (size_t j = 3; j < size; j++)
+        write(op[1] + (j - 3) * sizeof(uint32_t), op[j]);
+      break;
+    case TxnOpcode::Tct:
+      sync();
+      break;
+    case TxnOpcode::DdrPatch:
+      patches[op[2]] = {op[3], op[4]};
+      break;
+    }
+
+    TxnOpStats &s = stats.ops[opcode];
+    s.count++;
+    s.bytes += size * sizeof(uint32_t);
+    s.time += std::chrono::steady_clock::now() - start;
+    i += size;
+  }
+  return success();
+}
+
+// Version 0.1, as exported by aie-rt. Only the register writes are supported:
+//   write:      opcode, 0, address (64 bits), value, size in bytes
+//   blockwrite: opcode, 0, address, size in bytes, data...
+//   maskwrite:  opcode, 0, address (64 bits), value, mask, size in bytes
+LogicalResult TxnInterpreter::runV01(llvm::ArrayRef<uint32_t> ops,
+                                     llvm::raw_ostream &errs) {
+  size_t i = 0;
+  while (i < ops.size()) {
+    auto start = std::chrono::steady_clock::now();
+    auto opcode = static_cast<TxnOpcode>(ops[i] & 0xff);
+    size_t sizeWord = 0;
+    size_t minSize = 0;
+    switch (opcode) {
+    case TxnOpcode::Write:
+      sizeWord = 5;
+      minSize = 6;
+      break;
+    case TxnOpcode::BlockWrite:
+      sizeWord = 3;
+      minSize = 4;
+      break;
+    case TxnOpcode::MaskWrite:
+      sizeWord = 6;
+      minSize = 7;
+      break;
+    default:
+      errs << "unsupported version 0.1 transaction opcode "
+           << llvm::format_hex(ops[i], 10) << " at word " << i + 4 << "\n";
+      return failure();
+    }
+    size_t size = 0;
+    if (i + sizeWord < ops.size())
+      size = ops[i + sizeWord] / sizeof(uint32_t);
+    if (size < minSize || i + size > ops.size()) {
+      errs << "malformed " << getOpcodeName(opcode) << " at word " << i + 4
+           << "\n";
+      return failure();
+    }
+
+    llvm::ArrayRef<uint32_t> op = ops.slice(i, size);
+    uint64_t address = op[2];
+    if (opcode != TxnOpcode::BlockWrite)
+      address |= static_cast<uint64_t>(op[3]) << 32;
+    if (opcode == TxnOpcode::Write)
+      write(address, op[4]);
+    else if (opcode == TxnOpcode::MaskWrite)
+      write(address, op[4], op[5]);
+    else
+      for (size_t j = 4; j < size; j++)
+        write(address + (j - 4) * sizeof(uint32_t), op[j]);
+
+    TxnOpStats &s = stats.ops[opcode];
+    s.count++;
+    s.bytes += size * sizeof(uint32_t);
+    s.time += std::chrono::steady_clock::now() - start;
+    i += size;
+  }
+  return success();
+}
+
+void TxnInterpreter::printState(llvm::raw_ostream &os) const {
+  std::set<std::pair<int, int>> tiles;
+  for (auto &[address, value] : registers) {
+    TileAddress tile = decodeAddress(address, targetModel);
+    tiles.insert({tile.col, tile.row});
+  }
+  for (auto &[address, patch] : patches) {
+    TileAddress tile = decodeAddress(address, targetModel);
+    tiles.insert({tile.col, tile.row});
+  }
+
+  auto hex = [](uint64_t v) { return llvm::format_hex(v, 10); };
+  for (auto [col, row] : tiles) {
+    const TileRegisterMap *map = getRegisterMap(col, row, targetModel);
+    os << "tile (" << col << ", " << row << ")";
+    if (map)
+      os << " " << map->kind;
+    os << "\n";
+
+    uint64_t tileBase =
+        (static_cast<uint64_t>(col) << targetModel.getColumnShift()) |
+        (static_cast<uint64_t>(row) << targetModel.getRowShift());
+    uint64_t tileEnd = tileBase + (1u << targetModel.getRowShift());
+    uint32_t numBDs = map ? targetModel.getNumBDs(col, row) : 0;
+    uint32_t numLocks = map ? targetModel.getNumLocks(col, row) : 0;
+    std::optional<uint32_t> lastBD;
+    for (auto it = registers.lower_bound(tileBase);
+         it != registers.end() && it->first < tileEnd; ++it) {
+      uint32_t offset = it->first - tileBase;
+      uint32_t value = it->second;
+      if (!map) {
+        os << "  reg " << llvm::format_hex(offset, 7) << ": " << hex(value)
+           << "\n";
+        continue;
+      }
+      if (offset >= map->bdBase && offset < map->bdBase + numBDs * bdStride) {
+        uint32_t bd = (offset - map->bdBase) / bdStride;
+        if (lastBD == bd ||
+            (offset - map->bdBase) % bdStride >= map->bdWords * 4)
+          continue;
+        lastBD = bd;
+        os << "  bd " << bd << ":";
+        uint64_t bdAddress = tileBase + map->bdBase + bd * bdStride;
+        for (uint32_t w = 0; w < map->bdWords; w++)
+          os << " " << hex(readRegister(bdAddress + w * 4).value_or(0));
+        os << "\n";
+      } else if (offset >= map->lockBase &&
+                 offset < map->lockBase + numLocks * lockStride &&
+                 (offset - map->lockBase) % lockStride == 0) {
+        os << "  lock " << (offset - map->lockBase) / lockStride << ": "
+           << value << "\n";
+      } else if (offset >= map->masterBase &&
+                 offset < map->masterBase + portRegionSize) {
+        os << "  master " << (offset - map->masterBase) / 4 << ": "
+           << hex(value) << "\n";
+      } else if (offset >= map->slaveBase &&
+                 offset < map->slaveBase + portRegionSize) {
+        os << "  slave " << (offset - map->slaveBase) / 4 << ": " << hex(value)
+           << "\n";
+      } else if (offset >= map->slotBase &&
+                 offset < map->slotBase + slotRegionSize) {
+        uint32_t slot = (offset - map->slotBase) / 4;
+        os << "  slot " << slot / slotsPerPort << "." << slot % slotsPerPort
+           << ": " << hex(value) << "\n";
+      } else if (offset >= map->dmaBegin && offset < map->dmaEnd) {
+        os << "  dma " << llvm::format_hex(offset, 7) << ": " << hex(value)
+           << "\n";
+      } else {
+        os << "  reg " << llvm::format_hex(offset, 7) << ": " << hex(value)
+           << "\n";
+      }
+    }
+    for (auto it = patches.lower_bound(tileBase);
+         it != patches.end() && it->first < tileEnd; ++it)
+      os << "  patch " << llvm::format_hex(it->first - tileBase, 7) << ": arg "
+         << it->second.first << " + " << llvm::format_hex(it->second.second, 3)
+         << "\n";
+  }
+}
+
+void TxnInterpreter::printStats(llvm::raw_ostream &os, bool printTime) const {
+  os << llvm::left_justify("op", 12) << llvm::right_justify("count", 10)
+     << llvm::right_justify("bytes", 12);
+  if (printTime)
+    os << llvm::right_justify("time(us)", 12);
+  os << "\n";
+  for (auto &[opcode, s] : stats.ops) {
+    os << llvm::left_justify(getOpcodeName(opcode), 12)
+       << llvm::format_decimal(s.count, 10)
+       << llvm::format_decimal(s.bytes, 12);
+    if (printTime)
+      os << llvm::format(
+          "%12.3f",
+          std::chrono::duration<double, std::micro>(s.time).count());
+    os << "\n";
+  }
+  os << "register writes: " << stats.registerWrites << "\n";
+  os << "redundant writes: " << stats.redundantWrites << "\n";
+  os << "overwritten writes: " << stats.overwrittenWrites << "\n";
+}
@@ -134,6 +134,14 @@ NB_MODULE(_aie, m) {
       },
       "module"_a, "sequence_name"_a = "");
 
+  m.def(
+      "translate_npu_to_patch_table",
+      [&stealCStr](MlirOperation op, const std::string &sequence_name) {
+        return stealCStr(aieTranslateNpuToPatchTable(
+            op, {sequence_name.data(), sequence_name.size()}));
+      },
+      "module"_a, "sequence_name"_a = "");
+
   m.def(
       "generate_control_packets",
       [&stealCStr](MlirOperation op) {
@@ -164,6 +164,13 @@ def parse_args(args=None):
         action="store_true",
         help="Use dynamic object fifos for the for loops",
     )
+    parser.add_argument(
+        "--hybrid-objFifos",
+        dest="hybrid_objFifos",
+        default=False,
+        action="store_true",
+        help="Unroll the for loops with object fifos while they fit in program memory, use modulo indexing for the others",
+    )
     parser.add_argument(
         "--aie-generate-airbin",
         dest="airbin",
@@ -234,6 +241,26 @@ def parse_args(args=None):
         default="npu_insts.txt",
         help="Output instructions filename for NPU target",
     )
+    parser.add_argument(
+        "--npu-peephole",
+        dest="npu_peephole",
+        default=False,
+        action="store_true",
+        help="Coalesce the writes of the npu instruction stream and drop those that are overwritten",
+    )
+    parser.add_argument(
+        "--no-npu-peephole",
+        dest="npu_peephole",
+        default=False,
+        action="store_false",
+        help="Emit the npu instruction stream as the runtime sequence lists it",
+    )
+    parser.add_argument(
+        "--npu-patch-table-name",
+        dest="patch_table_name",
+        default=None,
+        help="Output filename for the table of NPU instruction fields given by runtime sequence arguments",
+    )
     parser.add_argument(
         "--aie-generate-cdo",
         dest="cdo",
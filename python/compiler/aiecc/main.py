@@ -34,7 +34,7 @@ from aie.dialects import aie as aiedialect
 from aie.ir import Context, Location, Module
 from aie.passmanager import PassManager
 
-INPUT_WITH_ADDRESSES_PIPELINE = lambda scheme, dynamic_objFifos, ctrl_pkt_overlay: (
+INPUT_WITH_ADDRESSES_PIPELINE = lambda scheme, dynamic_objFifos, hybrid_objFifos, ctrl_pkt_overlay: (
     Pipeline()
     .lower_affine()
     .add_pass("aie-canonicalize-device")
@@ -44,7 +44,9 @@ INPUT_WITH_ADDRESSES_PIPELINE = lambda scheme, dynamic_objFifos, ctrl_pkt_overla
         .add_pass("aie-assign-lock-ids")
         .add_pass("aie-register-objectFifos")
         .add_pass(
-            "aie-objectFifo-stateful-transform", dynamic_objFifos=dynamic_objFifos
+            "aie-objectFifo-stateful-transform",
+            dynamic_objFifos=dynamic_objFifos,
+            hybrid_objFifos=hybrid_objFifos,
         )
         .add_pass("aie-assign-bd-ids")
         .add_pass("aie-lower-cascade-flows")
@@ -94,14 +96,15 @@ AIE_LOWER_TO_LLVM = (
 )
 
 # pipeline to lower and legalize runtime sequence for NPU
-NPU_LOWERING_PIPELINE = Pipeline().Nested(
+NPU_LOWERING_PIPELINE = lambda npu_peephole=False: Pipeline().Nested(
     "aie.device",
     Pipeline()
     .add_pass("aie-materialize-bd-chains")
     .add_pass("aie-substitute-shim-dma-allocations")
     .add_pass("aie-assign-runtime-sequence-bd-ids")
     .add_pass("aie-dma-tasks-to-npu")
-    .add_pass("aie-dma-to-npu"),
+    .add_pass("aie-dma-to-npu")
+    + (Pipeline().add_pass("aie-npu-peephole") if npu_peephole else Pipeline()),
 )
 
 
@@ -1076,7 +1079,10 @@ class FlowRunner:
             )
 
             pass_pipeline = INPUT_WITH_ADDRESSES_PIPELINE(
-                opts.alloc_scheme, opts.dynamic_objFifos, opts.ctrl_pkt_overlay
+                opts.alloc_scheme,
+                opts.dynamic_objFifos,
+                opts.hybrid_objFifos,
+                opts.ctrl_pkt_overlay,
             ).materialize(module=True)
 
             file_with_addresses = self.prepend_tmp("input_with_addresses.mlir")
@@ -1111,7 +1117,9 @@ class FlowRunner:
                     file_with_addresses_module = Module.parse(
                         await read_file_async(file_with_addresses)
                     )
-                    pass_pipeline = NPU_LOWERING_PIPELINE.materialize(module=True)
+                    pass_pipeline = NPU_LOWERING_PIPELINE(
+                        opts.npu_peephole
+                    ).materialize(module=True)
                     npu_insts_file = (
                         self.prepend_tmp("npu_insts.mlir")
                         if self.opts.verbose
@@ -1129,6 +1137,12 @@ class FlowRunner:
                     with open(opts.insts_name, "w") as f:
                         for inst in npu_insts:
                             f.write(f"{inst}\n")
+                    if opts.patch_table_name:
+                        patch_table = aiedialect.translate_npu_to_patch_table(
+                            npu_insts_module.operation
+                        )
+                        with open(opts.patch_table_name, "w") as f:
+                            f.write(patch_table)
 
             # fmt: off
             if opts.unified:
@@ -34,6 +34,7 @@ from .._mlir_libs._aie import (
     generate_xaie,
     generate_control_packets,
     translate_npu_to_binary,
+    translate_npu_to_patch_table,
     register_dialect,
     translate_aie_vec_to_cpp,
     translate_mlir_to_llvmir,
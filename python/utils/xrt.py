@@ -6,6 +6,7 @@
 #
 # (c) Copyright 2024 Advanced Micro Devices, Inc.
 import copy
+import json
 import time
 import numpy as np
 import pyxrt as xrt
@@ -117,6 +118,28 @@ def read_insts(insts_path):
     return insts_v
 
 
+def specialize_insts(insts, patch_table_path, args):
+    """Returns a copy of insts with the fields of the patch table generated by
+    aiecc.py --npu-patch-table-name set from the runtime sequence arguments."""
+    with open(patch_table_path, "r") as f:
+        table = json.load(f)
+    if table["instructions"] != len(insts):
+        raise ValueError("the patch table does not match the instructions")
+    insts = np.array(insts, dtype=np.uint32)
+    for field in table["fields"]:
+        value = args[field["arg"]] * field["mul"] // field["div"] + field["add"]
+        mask = (1 << field["width"]) - 1
+        if value < 0 or value > mask:
+            raise ValueError(
+                f"argument {field['arg']} gives {value}, which does not fit in {field['width']} bits"
+            )
+        word = int(insts[field["word"]])
+        word &= ~(mask << field["shift"]) & 0xFFFFFFFF
+        word |= value << field["shift"]
+        insts[field["word"]] = word
+    return insts
+
+
 def setup_aie(
     xclbin_path,
     insts_path,
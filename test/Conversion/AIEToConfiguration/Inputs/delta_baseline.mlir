@@ -0,0 +1,51 @@
+//===- delta_baseline.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The baseline designs of convert_aie_to_txn_delta.mlir, one per device.
+
+aie.device(npu1_1col) {
+  %t02 = aie.tile(0, 2)
+  %lock = aie.lock(%t02, 0) {init = 1 : i32}
+  aie.switchbox(%t02) {
+    aie.connect<DMA : 0, South : 0>
+  }
+}
+
+aie.device(npu1_2col) {
+  %t02 = aie.tile(0, 2)
+  %t03 = aie.tile(0, 3)
+  %buf02 = aie.buffer(%t02) {address = 1024 : i32, sym_name = "buf02"} : memref<32xi32>
+  %buf03 = aie.buffer(%t03) {address = 1024 : i32, sym_name = "buf03"} : memref<16xi32>
+  %lock03 = aie.lock(%t03, 0) {init = 1 : i32, sym_name = "lock03"}
+  %mem02 = aie.mem(%t02) {
+    %0 = aie.dma_start(S2MM, 0, ^bb1, ^bb2)
+  ^bb1:
+    aie.dma_bd(%buf02 : memref<32xi32>, 0, 16) {bd_id = 0 : i32, next_bd_id = 0 : i32}
+    aie.next_bd ^bb1
+  ^bb2:
+    aie.end
+  }
+  %core02 = aie.core(%t02) {
+    aie.end
+  }
+  %mem03 = aie.mem(%t03) {
+    %0 = aie.dma_start(MM2S, 0, ^bb1, ^bb2)
+  ^bb1:
+    aie.use_lock(%lock03, AcquireGreaterEqual, 1)
+    aie.dma_bd(%buf03 : memref<16xi32>, 0, 16) {bd_id = 0 : i32, next_bd_id = 0 : i32}
+    aie.use_lock(%lock03, Release, 1)
+    aie.next_bd ^bb1
+  ^bb2:
+    aie.end
+  }
+  %core03 = aie.core(%t03) {
+    aie.end
+  }
+}
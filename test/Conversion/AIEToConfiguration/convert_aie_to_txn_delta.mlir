@@ -0,0 +1,75 @@
+//===- convert_aie_to_txn_delta.mlir ---------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t/baseline %t/target
+// RUN: cp %S/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/baseline/core_0_2.elf
+// RUN: cp %S/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/target/core_0_2.elf
+// RUN: aie-opt -split-input-file -convert-aie-to-transaction="baseline=%S/Inputs/delta_baseline.mlir" %s | FileCheck %s --check-prefixes=CHECK,SAME-ELF
+// RUN: aie-opt -split-input-file -convert-aie-to-transaction="baseline=%S/Inputs/delta_baseline.mlir elf-dir=%t/target baseline-elf-dir=%t/baseline" %s | FileCheck %s --check-prefixes=CHECK,SAME-ELF
+// RUN: echo >> %t/target/core_0_2.elf
+// RUN: aie-opt -split-input-file -convert-aie-to-transaction="baseline=%S/Inputs/delta_baseline.mlir elf-dir=%t/target baseline-elf-dir=%t/baseline" %s | FileCheck %s --check-prefixes=CHECK,NEW-ELF
+// RUN: aie-opt -convert-aie-to-transaction="baseline=%S/Inputs/delta_baseline.mlir" %S/Inputs/delta_baseline.mlir | FileCheck %s --check-prefix=SAME
+
+// The DMA slave port is configured as in the baseline. The South master port
+// is torn down and the North master port is connected. The lock is
+// initialized as in the baseline too, but the cores and DMAs change lock
+// values as they run, so it is set again.
+
+// CHECK-LABEL: aiex.runtime_sequence @configure
+// CHECK:       aiex.npu.write32 {address = {{[0-9]+}} : ui32, value = 0 : ui32}
+// CHECK-DAG:   aiex.npu.write32 {address = 2224128 : ui32, value = 1 : ui32}
+// CHECK-DAG:   aiex.npu.write32 {address = {{[0-9]+}} : ui32, value = {{[1-9][0-9]*}} : ui32}
+// CHECK-NOT:   aiex.npu
+// CHECK:       }
+
+// SAME-LABEL: aiex.runtime_sequence @configure() {
+// SAME-NEXT:  aiex.npu.write32 {address = 2224128 : ui32, value = 1 : ui32}
+// SAME-NEXT:  }
+
+aie.device(npu1_1col) {
+  %t02 = aie.tile(0, 2)
+  %lock = aie.lock(%t02, 0) {init = 1 : i32}
+  aie.switchbox(%t02) {
+    aie.connect<DMA : 0, North : 0>
+  }
+}
+
+// -----
+
+// BD 0 of tile (0, 2) transfers 32 words instead of 16, so it is written
+// again at 0x21D000. The core of tile (0, 3) is gone: it is disabled at
+// 0x332000, BD 0 of its DMA is invalidated at 0x31D000 and its lock is
+// zeroed at 0x31F000. The ELF of the core of tile (0, 2) is only loaded into
+// its program memory, at 0x220000, when its file differs from the baseline's.
+
+// CHECK-LABEL: aie.device(npu1_2col)
+// CHECK:       aiex.runtime_sequence @configure
+// SAME-ELF-NOT: {address = 2228224 : ui32}
+// NEW-ELF:     aiex.npu.blockwrite(%{{.*}}) {address = 2228224 : ui32}
+// CHECK-DAG:   aiex.npu.{{(mask)?}}write32 {address = 3350528 : ui32, {{(mask = [0-9]+ : ui32, )?}}value = 0 : ui32}
+// CHECK-DAG:   aiex.npu.blockwrite(%{{.*}}) {address = 3264512 : ui32} : memref<6xi32>
+// CHECK-DAG:   aiex.npu.write32 {address = 3272704 : ui32, value = 0 : ui32}
+// CHECK-DAG:   aiex.npu.blockwrite(%{{.*}}) {address = 2215936 : ui32} : memref<6xi32>
+
+aie.device(npu1_2col) {
+  %t02 = aie.tile(0, 2)
+  %buf02 = aie.buffer(%t02) {address = 1024 : i32, sym_name = "buf02"} : memref<32xi32>
+  %mem02 = aie.mem(%t02) {
+    %0 = aie.dma_start(S2MM, 0, ^bb1, ^bb2)
+  ^bb1:
+    aie.dma_bd(%buf02 : memref<32xi32>, 0, 32) {bd_id = 0 : i32, next_bd_id = 0 : i32}
+    aie.next_bd ^bb1
+  ^bb2:
+    aie.end
+  }
+  %core02 = aie.core(%t02) {
+    aie.end
+  }
+}
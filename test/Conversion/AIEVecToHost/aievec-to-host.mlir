@@ -0,0 +1,155 @@
+// RUN: aie-opt %s -split-input-file --convert-aievec-to-host | FileCheck %s
+// RUN: aie-opt %s -split-input-file \
+// RUN:   --convert-aievec-to-host="rounding-mode=conv-even saturate=false" \
+// RUN:   | FileCheck %s --check-prefix=EVEN
+
+// CHECK-LABEL: func.func @srs
+// CHECK-SAME: %[[ACC:.*]]: vector<16xi32>, %[[SHIFT:.*]]: i32
+// CHECK: %[[SPLAT:.*]] = vector.broadcast %[[SHIFT]] : i32 to vector<16xi32>
+// CHECK: %[[Q:.*]] = arith.shrsi %[[ACC]], %[[SPLAT]] : vector<16xi32>
+// CHECK-DAG: %[[MIN:.*]] = arith.constant dense<-32768> : vector<16xi32>
+// CHECK-DAG: %[[MAX:.*]] = arith.constant dense<32767> : vector<16xi32>
+// CHECK: %[[LO:.*]] = arith.maxsi %[[Q]], %[[MIN]] : vector<16xi32>
+// CHECK: %[[SAT:.*]] = arith.minsi %[[LO]], %[[MAX]] : vector<16xi32>
+// CHECK: %[[RES:.*]] = arith.trunci %[[SAT]] : vector<16xi32> to vector<16xi16>
+// CHECK: return %[[RES]]
+// EVEN-LABEL: func.func @srs
+// EVEN: arith.shrsi
+// EVEN: arith.cmpi eq
+// EVEN: arith.extui {{.*}} : vector<16xi1> to vector<16xi32>
+// EVEN: arith.addi
+// EVEN-NOT: arith.maxsi
+// EVEN: arith.trunci {{.*}} : vector<16xi32> to vector<16xi16>
+func.func @srs(%acc : vector<16xi32>, %shift : i32) -> vector<16xi16> {
+  %0 = aievec.srs %acc, %shift : vector<16xi32>, i32, vector<16xi16>
+  return %0 : vector<16xi16>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @ups
+// CHECK-SAME: %[[V:.*]]: vector<16xi16>
+// CHECK: %[[EXT:.*]] = arith.extsi %[[V]] : vector<16xi16> to vector<16xi32>
+// CHECK: %[[C:.*]] = arith.constant dense<3> : vector<16xi32>
+// CHECK: %[[RES:.*]] = arith.shli %[[EXT]], %[[C]] : vector<16xi32>
+// CHECK: return %[[RES]]
+func.func @ups(%v : vector<16xi16>) -> vector<16xi32> {
+  %0 = aievec.ups %v {shift = 3 : i8} : vector<16xi16>, vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @matmul
+// CHECK-SAME: %[[A:.*]]: vector<4x8xi8>, %[[B:.*]]: vector<8x8xi8>,
+// CHECK-SAME: %[[C:.*]]: vector<4x8xi32>
+// CHECK-DAG: %[[EA:.*]] = arith.extsi %[[A]] : vector<4x8xi8> to vector<4x8xi32>
+// CHECK-DAG: %[[EB:.*]] = arith.extsi %[[B]] : vector<8x8xi8> to vector<8x8xi32>
+// CHECK: %[[RES:.*]] = vector.contract
+// CHECK-SAME: iterator_types = ["parallel", "parallel", "reduction"]
+// CHECK-SAME: %[[EA]], %[[EB]], %[[C]]
+// CHECK: return %[[RES]]
+func.func @matmul(%A : vector<4x8xi8>, %B : vector<8x8xi8>,
+                  %C : vector<4x8xi32>) -> vector<4x8xi32> {
+  %0 = aievec.matmul %A, %B, %C : vector<4x8xi8>, vector<8x8xi8>
+                                  into vector<4x8xi32>
+  return %0 : vector<4x8xi32>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @mac_bf16
+// CHECK-SAME: %[[A:.*]]: vector<16xbf16>, %[[B:.*]]: vector<16xbf16>,
+// CHECK-SAME: %[[C:.*]]: vector<16xf32>
+// CHECK-DAG: %[[EA:.*]] = arith.extf %[[A]] : vector<16xbf16> to vector<16xf32>
+// CHECK-DAG: %[[EB:.*]] = arith.extf %[[B]] : vector<16xbf16> to vector<16xf32>
+// CHECK: %[[MUL:.*]] = arith.mulf %[[EA]], %[[EB]] : vector<16xf32>
+// CHECK: %[[RES:.*]] = arith.addf %[[C]], %[[MUL]] : vector<16xf32>
+// CHECK: return %[[RES]]
+func.func @mac_bf16(%a : vector<16xbf16>, %b : vector<16xbf16>,
+                    %c : vector<16xf32>) -> vector<16xf32> {
+  %0 = aievec.mac_elem %a, %b, %c : vector<16xbf16>, vector<16xbf16>,
+                                    vector<16xf32>
+  return %0 : vector<16xf32>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @shuffle
+// CHECK-SAME: %[[LHS:.*]]: vector<16xi32>, %[[RHS:.*]]: vector<16xi32>
+// CHECK: %[[RES:.*]] = vector.shuffle %[[LHS]], %[[RHS]]
+// CHECK-SAME: [0, 8, 16, 24, 1, 9, 17, 25, 2, 10, 18, 26, 3, 11, 19, 27]
+// CHECK: return %[[RES]]
+func.func @shuffle(%lhs : vector<16xi32>,
+                   %rhs : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.shuffle %lhs, %rhs [t32_4x8_lo] : vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @cmp_sel
+// CHECK-SAME: %[[LHS:.*]]: vector<16xi32>, %[[RHS:.*]]: vector<16xi32>
+// CHECK: %[[BITS:.*]] = arith.cmpi sgt, %[[LHS]], %[[RHS]] : vector<16xi32>
+// CHECK: vector.insert_strided_slice %[[BITS]]
+// CHECK-SAME: vector<16xi1> into vector<32xi1>
+// CHECK: vector.bitcast {{.*}} : vector<32xi1> to vector<1xi32>
+// CHECK: vector.bitcast {{.*}} : vector<1xi32> to vector<32xi1>
+// CHECK: %[[MASK:.*]] = vector.extract_strided_slice
+// CHECK: %[[RES:.*]] = arith.select %[[MASK]], %[[RHS]], %[[LHS]]
+// CHECK-SAME: vector<16xi1>, vector<16xi32>
+// CHECK: return %[[RES]]
+func.func @cmp_sel(%lhs : vector<16xi32>,
+                   %rhs : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.cmp %lhs, %rhs {pred = "sgt"} : vector<16xi32>, vector<16xi32>, ui32
+  %1 = aievec.sel %lhs, %rhs, %0 : vector<16xi32>, vector<16xi32>, ui32, vector<16xi32>
+  return %1 : vector<16xi32>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @pack_i4
+// CHECK-SAME: %[[V:.*]]: vector<64xi8>
+// CHECK-DAG: %[[MIN:.*]] = arith.constant dense<-8> : vector<64xi8>
+// CHECK-DAG: %[[MAX:.*]] = arith.constant dense<7> : vector<64xi8>
+// CHECK: %[[LO:.*]] = arith.maxsi %[[V]], %[[MIN]] : vector<64xi8>
+// CHECK: %[[SAT:.*]] = arith.minsi %[[LO]], %[[MAX]] : vector<64xi8>
+// CHECK: %[[P:.*]] = arith.trunci %[[SAT]] : vector<64xi8> to vector<64xi4>
+// CHECK: %[[U:.*]] = arith.extsi %[[P]] : vector<64xi4> to vector<64xi8>
+// CHECK: return %[[U]]
+func.func @pack_i4(%v : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.pack %v : vector<64xi8>, vector<64xi4>
+  %1 = aievec.unpack %0 : vector<64xi4>, vector<64xi8>
+  return %1 : vector<64xi8>
+}
+
+// -----
+
+// The bfp16 operands are quantized in f32 and multiplied there.
+
+// CHECK-LABEL: func.func @matmul_bfp16
+// CHECK-SAME: %[[A:.*]]: vector<8x8xbf16>, %[[B:.*]]: vector<8x8xf32>,
+// CHECK-SAME: %[[C:.*]]: vector<8x8xf32>
+// CHECK: %[[EA:.*]] = arith.extf %[[A]] : vector<8x8xbf16> to vector<8x8xf32>
+// CHECK: %[[BITS:.*]] = vector.bitcast %[[EA]] : vector<8x8xf32> to vector<8x8xi32>
+// CHECK: %[[EXP:.*]] = vector.multi_reduction <maxui>, %{{.*}}, %{{.*}} [1] : vector<8x8xi32> to vector<8xi32>
+// CHECK: %[[BEXP:.*]] = vector.broadcast %[[EXP]] : vector<8xi32> to vector<8x8xi32>
+// CHECK: vector.transpose %[[BEXP]], [1, 0]
+// CHECK: %[[SCALED:.*]] = arith.mulf %[[EA]], %{{.*}} : vector<8x8xf32>
+// CHECK: %[[MAGIC:.*]] = arith.constant dense<{{.*}}> : vector<8x8xf32>
+// CHECK: %[[UP:.*]] = arith.addf %[[SCALED]], %[[MAGIC]]
+// CHECK: %[[RND:.*]] = arith.subf %[[UP]], %[[MAGIC]]
+// CHECK: arith.maximumf %[[RND]]
+// CHECK: arith.minimumf
+// CHECK: %[[QA:.*]] = arith.mulf %{{.*}} : vector<8x8xf32>
+// CHECK: %[[RES:.*]] = vector.contract
+// CHECK-SAME: %[[QA]], %{{.*}}, %[[C]]
+// CHECK: return %[[RES]]
+func.func @matmul_bfp16(%A : vector<8x8xbf16>, %B : vector<8x8xf32>,
+                        %C : vector<8x8xf32>) -> vector<8x8xf32> {
+  %a = aievec.pack_bfp %A : vector<8x8xbf16> -> !aievec.bfp16<8x8>
+  %b = aievec.pack_bfp %B : vector<8x8xf32> -> !aievec.bfp16<8x8>
+  %0 = aievec.matmul_bfp %a, %b, %C : !aievec.bfp16<8x8>, !aievec.bfp16<8x8>
+                                      into vector<8x8xf32>
+  return %0 : vector<8x8xf32>
+}
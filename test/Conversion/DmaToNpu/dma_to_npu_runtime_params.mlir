@@ -0,0 +1,60 @@
+//===- dma_to_npu_runtime_params.mlir --------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file -aie-dma-to-npu %s | FileCheck %s
+
+// The buffer length, d1 size and d1 stride fields are left zero and patched
+// from the runtime sequence arguments.
+
+// CHECK: memref.global "private" constant {{.*}} : memref<8xi32> = dense<[0, 0, 0, 33554432, -2147483648, 0, 0, 33554432]>
+// CHECK: aiex.runtime_sequence
+// CHECK:   aiex.npu.blockwrite({{.*}}) {address = 118784 : ui32} : memref<8xi32>
+// CHECK:   aiex.npu.address_patch {addr = 118788 : ui32, arg_idx = 0 : i32, arg_plus = 0 : i32}
+// CHECK:   aiex.npu.field_patch
+// CHECK-SAME: addr = 118784 : ui32, arg_idx = 1 : i32, div = 32 : i32, mul = 1024 : i32, shift = 0 : i32, width = 32 : i32
+// CHECK:   aiex.npu.field_patch
+// CHECK-SAME: addr = 118800 : ui32, arg_idx = 1 : i32, div = 1 : i32, mul = 1 : i32, shift = 20 : i32, width = 10 : i32
+// CHECK:   aiex.npu.field_patch
+// CHECK-SAME: add = -1 : i32, addr = 118800 : ui32, arg_idx = 2 : i32, div = 32 : i32, mul = 32 : i32, shift = 0 : i32, width = 20 : i32
+// CHECK:   aiex.npu.write32 {address = 119316 : ui32
+module {
+  aie.device(npu1_1col) {
+    memref.global "public" @toMem : memref<32xi32>
+    aiex.runtime_sequence(%arg0: memref<4096xi32>, %n: i64, %stride: i64) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c32 = arith.constant 32 : i64
+      aiex.npu.dma_memcpy_nd (%arg0[%c0, %c0, %c0, %c0][%c1, %c1, %n, %c32][%c0, %c0, %stride, %c1]) { metadata = @toMem, id = 0 : i64 } : memref<4096xi32>
+    }
+    aie.shim_dma_allocation @toMem (MM2S, 0, 0)
+  }
+}
+
+// -----
+
+// A linear transfer only needs its buffer length patched, in units of the
+// address granularity.
+
+// CHECK: memref.global "private" constant {{.*}} : memref<8xi32> = dense<[0, 0, 0, 0, -2147483648, 0, 0, 33554432]>
+// CHECK:   aiex.npu.address_patch {addr = 118788 : ui32, arg_idx = 0 : i32, arg_plus = 0 : i32}
+// CHECK:   aiex.npu.field_patch
+// CHECK-SAME: addr = 118784 : ui32, arg_idx = 1 : i32, div = 32 : i32, mul = 16 : i32, shift = 0 : i32, width = 32 : i32
+// CHECK-NOT: aiex.npu.field_patch
+module {
+  aie.device(npu1_1col) {
+    memref.global "public" @toMem : memref<32xbf16>
+    aiex.runtime_sequence(%arg0: memref<4096xbf16>, %n: i64) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      aiex.npu.dma_memcpy_nd (%arg0[%c0, %c0, %c0, %c0][%c1, %c1, %c1, %n][%c0, %c0, %c0, %c1]) { metadata = @toMem, id = 0 : i64 } : memref<4096xbf16>
+    }
+    aie.shim_dma_allocation @toMem (MM2S, 0, 0)
+  }
+}
@@ -0,0 +1,48 @@
+// RUN: aie-opt %s -split-input-file -convert-vector-to-aievec="aie-target=aie2p bfp16-matmul=true" | FileCheck %s
+
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// Weights stored in bfp16 multiply the activations packed on the fly, at the
+// cost of the precision of the activations.
+
+// CHECK-LABEL: func.func @contract_bfp16_weights(
+// CHECK-SAME: %[[A:[a-zA-Z0-9]+]]: vector<8x8xbf16>,
+// CHECK-SAME: %[[B:[a-zA-Z0-9]+]]: !aievec.bfp16<8x8>,
+// CHECK-SAME: %[[C:[a-zA-Z0-9]+]]: vector<8x8xf32>) -> vector<8x8xf32> {
+// CHECK:        %[[PA:.*]] = aievec.pack_bfp %[[A]] : vector<8x8xbf16> -> !aievec.bfp16<8x8>
+// CHECK:        %[[MM:.*]] = aievec.matmul_bfp %[[PA]], %[[B]], %[[C]] :
+// CHECK-SAME:   !aievec.bfp16<8x8>, !aievec.bfp16<8x8> into vector<8x8xf32>
+// CHECK:        return %[[MM]] : vector<8x8xf32>
+func.func @contract_bfp16_weights(%A : vector<8x8xbf16>,
+                                  %B : !aievec.bfp16<8x8>,
+                                  %C : vector<8x8xf32>) -> vector<8x8xf32> {
+  %b = aievec.unpack_bfp %B : !aievec.bfp16<8x8> -> vector<8x8xbf16>
+  %0 = vector.contract {indexing_maps = [#map1, #map2, #map3],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %A, %b, %C :
+                        vector<8x8xbf16>, vector<8x8xbf16> into vector<8x8xf32>
+  return %0 : vector<8x8xf32>
+}
+
+// -----
+
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// Without a bfp16 operand, bf16 contractions keep their precision.
+
+// CHECK-LABEL: func.func @contract_bf16(
+// CHECK-NOT:    aievec.pack_bfp
+// CHECK:        aievec.matmul %{{.*}} : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+func.func @contract_bf16(%A : vector<4x8xbf16>,
+                         %B : vector<8x4xbf16>,
+                         %C : vector<4x4xf32>) -> vector<4x4xf32> {
+  %0 = vector.contract {indexing_maps = [#map1, #map2, #map3],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %A, %B, %C :
+                        vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  return %0 : vector<4x4xf32>
+}
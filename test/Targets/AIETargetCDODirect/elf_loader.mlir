@@ -0,0 +1,35 @@
+//===- elf_loader.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t/mem %t/path
+// RUN: cp %S/../../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/mem/core_0_2.elf
+// RUN: cp %S/../../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/mem/core_0_3.elf
+// RUN: cp %t/mem/core_0_2.elf %t/mem/core_0_3.elf %t/path
+// RUN: aie-translate --aie-generate-cdo --work-dir-path=%t/mem %s
+// RUN: aie-translate --aie-generate-cdo --cdo-load-elf-from-path --work-dir-path=%t/path %s
+// RUN: diff %t/mem/aie_cdo_elfs.bin %t/path/aie_cdo_elfs.bin
+// RUN: diff %t/mem/aie_cdo_init.bin %t/path/aie_cdo_init.bin
+// RUN: diff %t/mem/aie_cdo_enable.bin %t/path/aie_cdo_enable.bin
+
+// Loading the cores that run the same kernel from one ELF image in memory
+// writes the same CDO as reading the ELF of each core from its file.
+
+module {
+  aie.device(npu1_1col) {
+    %t02 = aie.tile(0, 2)
+    %t03 = aie.tile(0, 3)
+    %c02 = aie.core(%t02) {
+      aie.end
+    }
+    %c03 = aie.core(%t03) {
+      aie.end
+    }
+  }
+}
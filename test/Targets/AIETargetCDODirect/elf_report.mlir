@@ -0,0 +1,38 @@
+//===- elf_report.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: cp %S/../../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/core_0_2.elf
+// RUN: cp %S/../../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/core_0_4.elf
+// RUN: aie-translate --aie-generate-cdo --cdo-elf-report --work-dir-path=%t %s | FileCheck %s
+// RUN: aie-translate --aie-generate-cdo --cdo-elf-report --work-dir-path=%t %s --mlir-disable-threading | FileCheck %s
+
+// The three cores run the same kernel, from two files with the same contents,
+// so there is one distinct ELF image. Each core is still written its own copy
+// of the program, so the bytes written are three times those of the image.
+
+// CHECK: device 0: cores: 3, distinct ELF images: 1, program bytes written: [[#BYTES:]] ([[#div(BYTES,3)]] in distinct images)
+
+module {
+  aie.device(npu1_1col) {
+    %t02 = aie.tile(0, 2)
+    %t03 = aie.tile(0, 3)
+    %t04 = aie.tile(0, 4)
+    %c02 = aie.core(%t02) {
+      aie.end
+    }
+    %c03 = aie.core(%t03) {
+      aie.end
+    } {elf_file = "core_0_2.elf"}
+    %c04 = aie.core(%t04) {
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,72 @@
+//===- multi_device.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/threaded/device_0 %t/threaded/device_1 %t/serial/device_0 %t/serial/device_1
+// RUN: cp %S/../../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/threaded/device_0/core_0_2.elf
+// RUN: cp %S/../../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/threaded/device_1/core_1_2.elf
+// RUN: cp %S/../../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/serial/device_0/core_0_2.elf
+// RUN: cp %S/../../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/core_0_2.elf %t/serial/device_1/core_1_2.elf
+// RUN: aie-translate --aie-generate-cdo --work-dir-path=%t/threaded %s --cdo-debug=true | FileCheck %s
+// RUN: aie-translate --aie-generate-cdo --work-dir-path=%t/serial %s --cdo-debug=true --mlir-disable-threading | FileCheck %s
+// RUN: cmp %t/threaded/device_0/aie_cdo_elfs.bin %t/serial/device_0/aie_cdo_elfs.bin
+// RUN: cmp %t/threaded/device_0/aie_cdo_init.bin %t/serial/device_0/aie_cdo_init.bin
+// RUN: cmp %t/threaded/device_0/aie_cdo_enable.bin %t/serial/device_0/aie_cdo_enable.bin
+// RUN: cmp %t/threaded/device_1/aie_cdo_elfs.bin %t/serial/device_1/aie_cdo_elfs.bin
+// RUN: cmp %t/threaded/device_1/aie_cdo_init.bin %t/serial/device_1/aie_cdo_init.bin
+// RUN: cmp %t/threaded/device_1/aie_cdo_enable.bin %t/serial/device_1/aie_cdo_enable.bin
+
+// The files are written in order, whether they are generated concurrently or
+// not, and their contents are the same either way. The ELF of the core of
+// each device is loaded into its program memory before the DMA is set up.
+
+// CHECK: (BlockWrite-DMAWriteCmd): Start Address: 0x0000000000220000
+// CHECK: (BlockWrite-DMAWriteCmd): Start Address: 0x000000000001D000  Size: 8
+// CHECK:     Address: 0x000000000001D000  Data@ {{0x[0-9a-z]+}} is: 0x00000004
+// CHECK: (Write64): Address:  0x000000000001D204 Data:  0x80000000
+// CHECK: (BlockWrite-DMAWriteCmd): Start Address: 0x0000000002220000
+// CHECK: (BlockWrite-DMAWriteCmd): Start Address: 0x000000000201D000  Size: 8
+// CHECK:     Address: 0x000000000201D000  Data@ {{0x[0-9a-z]+}} is: 0x00000008
+// CHECK: (Write64): Address:  0x000000000201D214 Data:  0x80000000
+
+module {
+ aie.device(npu1_1col) {
+  %buffer = aie.external_buffer { sym_name = "buf" } : memref<16 x f32>
+  %t00 = aie.tile(0, 0)
+  %t02 = aie.tile(0, 2)
+  %c02 = aie.core(%t02) {
+    aie.end
+  }
+  aie.shim_dma(%t00)  {
+      aie.dma_start(S2MM, 0, ^bd0, ^end)
+    ^bd0:
+      aie.dma_bd(%buffer : memref<16 x f32>, 0, 4)  {bd_id = 0 : i32}
+      aie.next_bd ^end
+    ^end:
+      aie.end
+  }
+ }
+ aie.device(npu1_2col) {
+  %buffer = aie.external_buffer { sym_name = "buf" } : memref<16 x f32>
+  %t10 = aie.tile(1, 0)
+  %t12 = aie.tile(1, 2)
+  %c12 = aie.core(%t12) {
+    aie.end
+  }
+  aie.shim_dma(%t10)  {
+      aie.dma_start(MM2S, 0, ^bd0, ^end)
+    ^bd0:
+      aie.dma_bd(%buffer : memref<16 x f32>, 0, 8)  {bd_id = 0 : i32}
+      aie.next_bd ^end
+    ^end:
+      aie.end
+  }
+ }
+}
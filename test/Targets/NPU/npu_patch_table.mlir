@@ -0,0 +1,49 @@
+//===- npu_patch_table.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-dma-to-npu %s | aie-translate --aie-npu-to-patch-table | FileCheck %s
+
+// The BD is the data of the blockwrite at word 4, so its words start at
+// instruction word 7.
+
+// CHECK: "instructions": 24,
+// CHECK: "arg": 1,
+// CHECK-NEXT: "word": 7,
+// CHECK-NEXT: "shift": 0,
+// CHECK-NEXT: "width": 32,
+// CHECK-NEXT: "mul": 1024,
+// CHECK-NEXT: "div": 32,
+// CHECK-NEXT: "add": 0
+// CHECK: "arg": 1,
+// CHECK-NEXT: "word": 11,
+// CHECK-NEXT: "shift": 20,
+// CHECK-NEXT: "width": 10,
+// CHECK-NEXT: "mul": 1,
+// CHECK-NEXT: "div": 1,
+// CHECK-NEXT: "add": 0
+// CHECK: "arg": 2,
+// CHECK-NEXT: "word": 11,
+// CHECK-NEXT: "shift": 0,
+// CHECK-NEXT: "width": 20,
+// CHECK-NEXT: "mul": 32,
+// CHECK-NEXT: "div": 32,
+// CHECK-NEXT: "add": -1
+module {
+  aie.device(npu1_1col) {
+    memref.global "public" @toMem : memref<32xi32>
+    aiex.runtime_sequence(%arg0: memref<4096xi32>, %n: i64, %stride: i64) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c32 = arith.constant 32 : i64
+      aiex.npu.dma_memcpy_nd (%arg0[%c0, %c0, %c0, %c0][%c1, %c1, %n, %c32][%c0, %c0, %stride, %c1]) { metadata = @toMem, id = 0 : i64 } : memref<4096xi32>
+    }
+    aie.shim_dma_allocation @toMem (MM2S, 0, 0)
+  }
+}
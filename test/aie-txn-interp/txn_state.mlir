@@ -0,0 +1,61 @@
+//===- txn_state.mlir ------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate -aie-npu-to-binary -aie-output-binary=true %s -o %t.bin
+// RUN: aie-txn-interp %t.bin | FileCheck %s
+// RUN: aie-translate -aie-npu-to-binary %s | aie-txn-interp | FileCheck %s
+// RUN: aie-txn-interp --state=false --time %t.bin | FileCheck %s --check-prefix=TIME
+// RUN: not aie-txn-interp --device=npu9 %t.bin 2>&1 | FileCheck %s --check-prefix=BADDEVICE
+
+// CHECK:      tile (0, 1) mem
+// CHECK-NEXT:   slave 0: 0x80000000
+// CHECK-NEXT:   slot 0.1: 0x00000010
+// CHECK-NEXT: tile (0, 2) core
+// CHECK-NEXT:   lock 0: 1
+// CHECK-NEXT:   reg 0x32000: 0x00000001
+// CHECK-NEXT:   master 1: 0x80000000
+// CHECK-NEXT: tile (1, 0) shim
+// CHECK-NEXT:   bd 0: 0x00000100 0x00000000 0x00000000 0x00000000 0x00000000 0x00000000 0x00000000 0x02000000
+// CHECK-NEXT:   dma 0x1d214: 0x00000000
+// CHECK-NEXT:   patch 0x1d004: arg 0 + 0x40
+// CHECK-NEXT: op count bytes
+// CHECK-NEXT: write 6 72
+// CHECK-NEXT: blockwrite 1 44
+// CHECK-NEXT: maskwrite 1 16
+// CHECK-NEXT: sync 1 16
+// CHECK-NEXT: ddr_patch 1 24
+// CHECK-NEXT: register writes: 15
+// CHECK-NEXT: redundant writes: 1
+// CHECK-NEXT: overwritten writes: 1
+
+// TIME-NOT:   tile
+// TIME:       op count bytes time(us)
+// TIME-NEXT:  write 6 72 {{[0-9.]+}}
+
+// BADDEVICE: unknown device 'npu9'
+
+module {
+  aie.device(npu1_2col) {
+    memref.global "private" constant @bd : memref<8xi32> = dense<[256, 0, 0, 0, 0, 0, 0, 33554432]>
+    aiex.runtime_sequence @seq(%arg0: memref<16xi32>) {
+      %0 = memref.get_global @bd : memref<8xi32>
+      aiex.npu.blockwrite(%0) {address = 118784 : ui32, column = 1 : i32, row = 0 : i32} : memref<8xi32>
+      aiex.npu.address_patch {addr = 33673220 : ui32, arg_idx = 0 : i32, arg_plus = 64 : i32}
+      aiex.npu.write32 {address = 119316 : ui32, column = 1 : i32, row = 0 : i32, value = 0 : ui32}
+      aiex.npu.write32 {address = 126976 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+      aiex.npu.write32 {address = 126976 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+      aiex.npu.maskwrite32 {address = 258052 : ui32, column = 0 : i32, row = 2 : i32, value = 2147483648 : ui32, mask = 2147483648 : ui32}
+      aiex.npu.write32 {address = 721152 : ui32, column = 0 : i32, row = 1 : i32, value = 2147483648 : ui32}
+      aiex.npu.write32 {address = 721412 : ui32, column = 0 : i32, row = 1 : i32, value = 16 : ui32}
+      aiex.npu.write32 {address = 204800 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+      aiex.npu.sync {channel = 0 : i32, column = 1 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+    }
+  }
+}
@@ -0,0 +1,28 @@
+//===- npu_peephole.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: %python aiecc.py -nv --no-compile --no-link --aie-generate-npu-insts --npu-insts-name=%t.default.txt %s | FileCheck %s --check-prefix=DEFAULT
+// RUN: %python aiecc.py -nv --no-compile --no-link --aie-generate-npu-insts --npu-peephole --npu-insts-name=%t.peephole.txt %s | FileCheck %s --check-prefix=PEEPHOLE
+
+// The npu instruction stream is only coalesced when asked to.
+
+// DEFAULT: Running: {{.*}}aie-dma-to-npu
+// DEFAULT-NOT: aie-npu-peephole
+// PEEPHOLE: Running: {{.*}}aie-dma-to-npu{{.*}}aie-npu-peephole
+
+module {
+  aie.device(npu1_1col) {
+    %t00 = aie.tile(0, 0)
+    aiex.runtime_sequence(%arg0: memref<16xi32>) {
+      aiex.npu.write32 {address = 119300 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {address = 119304 : ui32, value = 2 : ui32}
+    }
+  }
+}
@@ -0,0 +1,77 @@
+//===- conflict_aware_alloc_simple.mlir ------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=conflict-aware" %s | FileCheck %s
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=bank-aware" %s | FileCheck %s --check-prefix=ROUNDROBIN
+
+// %a, %b and %c are accessed in the same loop and %p0, %p1 are ping-pong
+// buffers of the same BD chain. Round-robin allocation puts %b in the same
+// bank as %a and %p1 in the same bank as %p0.
+
+// CHECK: %a = aie.buffer(%tile_3_3) {address = 1024 : i32, mem_bank = 0 : i32, sym_name = "a"} : memref<256xi32>
+// CHECK: %f1 = aie.buffer(%tile_3_3) {address = 8192 : i32, mem_bank = 1 : i32, sym_name = "f1"} : memref<240xi32>
+// CHECK: %f2 = aie.buffer(%tile_3_3) {address = 16384 : i32, mem_bank = 2 : i32, sym_name = "f2"} : memref<224xi32>
+// CHECK: %f3 = aie.buffer(%tile_3_3) {address = 24576 : i32, mem_bank = 3 : i32, sym_name = "f3"} : memref<208xi32>
+// CHECK: %b = aie.buffer(%tile_3_3) {address = 9152 : i32, mem_bank = 1 : i32, sym_name = "b"} : memref<192xi32>
+// CHECK: %c = aie.buffer(%tile_3_3) {address = 17280 : i32, mem_bank = 2 : i32, sym_name = "c"} : memref<64xi32>
+// CHECK: %p0 = aie.buffer(%tile_4_4) {address = 1024 : i32, mem_bank = 0 : i32, sym_name = "p0"} : memref<256xi32>
+// CHECK: %g1 = aie.buffer(%tile_4_4) {address = 8192 : i32, mem_bank = 1 : i32, sym_name = "g1"} : memref<240xi32>
+// CHECK: %g2 = aie.buffer(%tile_4_4) {address = 16384 : i32, mem_bank = 2 : i32, sym_name = "g2"} : memref<224xi32>
+// CHECK: %g3 = aie.buffer(%tile_4_4) {address = 24576 : i32, mem_bank = 3 : i32, sym_name = "g3"} : memref<208xi32>
+// CHECK: %p1 = aie.buffer(%tile_4_4) {address = 9152 : i32, mem_bank = 1 : i32, sym_name = "p1"} : memref<192xi32>
+
+// ROUNDROBIN: %b = aie.buffer(%tile_3_3) {address = 2048 : i32, mem_bank = 0 : i32, sym_name = "b"} : memref<192xi32>
+// ROUNDROBIN: %c = aie.buffer(%tile_3_3) {address = 9152 : i32, mem_bank = 1 : i32, sym_name = "c"} : memref<64xi32>
+// ROUNDROBIN: %p1 = aie.buffer(%tile_4_4) {address = 2048 : i32, mem_bank = 0 : i32, sym_name = "p1"} : memref<192xi32>
+
+module @test {
+  aie.device(xcvc1902) {
+    %t33 = aie.tile(3, 3)
+    %a = aie.buffer(%t33) { sym_name = "a" } : memref<256xi32>
+    %f1 = aie.buffer(%t33) { sym_name = "f1" } : memref<240xi32>
+    %f2 = aie.buffer(%t33) { sym_name = "f2" } : memref<224xi32>
+    %f3 = aie.buffer(%t33) { sym_name = "f3" } : memref<208xi32>
+    %b = aie.buffer(%t33) { sym_name = "b" } : memref<192xi32>
+    %c = aie.buffer(%t33) { sym_name = "c" } : memref<64xi32>
+    aie.core(%t33) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c64 = arith.constant 64 : index
+      scf.for %i = %c0 to %c64 step %c1 {
+        %x = memref.load %a[%i] : memref<256xi32>
+        %y = memref.load %b[%i] : memref<192xi32>
+        %z = arith.muli %x, %y : i32
+        memref.store %z, %c[%i] : memref<64xi32>
+      }
+      aie.end
+    }
+
+    %t44 = aie.tile(4, 4)
+    %p0 = aie.buffer(%t44) { sym_name = "p0" } : memref<256xi32>
+    %g1 = aie.buffer(%t44) { sym_name = "g1" } : memref<240xi32>
+    %g2 = aie.buffer(%t44) { sym_name = "g2" } : memref<224xi32>
+    %g3 = aie.buffer(%t44) { sym_name = "g3" } : memref<208xi32>
+    %p1 = aie.buffer(%t44) { sym_name = "p1" } : memref<192xi32>
+    aie.core(%t44) {
+      aie.end
+    }
+    %m44 = aie.mem(%t44) {
+      %dma = aie.dma_start(S2MM, 0, ^bd0, ^end)
+    ^bd0:
+      aie.dma_bd(%p0 : memref<256xi32>, 0, 192)
+      aie.next_bd ^bd1
+    ^bd1:
+      aie.dma_bd(%p1 : memref<192xi32>, 0, 192)
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+    }
+  }
+}
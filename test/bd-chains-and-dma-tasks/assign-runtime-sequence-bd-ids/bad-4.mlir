@@ -0,0 +1,45 @@
+//===- bad-4.mlir ----------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 AMD Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --aie-assign-runtime-sequence-bd-ids %s
+
+// This test ensures that a sync only completes the oldest task in flight on
+// its channel: with two tasks started and a single sync, the BD ID of the
+// second task is still in use.
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_0 = aie.tile(0, 0)
+
+    aiex.runtime_sequence(%arg0: memref<8xi16>) {
+      %t1 = aiex.dma_configure_task(%tile_0_0, S2MM, 0) {
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 7 : i32}
+        aie.end
+      } {issue_token = true}
+      %t2 = aiex.dma_configure_task(%tile_0_0, S2MM, 0) {
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 8 : i32}
+        aie.end
+      } {issue_token = true}
+      aiex.dma_start_task(%t1)
+      aiex.dma_start_task(%t2)
+      aiex.npu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+      // The sync completed %t1, so its BD ID can be reused.
+      %t3 = aiex.dma_configure_task(%tile_0_0, S2MM, 0) {
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 7 : i32}
+        aie.end
+      }
+      // expected-error@+1 {{Specified buffer descriptor ID 8 is already in use}}
+      %t4 = aiex.dma_configure_task(%tile_0_0, S2MM, 0) {
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 8 : i32}
+        aie.end
+      }
+    }
+  }
+}
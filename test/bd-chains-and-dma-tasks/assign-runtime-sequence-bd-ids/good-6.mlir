@@ -0,0 +1,83 @@
+//===- good-6.mlir ---------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 AMD Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-runtime-sequence-bd-ids %s | FileCheck %s
+
+// This test ensures that BD IDs are reused once the tasks holding them are
+// known to have completed, including tasks started earlier on the same channel
+// as an awaited task, that specified IDs are avoided by tasks whose liveness
+// overlaps them, and that memtile BDs are taken from the channel's BD range.
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+
+    aiex.runtime_sequence(%arg0: memref<8xi16>) {
+      %t1 = aiex.dma_configure_task(%tile_0_0, MM2S, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 0 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      // ID 1 is specified further down by a task whose liveness overlaps.
+      %t2 = aiex.dma_configure_task(%tile_0_0, MM2S, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 2 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      %t3 = aiex.dma_configure_task(%tile_0_0, MM2S, 1) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 1 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 1 : i32}
+        aie.end
+      } {issue_token = true}
+      aiex.dma_start_task(%t1)
+      aiex.dma_start_task(%t2)
+      aiex.dma_start_task(%t3)
+      // Tasks complete in order on a channel: awaiting %t2 frees %t1 as well,
+      // but not %t3 on another channel.
+      aiex.dma_await_task(%t2)
+
+      %t4 = aiex.dma_configure_task(%tile_0_0, MM2S, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 0 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.next_bd ^bb1
+      ^bb1:
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 2 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      aiex.dma_start_task(%t4)
+
+      // A sync on the channel consumes one task completion token, that of the
+      // oldest task started on it and not yet completed: %t3.
+      aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+
+      %t5 = aiex.dma_configure_task(%tile_0_0, MM2S, 1) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 1 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+
+      // Odd memtile channels can only use the upper half of the BDs.
+      %t6 = aiex.dma_configure_task(%tile_0_1, S2MM, 1) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 24 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      %t7 = aiex.dma_configure_task(%tile_0_1, S2MM, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 0 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      // CHECK-NOT: aiex.dma_free_task
+      aiex.dma_free_task(%t5)
+    }
+  }
+}
@@ -0,0 +1,62 @@
+//===- astar_routing.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Point-to-point circuit flows are routed with A*, the broadcast and the
+// packet flow fall back to Dijkstra.
+
+// RUN: aie-opt --aie-create-pathfinder-flows="astar=true" --aie-find-flows %s | FileCheck %s
+
+// CHECK: %[[T20:.*]] = aie.tile(2, 0)
+// CHECK: %[[T30:.*]] = aie.tile(3, 0)
+// CHECK: %[[T60:.*]] = aie.tile(6, 0)
+// CHECK: %[[T70:.*]] = aie.tile(7, 0)
+// CHECK: %[[T13:.*]] = aie.tile(1, 3)
+// CHECK: %[[T32:.*]] = aie.tile(3, 2)
+// CHECK: %[[T71:.*]] = aie.tile(7, 1)
+// CHECK: %[[T72:.*]] = aie.tile(7, 2)
+// CHECK: %[[T73:.*]] = aie.tile(7, 3)
+// CHECK: %[[T83:.*]] = aie.tile(8, 3)
+//
+// CHECK-DAG: aie.flow(%[[T71]], DMA : 0, %[[T20]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T72]], DMA : 0, %[[T60]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T73]], DMA : 0, %[[T70]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T83]], DMA : 0, %[[T30]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T13]], DMA : 0, %[[T32]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T13]], DMA : 0, %[[T73]], DMA : 1)
+// CHECK-DAG: aie.packet_source<%[[T32]], DMA : 1>
+// CHECK-DAG: aie.packet_dest<%[[T83]], DMA : 1>
+
+module {
+    aie.device(xcvc1902) {
+        %t20 = aie.tile(2, 0)
+        %t30 = aie.tile(3, 0)
+        %t60 = aie.tile(6, 0)
+        %t70 = aie.tile(7, 0)
+        %t13 = aie.tile(1, 3)
+        %t32 = aie.tile(3, 2)
+        %t71 = aie.tile(7, 1)
+        %t72 = aie.tile(7, 2)
+        %t73 = aie.tile(7, 3)
+        %t83 = aie.tile(8, 3)
+
+        aie.flow(%t71, DMA : 0, %t20, DMA : 0)
+        aie.flow(%t72, DMA : 0, %t60, DMA : 0)
+        aie.flow(%t73, DMA : 0, %t70, DMA : 0)
+        aie.flow(%t83, DMA : 0, %t30, DMA : 0)
+
+        aie.flow(%t13, DMA : 0, %t32, DMA : 0)
+        aie.flow(%t13, DMA : 0, %t73, DMA : 1)
+
+        aie.packet_flow(0x1) {
+          aie.packet_source<%t32, DMA : 1>
+          aie.packet_dest<%t83, DMA : 1>
+        }
+    }
+}
@@ -0,0 +1,53 @@
+//===- incremental_routing.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true" --aie-find-flows %s | FileCheck %s
+
+// Congested flows converge to a legal routing when only the flows crossing
+// over capacity channels are rerouted.
+
+// CHECK: %[[T20:.*]] = aie.tile(2, 0)
+// CHECK: %[[T30:.*]] = aie.tile(3, 0)
+// CHECK: %[[T60:.*]] = aie.tile(6, 0)
+// CHECK: %[[T70:.*]] = aie.tile(7, 0)
+// CHECK: %[[T71:.*]] = aie.tile(7, 1)
+// CHECK: %[[T72:.*]] = aie.tile(7, 2)
+// CHECK: %[[T73:.*]] = aie.tile(7, 3)
+// CHECK: %[[T83:.*]] = aie.tile(8, 3)
+// CHECK-DAG: aie.flow(%[[T71]], DMA : 0, %[[T20]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T71]], DMA : 1, %[[T20]], DMA : 1)
+// CHECK-DAG: aie.flow(%[[T72]], DMA : 0, %[[T60]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T72]], DMA : 1, %[[T60]], DMA : 1)
+// CHECK-DAG: aie.flow(%[[T73]], DMA : 0, %[[T70]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T73]], DMA : 1, %[[T70]], DMA : 1)
+// CHECK-DAG: aie.flow(%[[T83]], DMA : 0, %[[T30]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T83]], DMA : 1, %[[T30]], DMA : 1)
+
+module {
+    aie.device(xcvc1902) {
+        %t20 = aie.tile(2, 0)
+        %t30 = aie.tile(3, 0)
+        %t60 = aie.tile(6, 0)
+        %t70 = aie.tile(7, 0)
+        %t71 = aie.tile(7, 1)
+        %t72 = aie.tile(7, 2)
+        %t73 = aie.tile(7, 3)
+        %t83 = aie.tile(8, 3)
+
+        aie.flow(%t71, DMA : 0, %t20, DMA : 0)
+        aie.flow(%t71, DMA : 1, %t20, DMA : 1)
+        aie.flow(%t72, DMA : 0, %t60, DMA : 0)
+        aie.flow(%t72, DMA : 1, %t60, DMA : 1)
+        aie.flow(%t73, DMA : 0, %t70, DMA : 0)
+        aie.flow(%t73, DMA : 1, %t70, DMA : 1)
+        aie.flow(%t83, DMA : 0, %t30, DMA : 0)
+        aie.flow(%t83, DMA : 1, %t30, DMA : 1)
+    }
+}
@@ -0,0 +1,63 @@
+//===- parallel_routing.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The concurrent searches must produce exactly the serial routing.
+
+// RUN: aie-opt --aie-create-pathfinder-flows %s -o %t.serial.mlir
+// RUN: aie-opt --aie-create-pathfinder-flows="parallel=true" %s -o %t.parallel.mlir
+// RUN: diff %t.serial.mlir %t.parallel.mlir
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true" %s -o %t.incremental.mlir
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true parallel=true" %s -o %t.incremental.parallel.mlir
+// RUN: diff %t.incremental.mlir %t.incremental.parallel.mlir
+// RUN: aie-opt --aie-find-flows %t.parallel.mlir | FileCheck %s
+
+// CHECK-DAG: aie.flow(%{{.*}}, DMA : 0, %{{.*}}, DMA : 0)
+// CHECK-DAG: aie.packet_source<%{{.*}}, Core : 0>
+
+module {
+    aie.device(xcvc1902) {
+        %t02 = aie.tile(0, 2)
+        %t03 = aie.tile(0, 3)
+        %t11 = aie.tile(1, 1)
+        %t13 = aie.tile(1, 3)
+        %t20 = aie.tile(2, 0)
+        %t22 = aie.tile(2, 2)
+        %t30 = aie.tile(3, 0)
+        %t31 = aie.tile(3, 1)
+        %t60 = aie.tile(6, 0)
+        %t70 = aie.tile(7, 0)
+        %t73 = aie.tile(7, 3)
+
+        aie.flow(%t03, DMA : 0, %t70, DMA : 0)
+        aie.flow(%t13, DMA : 0, %t70, DMA : 1)
+        aie.flow(%t02, DMA : 0, %t60, DMA : 0)
+        aie.flow(%t22, DMA : 0, %t60, DMA : 1)
+
+        aie.flow(%t03, Core : 0, %t13, Core : 0)
+        aie.flow(%t03, Core : 1, %t02, Core : 0)
+        aie.flow(%t13, Core : 1, %t22, Core : 0)
+        aie.flow(%t02, Core : 1, %t22, Core : 1)
+
+        aie.flow(%t73, DMA : 0, %t20, DMA : 0)
+        aie.flow(%t73, DMA : 1, %t30, DMA : 0)
+        aie.flow(%t31, DMA : 0, %t20, DMA : 1)
+        aie.flow(%t31, DMA : 1, %t30, DMA : 1)
+
+        aie.packet_flow(0x10) {
+          aie.packet_source<%t11, Core : 0>
+          aie.packet_dest<%t73, Core : 0>
+          aie.packet_dest<%t31, Core : 0>
+        }
+        aie.packet_flow(0x11) {
+          aie.packet_source<%t11, Core : 0>
+          aie.packet_dest<%t73, Core : 1>
+        }
+    }
+}
@@ -0,0 +1,84 @@
+//===- route_length_report.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="report-route-length=true" --split-input-file --verify-diagnostics %s
+
+module {
+    aie.device(xcvc1902) {
+        %t20 = aie.tile(2, 0)
+        %t11 = aie.tile(1, 1)
+        %t13 = aie.tile(1, 3)
+        %t32 = aie.tile(3, 2)
+        %t33 = aie.tile(3, 3)
+        %t71 = aie.tile(7, 1)
+
+        // expected-remark@+1 {{routed through 7 switchboxes}}
+        aie.flow(%t71, DMA : 0, %t20, DMA : 0) {criticality = 2 : i32}
+        // expected-remark@+1 {{routed through 3 switchboxes}}
+        aie.flow(%t13, DMA : 0, %t33, DMA : 0)
+
+        aie.packet_flow(0x1) {
+          aie.packet_source<%t32, DMA : 1>
+          // expected-remark@+1 {{routed through 4 switchboxes}}
+          aie.packet_dest<%t11, DMA : 1>
+        } {criticality = 1 : i32}
+    }
+}
+
+// -----
+
+// Five flows cross the four eastward channels between tiles (1, 2) and
+// (2, 2), so one of them has to go around through another row. The flows are
+// routed in order, and the last one takes the detour.
+
+module {
+    aie.device(xcvc1902) {
+        %t02 = aie.tile(0, 2)
+        %t12 = aie.tile(1, 2)
+        %t32 = aie.tile(3, 2)
+        %t42 = aie.tile(4, 2)
+
+        // expected-remark@+1 {{routed through 3 switchboxes}}
+        aie.flow(%t12, DMA : 0, %t32, DMA : 0)
+        // expected-remark@+1 {{routed through 3 switchboxes}}
+        aie.flow(%t12, DMA : 1, %t32, DMA : 1)
+        // expected-remark@+1 {{routed through 3 switchboxes}}
+        aie.flow(%t12, Core : 0, %t32, Core : 0)
+        // expected-remark@+1 {{routed through 3 switchboxes}}
+        aie.flow(%t12, Core : 1, %t32, Core : 1)
+        // expected-remark@+1 {{routed through 7 switchboxes}}
+        aie.flow(%t02, DMA : 0, %t42, DMA : 0)
+    }
+}
+
+// -----
+
+// The same flows, with the last one critical: it is routed first and keeps
+// the straight path, and the flow now routed last takes the detour instead.
+
+module {
+    aie.device(xcvc1902) {
+        %t02 = aie.tile(0, 2)
+        %t12 = aie.tile(1, 2)
+        %t32 = aie.tile(3, 2)
+        %t42 = aie.tile(4, 2)
+
+        // expected-remark@+1 {{routed through 3 switchboxes}}
+        aie.flow(%t12, DMA : 0, %t32, DMA : 0)
+        // expected-remark@+1 {{routed through 3 switchboxes}}
+        aie.flow(%t12, DMA : 1, %t32, DMA : 1)
+        // expected-remark@+1 {{routed through 3 switchboxes}}
+        aie.flow(%t12, Core : 0, %t32, Core : 0)
+        // expected-remark@+1 {{routed through 5 switchboxes}}
+        aie.flow(%t12, Core : 1, %t32, Core : 1)
+        // expected-remark@+1 {{routed through 5 switchboxes}}
+        aie.flow(%t02, DMA : 0, %t42, DMA : 0) {criticality = 1 : i32}
+    }
+}
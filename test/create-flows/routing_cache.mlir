@@ -0,0 +1,61 @@
+//===- routing_cache.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The first run stores the routing in the cache, the second one reuses it.
+
+// RUN: rm -rf %t.cache
+// RUN: aie-opt --aie-create-pathfinder-flows %s -o %t.uncached.mlir
+// RUN: aie-opt --aie-create-pathfinder-flows="cache-dir=%t.cache" %s \
+// RUN:   -mlir-pass-statistics -o %t.first.mlir 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=MISS
+// RUN: cat %t.cache/*.routing | FileCheck %s --check-prefix=CACHE
+// RUN: aie-opt --aie-create-pathfinder-flows="cache-dir=%t.cache" %s \
+// RUN:   -mlir-pass-statistics -o %t.second.mlir 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=HIT
+// RUN: diff %t.uncached.mlir %t.first.mlir
+// RUN: diff %t.uncached.mlir %t.second.mlir
+// RUN: aie-opt --aie-find-flows %t.second.mlir | FileCheck %s
+
+// MISS: (S) 0 routing-cache-hits
+// MISS: (S) 1 routing-cache-misses
+
+// HIT: (S) 1 routing-cache-hits
+// HIT: (S) 0 routing-cache-misses
+
+// CACHE: aie-routing-cache
+// CACHE-NEXT: router pathfinder 0 0
+// CACHE-NEXT: device xcvc1902 7 3
+// CACHE-NEXT: target-model
+// CACHE: routing
+// CACHE-NEXT: flow
+
+// CHECK: %[[T20:.*]] = aie.tile(2, 0)
+// CHECK: %[[T71:.*]] = aie.tile(7, 1)
+// CHECK: %[[T73:.*]] = aie.tile(7, 3)
+// CHECK-DAG: aie.flow(%[[T71]], DMA : 0, %[[T20]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T73]], DMA : 0, %[[T20]], DMA : 1)
+// CHECK-DAG: aie.packet_source<%[[T73]], DMA : 1>
+// CHECK-DAG: aie.packet_dest<%[[T71]], DMA : 1>
+
+module {
+    aie.device(xcvc1902) {
+        %t20 = aie.tile(2, 0)
+        %t71 = aie.tile(7, 1)
+        %t73 = aie.tile(7, 3)
+
+        aie.flow(%t71, DMA : 0, %t20, DMA : 0)
+        aie.flow(%t73, DMA : 0, %t20, DMA : 1)
+
+        aie.packet_flow(0x1) {
+          aie.packet_source<%t73, DMA : 1>
+          aie.packet_dest<%t71, DMA : 1>
+        }
+    }
+}
@@ -0,0 +1,67 @@
+//===- steiner_routing.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="router=steiner" --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="router=steiner" %s | FileCheck %s --check-prefix=SB
+// RUN: not aie-opt --aie-create-pathfinder-flows="router=maze" %s 2>&1 | FileCheck %s --check-prefix=UNKNOWN
+
+// CHECK: %[[T20:.*]] = aie.tile(2, 0)
+// CHECK: %[[T23:.*]] = aie.tile(2, 3)
+// CHECK: %[[T24:.*]] = aie.tile(2, 4)
+// CHECK: %[[T33:.*]] = aie.tile(3, 3)
+// CHECK: %[[T34:.*]] = aie.tile(3, 4)
+// CHECK: %[[T43:.*]] = aie.tile(4, 3)
+// CHECK: %[[T44:.*]] = aie.tile(4, 4)
+//
+// CHECK-DAG: aie.flow(%[[T20]], DMA : 0, %[[T23]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T20]], DMA : 0, %[[T24]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T20]], DMA : 0, %[[T33]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T20]], DMA : 0, %[[T34]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T20]], DMA : 0, %[[T43]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T20]], DMA : 0, %[[T44]], DMA : 0)
+// CHECK-DAG: aie.packet_source<%[[T23]], DMA : 1>
+// CHECK-DAG: aie.packet_dest<%[[T34]], DMA : 1>
+// CHECK-DAG: aie.packet_dest<%[[T44]], DMA : 1>
+
+// The broadcast comes up column 2, and the switchbox of tile (2, 3) both
+// delivers it to its own DMA and forwards it north to tile (2, 4), from the
+// same input port.
+
+// SB-LABEL: aie.switchbox(%tile_2_3) {
+// SB-DAG:     aie.connect<South : [[IN:[0-9]+]], DMA : 0>
+// SB-DAG:     aie.connect<South : [[IN]], North : {{[0-9]+}}>
+// SB:       }
+
+// UNKNOWN: error: unknown router 'maze'
+
+module {
+    aie.device(xcvc1902) {
+        %t20 = aie.tile(2, 0)
+        %t23 = aie.tile(2, 3)
+        %t24 = aie.tile(2, 4)
+        %t33 = aie.tile(3, 3)
+        %t34 = aie.tile(3, 4)
+        %t43 = aie.tile(4, 3)
+        %t44 = aie.tile(4, 4)
+
+        aie.flow(%t20, DMA : 0, %t23, DMA : 0)
+        aie.flow(%t20, DMA : 0, %t24, DMA : 0)
+        aie.flow(%t20, DMA : 0, %t33, DMA : 0)
+        aie.flow(%t20, DMA : 0, %t34, DMA : 0)
+        aie.flow(%t20, DMA : 0, %t43, DMA : 0)
+        aie.flow(%t20, DMA : 0, %t44, DMA : 0)
+
+        aie.packet_flow(0x1) {
+          aie.packet_source<%t23, DMA : 1>
+          aie.packet_dest<%t34, DMA : 1>
+          aie.packet_dest<%t44, DMA : 1>
+        }
+    }
+}
@@ -0,0 +1,112 @@
+// RUN: aie-opt %s -split-input-file -lower-affine --aievec-fuse-normalization-loops | FileCheck %s
+// RUN: aie-opt %s -split-input-file -lower-affine \
+// RUN:   --canonicalize-vector-for-aievec="aie-target=aie2 fuse-normalization-loops=true" \
+// RUN:   | FileCheck %s --check-prefix=PIPELINE
+// RUN: aie-opt %s -split-input-file -lower-affine \
+// RUN:   --canonicalize-vector-for-aievec="aie-target=aie2" \
+// RUN:   | FileCheck %s --check-prefix=DEFAULT
+
+// The pass matches scf.for loops only, so affine kernels are lowered first.
+// The canonicalize-vector-for-aievec pipeline only runs it when asked to.
+
+// The bf16_softmax_2 kernel of the AIE2 unit tests computes the exponentials
+// in a loop of their own, which stores them, and sums them in the next one
+// at another step. It is left as is.
+
+// CHECK-LABEL: func.func @bf16_softmax_2(
+// CHECK:         scf.for {{.*}} -> (vector<32xbf16>)
+// CHECK:           arith.maximumf
+// CHECK:         vector.reduction <maximumf>
+// CHECK:         scf.for
+// CHECK:           math.exp
+// CHECK:           memref.store
+// CHECK:         scf.for {{.*}} -> (f32)
+// CHECK:           arith.addf
+// CHECK:         scf.for
+// CHECK:           arith.mulf
+// PIPELINE-LABEL: func.func @bf16_softmax_2(
+// DEFAULT-LABEL: func.func @bf16_softmax_2(
+func.func @bf16_softmax_2(%arg0: memref<1024xbf16>, %arg1: memref<1024xbf16>) {
+  %cst = arith.constant 0.000000e+00 : f32
+  %cst_0 = arith.constant 1.000000e+00 : f32
+  %cst_1 = arith.constant 0.000000e+00 : bf16
+  %cst_2 = arith.constant dense<0xFF80> : vector<32xbf16>
+  %0 = affine.for %arg2 = 0 to 1024 step 32 iter_args(%arg3 = %cst_2) -> (vector<32xbf16>) {
+    %5 = vector.transfer_read %arg0[%arg2], %cst_1 : memref<1024xbf16>, vector<32xbf16>
+    %6 = arith.maximumf %arg3, %5 : vector<32xbf16>
+    affine.yield %6 : vector<32xbf16>
+  }
+  %1 = vector.reduction <maximumf>, %0 : vector<32xbf16> into bf16
+  affine.for %arg2 = 0 to 1024 {
+    %5 = affine.load %arg0[%arg2] : memref<1024xbf16>
+    %6 = arith.subf %5, %1 : bf16
+    %7 = math.exp %6 : bf16
+    affine.store %7, %arg0[%arg2] : memref<1024xbf16>
+  }
+  %2 = affine.for %arg2 = 0 to 1024 iter_args(%arg3 = %cst) -> (f32) {
+    %5 = affine.load %arg0[%arg2] : memref<1024xbf16>
+    %6 = arith.extf %5 : bf16 to f32
+    %7 = arith.addf %arg3, %6 : f32
+    affine.yield %7 : f32
+  }
+  %3 = arith.divf %cst_0, %2 : f32
+  %4 = arith.truncf %3 : f32 to bf16
+  affine.for %arg2 = 0 to 1024 {
+    %5 = affine.load %arg0[%arg2] : memref<1024xbf16>
+    %6 = arith.mulf %5, %4 : bf16
+    affine.store %6, %arg1[%arg2] : memref<1024xbf16>
+  }
+  return
+}
+
+// -----
+
+// The same kernel, with the exponentials summed lane-wise where they are
+// computed, at the step of the max loop, becomes a single online loop.
+
+// CHECK-LABEL: func.func @bf16_softmax_2_sum(
+// CHECK:         %[[ZERO:.*]] = arith.constant dense<0.000000e+00> : vector<32xbf16>
+// CHECK:         %[[LOW:.*]] = arith.constant dense<0xFF80> : vector<32xbf16>
+// CHECK:         %[[STATS:.*]]:2 = scf.for {{.*}} iter_args(%[[M:.*]] = %{{.*}}, %{{.*}} = %{{.*}}) -> (vector<32xbf16>, vector<32xf32>)
+// CHECK:           %[[NM:.*]] = arith.maximumf %[[M]]
+// CHECK:           %[[ISLOW:.*]] = arith.cmpf oeq, %[[NM]], %[[LOW]]
+// CHECK:           %[[FM:.*]] = arith.select %[[ISLOW]], %[[ZERO]], %[[NM]]
+// CHECK:           arith.subf %[[M]], %[[FM]]
+// CHECK:           math.exp
+// CHECK:           %[[X:.*]] = vector.transfer_read
+// CHECK:           arith.subf %[[X]], %[[FM]]
+// CHECK:           math.exp
+// CHECK:           scf.yield %[[NM]]
+// CHECK:         }
+// CHECK:         vector.reduction <maximumf>, %[[STATS]]#0
+// CHECK:         %[[SUM:.*]] = arith.mulf %[[STATS]]#1
+// CHECK:         vector.reduction <add>, %[[SUM]]
+// CHECK-NOT:     scf.for
+// PIPELINE-LABEL: func.func @bf16_softmax_2_sum(
+// PIPELINE:         scf.for {{.*}} -> (vector<32xbf16>, vector<32xf32>)
+// PIPELINE-NOT:     scf.for
+// DEFAULT-LABEL: func.func @bf16_softmax_2_sum(
+// DEFAULT:         scf.for {{.*}} -> (vector<32xbf16>)
+// DEFAULT:         scf.for {{.*}} -> (vector<32xf32>)
+func.func @bf16_softmax_2_sum(%arg0: memref<1024xbf16>) -> f32 {
+  %cst = arith.constant dense<0.000000e+00> : vector<32xf32>
+  %cst_1 = arith.constant 0.000000e+00 : bf16
+  %cst_2 = arith.constant dense<0xFF80> : vector<32xbf16>
+  %0 = affine.for %arg2 = 0 to 1024 step 32 iter_args(%arg3 = %cst_2) -> (vector<32xbf16>) {
+    %5 = vector.transfer_read %arg0[%arg2], %cst_1 : memref<1024xbf16>, vector<32xbf16>
+    %6 = arith.maximumf %arg3, %5 : vector<32xbf16>
+    affine.yield %6 : vector<32xbf16>
+  }
+  %1 = vector.reduction <maximumf>, %0 : vector<32xbf16> into bf16
+  %2 = vector.broadcast %1 : bf16 to vector<32xbf16>
+  %3 = affine.for %arg2 = 0 to 1024 step 32 iter_args(%arg3 = %cst) -> (vector<32xf32>) {
+    %5 = vector.transfer_read %arg0[%arg2], %cst_1 : memref<1024xbf16>, vector<32xbf16>
+    %6 = arith.subf %5, %2 : vector<32xbf16>
+    %7 = math.exp %6 : vector<32xbf16>
+    %8 = arith.extf %7 : vector<32xbf16> to vector<32xf32>
+    %9 = arith.addf %arg3, %8 : vector<32xf32>
+    affine.yield %9 : vector<32xf32>
+  }
+  %4 = vector.reduction <add>, %3 : vector<32xf32> into f32
+  return %4 : f32
+}
@@ -0,0 +1,210 @@
+// RUN: aie-opt %s -split-input-file --aievec-fuse-normalization-loops | FileCheck %s
+
+// A three-pass softmax, which stores the exponentials and normalizes them in
+// place, becomes an online max and sum loop followed by a loop that
+// recomputes the exponentials from the input. Lanes whose running max is
+// still -inf subtract 0 instead, so that they add exp(-inf) = 0, not NaN.
+
+// CHECK-LABEL: func.func @softmax(
+// CHECK-SAME:      %[[IN:.*]]: memref<1024xbf16>, %[[OUT:.*]]: memref<1024xbf16>)
+// CHECK:         %[[ZERO:.*]] = arith.constant dense<0.000000e+00> : vector<16xbf16>
+// CHECK:         %[[LOW:.*]] = arith.constant dense<0xFF80> : vector<16xbf16>
+// CHECK:         %[[STATS:.*]]:2 = scf.for %[[I:.*]] = {{.*}} iter_args(%[[M:.*]] = %{{.*}}, %[[S:.*]] = %{{.*}}) -> (vector<16xbf16>, vector<16xf32>)
+// CHECK:           %[[X:.*]] = vector.transfer_read %[[IN]][%[[I]]]
+// CHECK:           %[[NM:.*]] = arith.maximumf %[[M]], %[[X]]
+// CHECK:           %[[ISLOW:.*]] = arith.cmpf oeq, %[[NM]], %[[LOW]]
+// CHECK:           %[[FM:.*]] = arith.select %[[ISLOW]], %[[ZERO]], %[[NM]]
+// CHECK:           %[[D:.*]] = arith.subf %[[M]], %[[FM]]
+// CHECK:           %[[R:.*]] = math.exp %[[D]]
+// CHECK:           %[[RF:.*]] = arith.extf %[[R]]
+// CHECK:           %[[SS:.*]] = arith.mulf %[[S]], %[[RF]]
+// CHECK:           %[[X2:.*]] = vector.transfer_read %[[IN]][%[[I]]]
+// CHECK:           %[[D2:.*]] = arith.subf %[[X2]], %[[FM]]
+// CHECK:           %[[E:.*]] = math.exp %[[D2]]
+// CHECK-NOT:       vector.transfer_write
+// CHECK:           %[[EF:.*]] = arith.extf %[[E]]
+// CHECK:           %[[NS:.*]] = arith.addf %[[SS]], %[[EF]]
+// CHECK:           scf.yield %[[NM]], %[[NS]]
+// CHECK:         }
+// CHECK:         %[[RMAX:.*]] = vector.reduction <maximumf>, %[[STATS]]#0
+// CHECK:         %[[BMAX:.*]] = vector.broadcast %[[RMAX]]
+// CHECK:         %[[ISLOW3:.*]] = arith.cmpf oeq, %[[STATS]]#0, %[[LOW]]
+// CHECK:         %[[FM3:.*]] = arith.select %[[ISLOW3]], %[[ZERO]], %[[STATS]]#0
+// CHECK:         %[[D3:.*]] = arith.subf %[[FM3]], %[[BMAX]]
+// CHECK:         %[[E3:.*]] = math.exp %[[D3]]
+// CHECK:         %[[E3F:.*]] = arith.extf %[[E3]]
+// CHECK:         %[[SUM:.*]] = arith.mulf %[[STATS]]#1, %[[E3F]]
+// CHECK:         vector.reduction <add>, %[[SUM]]
+// CHECK:         scf.for %[[J:.*]] =
+// CHECK:           %[[XJ:.*]] = vector.transfer_read %[[IN]][%[[J]]]
+// CHECK:           %[[DJ:.*]] = arith.subf %[[XJ]], %[[BMAX]]
+// CHECK:           %[[EJ:.*]] = math.exp %[[DJ]]
+// CHECK:           %[[NJ:.*]] = arith.mulf %[[EJ]]
+// CHECK:           vector.transfer_write %[[NJ]], %[[OUT]][%[[J]]]
+func.func @softmax(%in : memref<1024xbf16>, %out : memref<1024xbf16>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c1024 = arith.constant 1024 : index
+  %pad = arith.constant 0.0 : bf16
+  %one = arith.constant 1.0 : f32
+  %lowest = arith.constant dense<0xFF80> : vector<16xbf16>
+  %zero = arith.constant dense<0.0> : vector<16xf32>
+  %max = scf.for %i = %c0 to %c1024 step %c16 iter_args(%m = %lowest)
+      -> (vector<16xbf16>) {
+    %x = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+           : memref<1024xbf16>, vector<16xbf16>
+    %nm = arith.maximumf %m, %x : vector<16xbf16>
+    scf.yield %nm : vector<16xbf16>
+  }
+  %rmax = vector.reduction <maximumf>, %max : vector<16xbf16> into bf16
+  %bmax = vector.broadcast %rmax : bf16 to vector<16xbf16>
+  %sum = scf.for %i = %c0 to %c1024 step %c16 iter_args(%s = %zero)
+      -> (vector<16xf32>) {
+    %x = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+           : memref<1024xbf16>, vector<16xbf16>
+    %d = arith.subf %x, %bmax : vector<16xbf16>
+    %e = math.exp %d : vector<16xbf16>
+    vector.transfer_write %e, %out[%i] {in_bounds = [true]}
+      : vector<16xbf16>, memref<1024xbf16>
+    %ef = arith.extf %e : vector<16xbf16> to vector<16xf32>
+    %ns = arith.addf %s, %ef : vector<16xf32>
+    scf.yield %ns : vector<16xf32>
+  }
+  %rsum = vector.reduction <add>, %sum : vector<16xf32> into f32
+  %inv = arith.divf %one, %rsum : f32
+  %invb = arith.truncf %inv : f32 to bf16
+  %binv = vector.broadcast %invb : bf16 to vector<16xbf16>
+  scf.for %i = %c0 to %c1024 step %c16 {
+    %e = vector.transfer_read %out[%i], %pad {in_bounds = [true]}
+           : memref<1024xbf16>, vector<16xbf16>
+    %r = arith.mulf %e, %binv : vector<16xbf16>
+    vector.transfer_write %r, %out[%i] {in_bounds = [true]}
+      : vector<16xbf16>, memref<1024xbf16>
+  }
+  return
+}
+
+// -----
+
+// The mean and the sum of squared deviations of a layernorm come from a
+// single loop that sums x, and x - pivot and its squares, with the pivot read
+// from the first tile so that the squares do not cancel out.
+
+// CHECK-LABEL: func.func @layernorm(
+// CHECK-SAME:      %[[IN:.*]]: memref<1024xf32>)
+// CHECK:         %[[ZERO:.*]] = arith.constant dense<0.000000e+00> : vector<16xf32>
+// CHECK:         %[[PIVOT:.*]] = vector.transfer_read %[[IN]][%c0{{.*}}]
+// CHECK:         %[[STATS:.*]]:3 = scf.for {{.*}} iter_args({{.*}}, {{.*}}, %{{.*}} = %[[ZERO]])
+// CHECK:           %[[X:.*]] = vector.transfer_read
+// CHECK:           %[[S:.*]] = arith.addf %{{.*}}, %[[X]]
+// CHECK:           %[[X2:.*]] = vector.transfer_read
+// CHECK:           %[[D:.*]] = arith.subf %[[X2]], %[[PIVOT]] : vector<16xf32>
+// CHECK:           %[[SQ:.*]] = arith.mulf %[[D]], %[[D]]
+// CHECK:           %[[Q:.*]] = arith.addf %{{.*}}, %[[SQ]]
+// CHECK:           %[[XP:.*]] = arith.subf %[[X]], %[[PIVOT]]
+// CHECK:           %[[SP:.*]] = arith.addf %{{.*}}, %[[XP]]
+// CHECK:           scf.yield %[[S]], %[[Q]], %[[SP]]
+// CHECK:         }
+// CHECK:         %[[MEAN:.*]] = arith.mulf
+// CHECK:         %[[TWO:.*]] = arith.constant dense<2.000000e+00>
+// CHECK:         %[[N:.*]] = arith.constant dense<6.400000e+01>
+// CHECK:         %[[SHIFT:.*]] = arith.subf %[[MEAN]], %[[PIVOT]]
+// CHECK:         %[[MS:.*]] = arith.mulf %[[SHIFT]], %[[STATS]]#2
+// CHECK:         %[[CROSS:.*]] = arith.mulf %[[TWO]], %[[MS]]
+// CHECK:         %[[SS:.*]] = arith.mulf %[[SHIFT]], %[[SHIFT]]
+// CHECK:         %[[SQUARE:.*]] = arith.mulf %[[N]], %[[SS]]
+// CHECK:         %[[DIFF:.*]] = arith.subf %[[STATS]]#1, %[[CROSS]]
+// CHECK:         %[[VAR:.*]] = arith.addf %[[DIFF]], %[[SQUARE]]
+// CHECK:         return %[[MEAN]], %[[VAR]]
+func.func @layernorm(
+// CHECK:         %[[STATS:.*]]:2 = scf.for
+// CHECK:           %[[X:.*]] = vector.transfer_read
+// CHECK:           %[[S:.*]] = arith.addf %{{.*}}, %[[X]]
+// CHECK:           %[[X2:.*]] = vector.transfer_read
+// CHECK:           %[[D:.*]] = arith.subf %[[X2]], %{{.*}} : vector<16xf32>
+// CHECK:           %[[SQ:.*]] = arith.mulf %[[D]], %[[D]]
+// CHECK:           %[[Q:.*]] = arith.addf %{{.*}}, %[[SQ]]
+// CHECK:           scf.yield %[[S]], %[[Q]]
+// CHECK:         }
+// CHECK:         %[[MEAN:.*]] = arith.mulf
+// CHECK:         %[[TWO:.*]] = arith.constant dense<2.000000e+00>
+// CHECK:         %[[N:.*]] = arith.constant dense<6.400000e+01>
+// CHECK:         %[[SX:.*]] = arith.subf %[[STATS]]#0, %{{.*}}
+// CHECK:         %[[MS:.*]] = arith.mulf %[[MEAN]], %[[SX]]
+// CHECK:         %[[CROSS:.*]] = arith.mulf %[[TWO]], %[[MS]]
+// CHECK:         %[[MM:.*]] = arith.mulf %[[MEAN]], %[[MEAN]]
+// CHECK:         %[[SQUARE:.*]] = arith.mulf %[[N]], %[[MM]]
+// CHECK:         %[[DIFF:.*]] = arith.subf %[[STATS]]#1, %[[CROSS]]
+// CHECK:         %[[VAR:.*]] = arith.addf %[[DIFF]], %[[SQUARE]]
+// CHECK:         return %[[MEAN]], %[[VAR]]
+func.func @layernorm(%in : memref<1024xf32>)
+    -> (vector<16xf32>, vector<16xf32>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c1024 = arith.constant 1024 : index
+  %pad = arith.constant 0.0 : f32
+  %zero = arith.constant dense<0.0> : vector<16xf32>
+  %inv_n = arith.constant dense<9.765625e-04> : vector<16xf32>
+  %sum = scf.for %i = %c0 to %c1024 step %c16 iter_args(%s = %zero)
+      -> (vector<16xf32>) {
+    %x = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+           : memref<1024xf32>, vector<16xf32>
+    %ns = arith.addf %s, %x : vector<16xf32>
+    scf.yield %ns : vector<16xf32>
+  }
+  %rsum = vector.reduction <add>, %sum : vector<16xf32> into f32
+  %bsum = vector.broadcast %rsum : f32 to vector<16xf32>
+  %mean = arith.mulf %bsum, %inv_n : vector<16xf32>
+  %sqdev = scf.for %i = %c0 to %c1024 step %c16 iter_args(%q = %zero)
+      -> (vector<16xf32>) {
+    %x = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+           : memref<1024xf32>, vector<16xf32>
+    %d = arith.subf %x, %mean : vector<16xf32>
+    %d2 = arith.mulf %d, %d : vector<16xf32>
+    %nq = arith.addf %q, %d2 : vector<16xf32>
+    scf.yield %nq : vector<16xf32>
+  }
+  return %mean, %sqdev : vector<16xf32>, vector<16xf32>
+}
+
+// -----
+
+// The exponentials are stored for later use, so they cannot be dropped.
+
+// CHECK-LABEL: func.func @exp_stored(
+// CHECK:         scf.for
+// CHECK:           arith.maximumf
+// CHECK:         scf.for
+// CHECK:           math.exp
+// CHECK:           vector.transfer_write
+func.func @exp_stored(%in : memref<1024xbf16>, %out : memref<1024xbf16>)
+    -> vector<16xf32> {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c1024 = arith.constant 1024 : index
+  %pad = arith.constant 0.0 : bf16
+  %lowest = arith.constant dense<0xFF80> : vector<16xbf16>
+  %zero = arith.constant dense<0.0> : vector<16xf32>
+  %max = scf.for %i = %c0 to %c1024 step %c16 iter_args(%m = %lowest)
+      -> (vector<16xbf16>) {
+    %x = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+           : memref<1024xbf16>, vector<16xbf16>
+    %nm = arith.maximumf %m, %x : vector<16xbf16>
+    scf.yield %nm : vector<16xbf16>
+  }
+  %rmax = vector.reduction <maximumf>, %max : vector<16xbf16> into bf16
+  %bmax = vector.broadcast %rmax : bf16 to vector<16xbf16>
+  %sum = scf.for %i = %c0 to %c1024 step %c16 iter_args(%s = %zero)
+      -> (vector<16xf32>) {
+    %x = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+           : memref<1024xbf16>, vector<16xbf16>
+    %d = arith.subf %x, %bmax : vector<16xbf16>
+    %e = math.exp %d : vector<16xbf16>
+    vector.transfer_write %e, %out[%i] {in_bounds = [true]}
+      : vector<16xbf16>, memref<1024xbf16>
+    %ef = arith.extf %e : vector<16xbf16> to vector<16xf32>
+    %ns = arith.addf %s, %ef : vector<16xf32>
+    scf.yield %ns : vector<16xf32>
+  }
+  return %sum : vector<16xf32>
+}
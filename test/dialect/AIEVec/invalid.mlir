@@ -72,3 +72,37 @@ func.func @invalidElementTypeMulElem(%arg0 : vector<32xi8>, %arg1 : vector<32xi8
   %t11 = aievec.mul_elem %arg0, %arg1 : vector<32xi8>, vector<32xi8>, vector<32xi64>
   return %t11 : vector<32xi64>
 }
+
+// -----
+
+// expected-error @+1 {{innermost dimension of a bfp16 vector must be a multiple of 8}}
+func.func @invalidBFP16Shape(%arg0 : !aievec.bfp16<8x4>) {
+  return
+}
+
+// -----
+
+func.func @invalidPackBFPShape(%arg0 : vector<16xbf16>) -> !aievec.bfp16<2x8> {
+  // expected-error @+1 {{'aievec.pack_bfp' op source and result must have the same shape}}
+  %0 = aievec.pack_bfp %arg0 : vector<16xbf16> -> !aievec.bfp16<2x8>
+  return %0 : !aievec.bfp16<2x8>
+}
+
+// -----
+
+func.func @invalidMatMulBFPShape(%arg0 : !aievec.bfp16<4x16>,
+                                 %arg1 : !aievec.bfp16<16x8>,
+                                 %arg2 : vector<4x8xf32>) -> vector<4x8xf32> {
+  // expected-error @+1 {{'aievec.matmul_bfp' op unsupported matrix multiplication shape, expected 8x8 by 8x8}}
+  %0 = aievec.matmul_bfp %arg0, %arg1, %arg2 : !aievec.bfp16<4x16>,
+                                               !aievec.bfp16<16x8> into vector<4x8xf32>
+  return %0 : vector<4x8xf32>
+}
+
+// -----
+
+func.func @invalidPackI4(%arg0 : vector<32xi16>) -> vector<32xi4> {
+  // expected-error @+1 {{'aievec.pack' op output must be an int8 vector}}
+  %0 = aievec.pack %arg0 : vector<32xi16>, vector<32xi4>
+  return %0 : vector<32xi4>
+}
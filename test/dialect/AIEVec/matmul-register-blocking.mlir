@@ -0,0 +1,254 @@
+// RUN: aie-opt %s -split-input-file --aievec-matmul-register-blocking | FileCheck %s
+// RUN: aie-opt %s -split-input-file \
+// RUN:   --aievec-matmul-register-blocking="block-m=1 block-n=2" \
+// RUN:   | FileCheck %s --check-prefix=FIXED
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// bf16 4x8x4 tiles with 4x4xf32 accumulators: one accumulator register and
+// one vector register per tile, so the loaded tiles bound the blocking.
+
+// CHECK-LABEL: func.func @bf16_affine(
+// CHECK-SAME:      %[[A:.*]]: memref<8x4x4x8xbf16> {llvm.noalias},
+// CHECK-SAME:      %[[B:.*]]: memref<4x8x8x4xbf16> {llvm.noalias},
+// CHECK-SAME:      %[[C:.*]]: memref<8x8x4x4xf32> {llvm.noalias})
+// CHECK:         affine.for %{{.*}} = 0 to 8 step 2 {
+// CHECK:           affine.for %{{.*}} = 0 to 8 step 4 {
+// CHECK-COUNT-8:     vector.transfer_read %[[C]]
+// CHECK:             %[[ACCS:.*]]:8 = affine.for %{{.*}} = 0 to 4
+// CHECK-SAME:            iter_args(
+// CHECK-COUNT-2:       vector.transfer_read %[[A]]
+// CHECK-COUNT-4:       vector.transfer_read %[[B]]
+// CHECK-COUNT-8:       vector.contract
+// CHECK:               affine.yield
+// CHECK:             }
+// CHECK-COUNT-8:     vector.transfer_write %[[ACCS]]#{{[0-7]}}, %[[C]]
+// CHECK-NOT:         vector.contract
+// FIXED-LABEL: func.func @bf16_affine(
+// FIXED:         affine.for %{{.*}} = 0 to 8 {
+// FIXED:           affine.for %{{.*}} = 0 to 8 step 2 {
+// FIXED:             affine.for {{.*}} iter_args({{[^,]*}}, {{[^,]*}}) ->
+// FIXED-SAME:            (vector<4x4xf32>, vector<4x4xf32>)
+func.func @bf16_affine(%A : memref<8x4x4x8xbf16> {llvm.noalias},
+                       %B : memref<4x8x8x4xbf16> {llvm.noalias},
+                       %C : memref<8x8x4x4xf32> {llvm.noalias}) {
+  %c0 = arith.constant 0 : index
+  %c0_bf16 = arith.constant 0.0 : bf16
+  %c0_f32 = arith.constant 0.0 : f32
+  affine.for %i = 0 to 8 {
+    affine.for %j = 0 to 8 {
+      affine.for %k = 0 to 4 {
+        %a = vector.transfer_read %A[%i, %k, %c0, %c0], %c0_bf16
+               {in_bounds = [true, true]} : memref<8x4x4x8xbf16>, vector<4x8xbf16>
+        %b = vector.transfer_read %B[%k, %j, %c0, %c0], %c0_bf16
+               {in_bounds = [true, true]} : memref<4x8x8x4xbf16>, vector<8x4xbf16>
+        %c = vector.transfer_read %C[%i, %j, %c0, %c0], %c0_f32
+               {in_bounds = [true, true]} : memref<8x8x4x4xf32>, vector<4x4xf32>
+        %af = arith.extf %a : vector<4x8xbf16> to vector<4x8xf32>
+        %bf = arith.extf %b : vector<8x4xbf16> to vector<8x4xf32>
+        %r = vector.contract {indexing_maps = [#map, #map1, #map2],
+                              iterator_types = ["parallel", "parallel", "reduction"],
+                              kind = #vector.kind<add>} %af, %bf, %c
+               : vector<4x8xf32>, vector<8x4xf32> into vector<4x4xf32>
+        vector.transfer_write %r, %C[%i, %j, %c0, %c0] {in_bounds = [true, true]}
+               : vector<4x4xf32>, memref<8x8x4x4xf32>
+      }
+    }
+  }
+  return
+}
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// i8 4x8x8 tiles with 4x8xi32 accumulators, which take two accumulator
+// registers each. The lhs tiles are half the size of the rhs tiles, so the
+// micro-kernel loads more of them. The rhs loop is the outer one here.
+
+// CHECK-LABEL: func.func @i8_scf(
+// CHECK-SAME:      %[[A:.*]]: memref<4x4x4x8xi8> {llvm.noalias},
+// CHECK-SAME:      %[[B:.*]]: memref<4x4x8x8xi8> {llvm.noalias},
+// CHECK-SAME:      %[[C:.*]]: memref<4x4x4x8xi32> {llvm.noalias})
+// CHECK:         scf.for %{{.*}} = %{{.*}} to %{{.*}} step %c2 {
+// CHECK:           scf.for %{{.*}} = %{{.*}} to %{{.*}} step %c4{{.*}} {
+// CHECK-COUNT-8:     vector.transfer_read %[[C]]
+// CHECK:             %[[ACCS:.*]]:8 = scf.for
+// CHECK-COUNT-4:       vector.transfer_read %[[A]]
+// CHECK-COUNT-2:       vector.transfer_read %[[B]]
+// CHECK-COUNT-8:       vector.contract
+// CHECK:               scf.yield
+// CHECK:             }
+// CHECK-COUNT-8:     vector.transfer_write %[[ACCS]]#{{[0-7]}}, %[[C]]
+// FIXED-LABEL: func.func @i8_scf(
+// FIXED:         scf.for {{.*}} iter_args({{[^,]*}}, {{[^,]*}}) ->
+// FIXED-SAME:        (vector<4x8xi32>, vector<4x8xi32>)
+func.func @i8_scf(%A : memref<4x4x4x8xi8> {llvm.noalias},
+                  %B : memref<4x4x8x8xi8> {llvm.noalias},
+                  %C : memref<4x4x4x8xi32> {llvm.noalias}) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c0_i8 = arith.constant 0 : i8
+  %c0_i32 = arith.constant 0 : i32
+  scf.for %j = %c0 to %c4 step %c1 {
+    scf.for %i = %c0 to %c4 step %c1 {
+      scf.for %k = %c0 to %c4 step %c1 {
+        %a = vector.transfer_read %A[%i, %k, %c0, %c0], %c0_i8
+               {in_bounds = [true, true]} : memref<4x4x4x8xi8>, vector<4x8xi8>
+        %b = vector.transfer_read %B[%k, %j, %c0, %c0], %c0_i8
+               {in_bounds = [true, true]} : memref<4x4x8x8xi8>, vector<8x8xi8>
+        %c = vector.transfer_read %C[%i, %j, %c0, %c0], %c0_i32
+               {in_bounds = [true, true]} : memref<4x4x4x8xi32>, vector<4x8xi32>
+        %ai = arith.extsi %a : vector<4x8xi8> to vector<4x8xi32>
+        %bi = arith.extsi %b : vector<8x8xi8> to vector<8x8xi32>
+        %r = vector.contract {indexing_maps = [#map, #map1, #map2],
+                              iterator_types = ["parallel", "parallel", "reduction"],
+                              kind = #vector.kind<add>} %ai, %bi, %c
+               : vector<4x8xi32>, vector<8x8xi32> into vector<4x8xi32>
+        vector.transfer_write %r, %C[%i, %j, %c0, %c0] {in_bounds = [true, true]}
+               : vector<4x8xi32>, memref<4x4x4x8xi32>
+      }
+    }
+  }
+  return
+}
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// The accumulator is indexed by the reduction loop, so it cannot be kept in
+// registers across it.
+
+// CHECK-LABEL: func.func @acc_indexed_by_k(
+// CHECK:         affine.for %{{.*}} = 0 to 8 {
+// CHECK:           affine.for %{{.*}} = 0 to 8 {
+// CHECK:             affine.for %{{.*}} = 0 to 4 {
+// CHECK-COUNT-1:       vector.contract
+// CHECK-NOT:           vector.contract
+// FIXED-LABEL: func.func @acc_indexed_by_k(
+// FIXED-COUNT-1: vector.contract
+// FIXED-NOT:     vector.contract
+func.func @acc_indexed_by_k(%A : memref<8x4x4x8xbf16>,
+                            %B : memref<4x8x8x4xbf16>,
+                            %C : memref<8x4x4x4xf32>) {
+  %c0 = arith.constant 0 : index
+  %c0_bf16 = arith.constant 0.0 : bf16
+  %c0_f32 = arith.constant 0.0 : f32
+  affine.for %i = 0 to 8 {
+    affine.for %j = 0 to 8 {
+      affine.for %k = 0 to 4 {
+        %a = vector.transfer_read %A[%i, %k, %c0, %c0], %c0_bf16
+               {in_bounds = [true, true]} : memref<8x4x4x8xbf16>, vector<4x8xbf16>
+        %b = vector.transfer_read %B[%k, %j, %c0, %c0], %c0_bf16
+               {in_bounds = [true, true]} : memref<4x8x8x4xbf16>, vector<8x4xbf16>
+        %c = vector.transfer_read %C[%i, %k, %c0, %c0], %c0_f32
+               {in_bounds = [true, true]} : memref<8x4x4x4xf32>, vector<4x4xf32>
+        %af = arith.extf %a : vector<4x8xbf16> to vector<4x8xf32>
+        %bf = arith.extf %b : vector<8x4xbf16> to vector<8x4xf32>
+        %r = vector.contract {indexing_maps = [#map, #map1, #map2],
+                              iterator_types = ["parallel", "parallel", "reduction"],
+                              kind = #vector.kind<add>} %af, %bf, %c
+               : vector<4x8xf32>, vector<8x4xf32> into vector<4x4xf32>
+        vector.transfer_write %r, %C[%i, %k, %c0, %c0] {in_bounds = [true, true]}
+               : vector<4x4xf32>, memref<8x4x4x4xf32>
+      }
+    }
+  }
+  return
+}
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// Without llvm.noalias, the lhs and rhs arguments may be views of the
+// accumulators, whose writes cannot be sunk past their loads.
+
+// CHECK-LABEL: func.func @may_alias(
+// CHECK:         affine.for %{{.*}} = 0 to 8 {
+// CHECK:           affine.for %{{.*}} = 0 to 8 {
+// CHECK:             affine.for %{{.*}} = 0 to 4 {
+// CHECK-COUNT-1:       vector.contract
+// CHECK-NOT:           vector.contract
+// FIXED-LABEL: func.func @may_alias(
+// FIXED-COUNT-1: vector.contract
+// FIXED-NOT:     vector.contract
+func.func @may_alias(%A : memref<8x4x4x8xbf16>, %B : memref<4x8x8x4xbf16>,
+                     %C : memref<8x8x4x4xf32>) {
+  %c0 = arith.constant 0 : index
+  %c0_bf16 = arith.constant 0.0 : bf16
+  %c0_f32 = arith.constant 0.0 : f32
+  affine.for %i = 0 to 8 {
+    affine.for %j = 0 to 8 {
+      affine.for %k = 0 to 4 {
+        %a = vector.transfer_read %A[%i, %k, %c0, %c0], %c0_bf16
+               {in_bounds = [true, true]} : memref<8x4x4x8xbf16>, vector<4x8xbf16>
+        %b = vector.transfer_read %B[%k, %j, %c0, %c0], %c0_bf16
+               {in_bounds = [true, true]} : memref<4x8x8x4xbf16>, vector<8x4xbf16>
+        %c = vector.transfer_read %C[%i, %j, %c0, %c0], %c0_f32
+               {in_bounds = [true, true]} : memref<8x8x4x4xf32>, vector<4x4xf32>
+        %af = arith.extf %a : vector<4x8xbf16> to vector<4x8xf32>
+        %bf = arith.extf %b : vector<8x4xbf16> to vector<8x4xf32>
+        %r = vector.contract {indexing_maps = [#map, #map1, #map2],
+                              iterator_types = ["parallel", "parallel", "reduction"],
+                              kind = #vector.kind<add>} %af, %bf, %c
+               : vector<4x8xf32>, vector<8x4xf32> into vector<4x4xf32>
+        vector.transfer_write %r, %C[%i, %j, %c0, %c0] {in_bounds = [true, true]}
+               : vector<4x4xf32>, memref<8x8x4x4xf32>
+      }
+    }
+  }
+  return
+}
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// The lhs tiles are loaded from a view of the accumulator buffer.
+
+// CHECK-LABEL: func.func @lhs_view_of_acc(
+// CHECK-COUNT-1: vector.contract
+// CHECK-NOT:     vector.contract
+// FIXED-LABEL: func.func @lhs_view_of_acc(
+// FIXED-COUNT-1: vector.contract
+// FIXED-NOT:     vector.contract
+func.func @lhs_view_of_acc(%B : memref<4x8x4x4xf32> {llvm.noalias},
+                           %C : memref<8x8x4x4xf32> {llvm.noalias}) {
+  %c0 = arith.constant 0 : index
+  %c0_f32 = arith.constant 0.0 : f32
+  %A = memref.subview %C[0, 0, 0, 0] [8, 4, 4, 4] [1, 1, 1, 1]
+         : memref<8x8x4x4xf32> to memref<8x4x4x4xf32, strided<[128, 16, 4, 1]>>
+  affine.for %i = 0 to 8 {
+    affine.for %j = 0 to 8 {
+      affine.for %k = 0 to 4 {
+        %a = vector.transfer_read %A[%i, %k, %c0, %c0], %c0_f32
+               {in_bounds = [true, true]}
+               : memref<8x4x4x4xf32, strided<[128, 16, 4, 1]>>, vector<4x4xf32>
+        %b = vector.transfer_read %B[%k, %j, %c0, %c0], %c0_f32
+               {in_bounds = [true, true]} : memref<4x8x4x4xf32>, vector<4x4xf32>
+        %c = vector.transfer_read %C[%i, %j, %c0, %c0], %c0_f32
+               {in_bounds = [true, true]} : memref<8x8x4x4xf32>, vector<4x4xf32>
+        %r = vector.contract {indexing_maps = [#map, #map1, #map2],
+                              iterator_types = ["parallel", "parallel", "reduction"],
+                              kind = #vector.kind<add>} %a, %b, %c
+               : vector<4x4xf32>, vector<4x4xf32> into vector<4x4xf32>
+        vector.transfer_write %r, %C[%i, %j, %c0, %c0] {in_bounds = [true, true]}
+               : vector<4x4xf32>, memref<8x8x4x4xf32>
+      }
+    }
+  }
+  return
+}
@@ -361,3 +361,37 @@ func.func @shuffle_i512(%v : vector<1xi512>) -> vector<1xi512> {
   %1 = aievec.shuffle %0, %v [t512_1x2_hi] : vector<1xi512>
   return %1 : vector<1xi512>
 }
+
+// -----
+
+// CHECK-LABEL: @pack_unpack_i4
+// CHECK-SAME: %[[V:.*]]: vector<64xi8>
+// CHECK:      %[[P:.*]] = aievec.pack %[[V]] : vector<64xi8>, vector<64xi4>
+// CHECK:      %[[U:.*]] = aievec.unpack %[[P]] : vector<64xi4>, vector<64xi8>
+// CHECK: return %[[U]] : vector<64xi8>
+func.func @pack_unpack_i4(%v : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.pack %v : vector<64xi8>, vector<64xi4>
+  %1 = aievec.unpack %0 : vector<64xi4>, vector<64xi8>
+  return %1 : vector<64xi8>
+}
+
+// -----
+
+// CHECK-LABEL: @matmul_bfp16
+// CHECK-SAME: %[[A:.*]]: vector<8x8xbf16>
+// CHECK-SAME: %[[B:.*]]: !aievec.bfp16<8x8>
+// CHECK-SAME: %[[C:.*]]: vector<8x8xf32>
+// CHECK:      %[[PA:.*]] = aievec.pack_bfp %[[A]] : vector<8x8xbf16> -> !aievec.bfp16<8x8>
+// CHECK:      %[[RES:.*]] = aievec.matmul_bfp %[[PA]], %[[B]], %[[C]] :
+// CHECK-SAME: !aievec.bfp16<8x8>, !aievec.bfp16<8x8> into vector<8x8xf32>
+// CHECK:      %[[U:.*]] = aievec.unpack_bfp %[[B]] : !aievec.bfp16<8x8> -> vector<8x8xf32>
+// CHECK: return %[[RES]], %[[U]]
+func.func @matmul_bfp16(%A : vector<8x8xbf16>, %B : !aievec.bfp16<8x8>,
+                        %C : vector<8x8xf32>)
+    -> (vector<8x8xf32>, vector<8x8xf32>) {
+  %0 = aievec.pack_bfp %A : vector<8x8xbf16> -> !aievec.bfp16<8x8>
+  %1 = aievec.matmul_bfp %0, %B, %C : !aievec.bfp16<8x8>, !aievec.bfp16<8x8>
+                                      into vector<8x8xf32>
+  %2 = aievec.unpack_bfp %B : !aievec.bfp16<8x8> -> vector<8x8xf32>
+  return %1, %2 : vector<8x8xf32>, vector<8x8xf32>
+}
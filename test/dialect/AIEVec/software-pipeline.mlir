@@ -0,0 +1,159 @@
+// RUN: aie-opt %s -split-input-file --aievec-software-pipeline | FileCheck %s
+// RUN: aie-opt %s -split-input-file \
+// RUN:   --aievec-software-pipeline="emit-estimates" -verify-diagnostics \
+// RUN:   -o /dev/null
+
+// The loads of the next iteration are issued before the multiply-accumulate
+// of the current one, and those of the first iteration in a prologue.
+
+// CHECK-LABEL: func.func @dot(
+// CHECK-SAME:      %[[A:.*]]: memref<256xbf16>, %[[B:.*]]: memref<256xbf16>,
+// CHECK-SAME:      %[[OUT:.*]]: memref<16xf32>)
+// CHECK:         vector.transfer_read %[[A]]
+// CHECK:         vector.transfer_read %[[B]]
+// CHECK-NOT:     aievec.mac_elem
+// CHECK:         %[[R:.*]]:3 = scf.for
+// CHECK:           vector.transfer_read %[[A]]
+// CHECK:           vector.transfer_read %[[B]]
+// CHECK:           aievec.mac_elem
+// CHECK:           scf.yield
+// CHECK:         }
+// CHECK:         %[[LAST:.*]] = aievec.mac_elem
+// CHECK:         vector.transfer_write %[[LAST]], %[[OUT]]
+func.func @dot(%A : memref<256xbf16>, %B : memref<256xbf16>,
+               %out : memref<16xf32>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %pad = arith.constant 0.0 : bf16
+  %zero = arith.constant dense<0.0> : vector<16xf32>
+  // expected-remark @below {{estimated 13 cycles per iteration, 7 when software pipelined}}
+  %r = scf.for %i = %c0 to %c256 step %c16 iter_args(%acc = %zero)
+      -> (vector<16xf32>) {
+    %a = vector.transfer_read %A[%i], %pad {in_bounds = [true]}
+           : memref<256xbf16>, vector<16xbf16>
+    %b = vector.transfer_read %B[%i], %pad {in_bounds = [true]}
+           : memref<256xbf16>, vector<16xbf16>
+    %m = aievec.mac_elem %a, %b, %acc
+           : vector<16xbf16>, vector<16xbf16>, vector<16xf32>
+    scf.yield %m : vector<16xf32>
+  }
+  vector.transfer_write %r, %out[%c0] {in_bounds = [true]}
+    : vector<16xf32>, memref<16xf32>
+  return
+}
+
+// -----
+
+// The loop writes the buffer it reads from, so its loads stay in place.
+
+// CHECK-LABEL: func.func @in_place(
+// CHECK-NOT:     vector.transfer_read
+// CHECK:         scf.for
+// CHECK:           vector.transfer_read
+// CHECK:           aievec.add_elem
+// CHECK:           vector.transfer_write
+func.func @in_place(%buf : memref<256xi32>, %v : vector<16xi32>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %pad = arith.constant 0 : i32
+  // expected-remark @below {{estimated 10 cycles per iteration}}
+  scf.for %i = %c0 to %c256 step %c16 {
+    %a = vector.transfer_read %buf[%i], %pad {in_bounds = [true]}
+           : memref<256xi32>, vector<16xi32>
+    %s = aievec.add_elem %a, %v : vector<16xi32>
+    vector.transfer_write %s, %buf[%i] {in_bounds = [true]}
+      : vector<16xi32>, memref<256xi32>
+  }
+  return
+}
+
+// -----
+
+// Memref arguments may be the same memory, so the loop writing one of them
+// keeps its loads from the others in place.
+
+// CHECK-LABEL: func.func @may_alias(
+// CHECK-NOT:     vector.transfer_read
+// CHECK:         scf.for
+// CHECK:           vector.transfer_read
+// CHECK:           aievec.add_elem
+// CHECK:           vector.transfer_write
+func.func @may_alias(%in : memref<256xi32>, %out : memref<256xi32>,
+                     %v : vector<16xi32>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %pad = arith.constant 0 : i32
+  // expected-remark @below {{estimated 10 cycles per iteration}}
+  scf.for %i = %c0 to %c256 step %c16 {
+    %a = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+           : memref<256xi32>, vector<16xi32>
+    %s = aievec.add_elem %a, %v : vector<16xi32>
+    vector.transfer_write %s, %out[%i] {in_bounds = [true]}
+      : vector<16xi32>, memref<256xi32>
+  }
+  return
+}
+
+// -----
+
+// An argument marked llvm.noalias is not written by the writes to others.
+
+// CHECK-LABEL: func.func @no_alias(
+// CHECK:         vector.transfer_read
+// CHECK:         scf.for
+// CHECK:           vector.transfer_read
+// CHECK:           aievec.add_elem
+// CHECK:           vector.transfer_write
+func.func @no_alias(%in : memref<256xi32> {llvm.noalias},
+                    %out : memref<256xi32>, %v : vector<16xi32>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %pad = arith.constant 0 : i32
+  // expected-remark @below {{estimated 10 cycles per iteration, 7 when software pipelined}}
+  scf.for %i = %c0 to %c256 step %c16 {
+    %a = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+           : memref<256xi32>, vector<16xi32>
+    %s = aievec.add_elem %a, %v : vector<16xi32>
+    vector.transfer_write %s, %out[%i] {in_bounds = [true]}
+      : vector<16xi32>, memref<256xi32>
+  }
+  return
+}
+
+// -----
+
+// Inside an aie.device, the latencies are those of its architecture.
+
+// CHECK-LABEL: aie.device(npu2)
+// CHECK:         aie.core
+// CHECK:           vector.transfer_read
+// CHECK:           scf.for
+// CHECK:             vector.transfer_read
+// CHECK:             aievec.mul_elem
+// CHECK:             aievec.srs
+aie.device(npu2) {
+  %tile = aie.tile(1, 2)
+  %in = aie.buffer(%tile) : memref<256xi16>
+  %out = aie.buffer(%tile) : memref<256xi16>
+  %core = aie.core(%tile) {
+    %c0 = arith.constant 0 : index
+    %c32 = arith.constant 32 : index
+    %c256 = arith.constant 256 : index
+    %c0_i32 = arith.constant 0 : i32
+    %pad = arith.constant 0 : i16
+    // expected-remark @below {{estimated 19 cycles per iteration, 12 when software pipelined}}
+    scf.for %i = %c0 to %c256 step %c32 {
+      %a = vector.transfer_read %in[%i], %pad {in_bounds = [true]}
+             : memref<256xi16>, vector<32xi16>
+      %m = aievec.mul_elem %a, %a : vector<32xi16>, vector<32xi16>, vector<32xi32>
+      %s = aievec.srs %m, %c0_i32 : vector<32xi32>, i32, vector<32xi16>
+      vector.transfer_write %s, %out[%i] {in_bounds = [true]}
+        : vector<32xi16>, memref<256xi16>
+    }
+    aie.end
+  }
+}
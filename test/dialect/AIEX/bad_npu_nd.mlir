@@ -281,3 +281,25 @@ module {
     aie.shim_dma_allocation @objectfifo (MM2S, 0, 0)
   }
 }
+
+// -----
+
+// runtime size limits
+
+module {
+  aie.device(npu1_4col) {
+    memref.global "public" @objectfifo : memref<8xi32, 1 : i32>
+    aiex.runtime_sequence(%a : memref<4096xi32>, %n : i64, %m : i64) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c8 = arith.constant 8 : i64
+      // expected-error@+1 {{Size 3 cannot be a runtime parameter.}}
+      aiex.npu.dma_memcpy_nd (%a[%c0,%c0,%c0,%c0][%n,%c1,%c1,%c8][%c8,%c0,%c0,%c1]) { metadata = @objectfifo, id = 0 : i64 } : memref<4096xi32>
+      // expected-error@+1 {{At most one size can be a runtime parameter.}}
+      aiex.npu.dma_memcpy_nd (%a[%c0,%c0,%c0,%c0][%c1,%c1,%n,%m][%c0,%c0,%c8,%c1]) { metadata = @objectfifo, id = 1 : i64 } : memref<4096xi32>
+      // expected-error@+1 {{Offset 1 must be zero when stride 1 is a runtime parameter.}}
+      aiex.npu.dma_memcpy_nd (%a[%c0,%c0,%c1,%c0][%c1,%c1,%c8,%c8][%c0,%c0,%n,%c1]) { metadata = @objectfifo, id = 2 : i64 } : memref<4096xi32>
+    }
+    aie.shim_dma_allocation @objectfifo (MM2S, 0, 0)
+  }
+}
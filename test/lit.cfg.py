@@ -319,6 +319,8 @@ for c in config.vitis_components:
 
 tools = [
     "aie-opt",
+    "aie-router-bench",
+    "aie-txn-interp",
     "aie-translate",
     "aiecc.py",
     "ld.lld",
@@ -0,0 +1,112 @@
+//===- npu_peephole.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-npu-peephole %s | FileCheck %s
+
+// Writes overwritten before the next sync are removed, whether the register
+// is given by column/row and offset or by its full address.
+// CHECK-LABEL: aiex.runtime_sequence @dead
+// CHECK-NEXT:    aiex.npu.write32 {address = 2215936 : ui32, value = 3 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 655360 : ui32, column = 0 : i32, row = 1 : i32, value = 6 : ui32}
+// CHECK-NEXT:    aiex.npu.sync
+// CHECK-NEXT:    aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 2 : i32, value = 4 : ui32}
+// CHECK-NEXT:  }
+
+// A queue push orders the writes to the BD it starts.
+// CHECK-LABEL: aiex.runtime_sequence @queue
+// CHECK-NEXT:    aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 0 : i32, value = 5 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 0 : i32, value = 6 : ui32}
+// CHECK-NEXT:  }
+
+// Writes to registers that act on the array when written (here event
+// generation and a lock value) are never removed or merged.
+// CHECK-LABEL: aiex.runtime_sequence @action
+// CHECK-NEXT:    aiex.npu.write32 {address = 213000 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 213000 : ui32, column = 0 : i32, row = 2 : i32, value = 2 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 126976 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 126976 : ui32, column = 0 : i32, row = 2 : i32, value = 0 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 126980 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+// CHECK-NEXT:  }
+
+// CHECK-LABEL: aiex.runtime_sequence @fold
+// CHECK-NEXT:    aiex.npu.maskwrite32 {address = 258048 : ui32, column = 1 : i32, mask = 255 : ui32, row = 2 : i32, value = 19 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 258052 : ui32, column = 1 : i32, row = 2 : i32, value = 65298 : ui32}
+// CHECK-NEXT:    aiex.npu.write32 {address = 258056 : ui32, column = 1 : i32, row = 2 : i32, value = 2863289685 : ui32}
+// CHECK-NEXT:  }
+
+// CHECK:       memref.global "private" constant @blockwrite_data_0 : memref<3xi32> = dense<[1, 2, 3]>
+// CHECK-LABEL: aiex.runtime_sequence @coalesce
+// CHECK-NEXT:    %[[DATA0:.*]] = memref.get_global @blockwrite_data_0 : memref<3xi32>
+// CHECK-NEXT:    aiex.npu.blockwrite(%[[DATA0]]) {address = 35770368 : ui32} : memref<3xi32>
+// CHECK-NEXT:    aiex.npu.sync
+// CHECK-NEXT:    aiex.npu.write32 {address = 118796 : ui32, column = 1 : i32, row = 2 : i32, value = 4 : ui32}
+// CHECK-NEXT:  }
+
+// CHECK:       memref.global "private" constant @blockwrite_data_1 : memref<2xi32> = dense<[7, 8]>
+// CHECK-LABEL: aiex.runtime_sequence @deadblock
+// CHECK-NEXT:    %[[DATA1:.*]] = memref.get_global @blockwrite_data_1 : memref<2xi32>
+// CHECK-NEXT:    aiex.npu.blockwrite(%[[DATA1]]) {address = 35770368 : ui32} : memref<2xi32>
+// CHECK-NEXT:  }
+// CHECK-NOT:   @data
+
+module {
+  aie.device(npu1_4col) {
+    memref.global "private" constant @data : memref<2xi32> = dense<[1, 2]>
+
+    aiex.runtime_sequence @dead() {
+      aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+      aiex.npu.maskwrite32 {address = 118784 : ui32, column = 0 : i32, row = 2 : i32, value = 2 : ui32, mask = 15 : ui32}
+      aiex.npu.write32 {address = 2215936 : ui32, value = 3 : ui32}
+      aiex.npu.write32 {address = 655360 : ui32, column = 0 : i32, row = 1 : i32, value = 5 : ui32}
+      aiex.npu.write32 {address = 655360 : ui32, column = 0 : i32, row = 1 : i32, value = 6 : ui32}
+      aiex.npu.sync {column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32}
+      aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 2 : i32, value = 4 : ui32}
+    }
+
+    aiex.runtime_sequence @queue() {
+      aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 0 : i32, value = 5 : ui32}
+      aiex.npu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+      aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 0 : i32, value = 6 : ui32}
+    }
+
+    aiex.runtime_sequence @action() {
+      aiex.npu.write32 {address = 213000 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+      aiex.npu.write32 {address = 213000 : ui32, column = 0 : i32, row = 2 : i32, value = 2 : ui32}
+      aiex.npu.write32 {address = 126976 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+      aiex.npu.write32 {address = 126976 : ui32, column = 0 : i32, row = 2 : i32, value = 0 : ui32}
+      aiex.npu.write32 {address = 126980 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+    }
+
+    aiex.runtime_sequence @fold() {
+      aiex.npu.maskwrite32 {address = 258048 : ui32, column = 1 : i32, row = 2 : i32, value = 16 : ui32, mask = 240 : ui32}
+      aiex.npu.maskwrite32 {address = 258048 : ui32, column = 1 : i32, row = 2 : i32, value = 3 : ui32, mask = 15 : ui32}
+      aiex.npu.write32 {address = 258052 : ui32, column = 1 : i32, row = 2 : i32, value = 65280 : ui32}
+      aiex.npu.maskwrite32 {address = 258052 : ui32, column = 1 : i32, row = 2 : i32, value = 18 : ui32, mask = 255 : ui32}
+      aiex.npu.maskwrite32 {address = 258056 : ui32, column = 1 : i32, row = 2 : i32, value = 2863267840 : ui32, mask = 4294901760 : ui32}
+      aiex.npu.maskwrite32 {address = 258056 : ui32, column = 1 : i32, row = 2 : i32, value = 21845 : ui32, mask = 65535 : ui32}
+    }
+
+    aiex.runtime_sequence @coalesce() {
+      aiex.npu.write32 {address = 118784 : ui32, column = 1 : i32, row = 2 : i32, value = 1 : ui32}
+      aiex.npu.write32 {address = 118788 : ui32, column = 1 : i32, row = 2 : i32, value = 2 : ui32}
+      aiex.npu.write32 {address = 118792 : ui32, column = 1 : i32, row = 2 : i32, value = 3 : ui32}
+      aiex.npu.sync {column = 1 : i32, row = 2 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32}
+      aiex.npu.write32 {address = 118796 : ui32, column = 1 : i32, row = 2 : i32, value = 4 : ui32}
+    }
+
+    aiex.runtime_sequence @deadblock() {
+      %0 = memref.get_global @data : memref<2xi32>
+      aiex.npu.blockwrite(%0) {address = 35770368 : ui32} : memref<2xi32>
+      aiex.npu.write32 {address = 118784 : ui32, column = 1 : i32, row = 2 : i32, value = 7 : ui32}
+      aiex.npu.write32 {address = 118788 : ui32, column = 1 : i32, row = 2 : i32, value = 8 : ui32}
+    }
+  }
+}
@@ -0,0 +1,75 @@
+//===- depth_sizing.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-depth-sizing %s | FileCheck %s
+// RUN: aie-opt --aie-objectFifo-depth-sizing=rewrite %s | FileCheck %s --check-prefix=REWRITE
+
+// The memtile pool of a link holds one element for each of its DMAs, and a
+// core consumer pool holds its largest acquire plus one for its DMA.
+// CHECK: aie.objectfifo @in(%{{.*}}tile_0_0, {%{{.*}}tile_0_1}, 2 : i32) {min_depth = [2 : i32, 2 : i32], throughput_depth = [2 : i32, 2 : i32]}
+// CHECK: aie.objectfifo @in_fwd(%{{.*}}tile_0_1, {%{{.*}}tile_0_2}, 4 : i32) {min_depth = [2 : i32, 2 : i32], throughput_depth = [2 : i32, 2 : i32]}
+
+// Cores 0_2 and 0_3 share memory: a single pool holds the acquires of both.
+// CHECK: aie.objectfifo @a(%{{.*}}tile_0_2, {%{{.*}}tile_0_3}, 4 : i32) {min_depth = [2 : i32, 2 : i32], throughput_depth = [2 : i32, 2 : i32]}
+
+// @b reaches core 0_3 two stages ahead of @a, which goes through the memtile
+// and core 0_2: its consumer pool gets two more elements on top of its
+// sliding window of two.
+// CHECK: aie.objectfifo @b(%{{.*}}tile_0_0, {%{{.*}}tile_0_3}, 2 : i32) {min_depth = [2 : i32, 3 : i32], throughput_depth = [2 : i32, 5 : i32]}
+// CHECK: aie.objectfifo @out(%{{.*}}tile_0_3, {%{{.*}}tile_0_0}, 2 : i32) {min_depth = [2 : i32, 2 : i32], throughput_depth = [2 : i32, 2 : i32]}
+
+// REWRITE: aie.objectfifo @in(%{{.*}}tile_0_0, {%{{.*}}tile_0_1}, [2 : i32, 2 : i32])
+// REWRITE: aie.objectfifo @in_fwd(%{{.*}}tile_0_1, {%{{.*}}tile_0_2}, [2 : i32, 2 : i32])
+// REWRITE: aie.objectfifo @a(%{{.*}}tile_0_2, {%{{.*}}tile_0_3}, [2 : i32, 2 : i32])
+// REWRITE: aie.objectfifo @b(%{{.*}}tile_0_0, {%{{.*}}tile_0_3}, [2 : i32, 5 : i32])
+// REWRITE: aie.objectfifo @out(%{{.*}}tile_0_3, {%{{.*}}tile_0_0}, [2 : i32, 2 : i32])
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    aie.objectfifo @in(%tile_0_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @in_fwd(%tile_0_1, {%tile_0_2}, 4 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo.link [@in] -> [@in_fwd] ([] [])
+    aie.objectfifo @a(%tile_0_2, {%tile_0_3}, 4 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @b(%tile_0_0, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @out(%tile_0_3, {%tile_0_0}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      scf.for %arg0 = %c0 to %c8 step %c1 {
+        %0 = aie.objectfifo.acquire @in_fwd(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %1 = aie.objectfifo.acquire @a(Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        aie.objectfifo.release @in_fwd(Consume, 1)
+        aie.objectfifo.release @a(Produce, 1)
+      }
+      aie.end
+    }
+
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      scf.for %arg0 = %c0 to %c8 step %c1 {
+        %0 = aie.objectfifo.acquire @a(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %1 = aie.objectfifo.acquire @b(Consume, 2) : !aie.objectfifosubview<memref<16xi32>>
+        %2 = aie.objectfifo.acquire @out(Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        aie.objectfifo.release @a(Consume, 1)
+        aie.objectfifo.release @b(Consume, 1)
+        aie.objectfifo.release @out(Produce, 1)
+      }
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,59 @@
+//===- depth_sizing_memory.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-depth-sizing %s -split-input-file -verify-diagnostics | FileCheck %s
+
+// Four 16KB elements of @b would not fit next to the 1KB stack of core 0_3:
+// its throughput depth is cut back until they do.
+// CHECK: aie.objectfifo @b(%{{.*}}tile_0_0, {%{{.*}}tile_0_3}, 2 : i32) {min_depth = [2 : i32, 3 : i32], throughput_depth = [2 : i32, 3 : i32]}
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    aie.objectfifo @a0(%tile_0_0, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @a(%tile_0_2, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @b(%tile_0_0, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<4096xi32>>
+
+    %core_0_2 = aie.core(%tile_0_2) {
+      %0 = aie.objectfifo.acquire @a0(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %1 = aie.objectfifo.acquire @a(Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @a0(Consume, 1)
+      aie.objectfifo.release @a(Produce, 1)
+      aie.end
+    }
+
+    %core_0_3 = aie.core(%tile_0_3) {
+      %0 = aie.objectfifo.acquire @a(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %1 = aie.objectfifo.acquire @b(Consume, 2) : !aie.objectfifosubview<memref<4096xi32>>
+      aie.objectfifo.release @a(Consume, 1)
+      aie.objectfifo.release @b(Consume, 2)
+      aie.end
+    }
+  }
+}
+
+// -----
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_0 = aie.tile(0, 0)
+    // expected-warning@+1 {{minimum objectFifo depths on tile (0, 2) need 98304 bytes but only 64512 are available}}
+    %tile_0_2 = aie.tile(0, 2)
+    aie.objectfifo @big(%tile_0_0, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<8192xi32>>
+
+    %core_0_2 = aie.core(%tile_0_2) {
+      %0 = aie.objectfifo.acquire @big(Consume, 2) : !aie.objectfifosubview<memref<8192xi32>>
+      aie.objectfifo.release @big(Consume, 2)
+      aie.end
+    }
+  }
+}
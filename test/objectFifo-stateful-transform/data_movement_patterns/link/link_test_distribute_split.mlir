@@ -0,0 +1,75 @@
+//===- link_test_distribute_split.mlir --------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+
+// A distribute to eight cores needs eight MM2S channels, but memtile (0, 1)
+// has six: it keeps five outputs and forwards the last three, 192 elements,
+// to memtile (1, 1).
+
+// CHECK-LABEL: aie.device(npu2) {
+// CHECK-DAG:     memref.global "public" @in_split_1 : memref<192xi32>
+// CHECK-DAG:     %{{.*}}tile_1_1 = aie.tile(1, 1)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_0_0, DMA : 0, %{{.*}}tile_0_1, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_0_1, DMA : {{[0-9]+}}, %{{.*}}tile_0_2, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_0_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_2, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_0_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_1, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_1_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_3, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_1_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_4, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_1_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_5, DMA : 0)
+// CHECK-DAG:     %in_cons_prod_lock = aie.lock(%{{.*}}tile_0_1, {{[0-9]+}}) {init = 12 : i32, sym_name = "in_cons_prod_lock"}
+// CHECK-DAG:     %in_split_1_cons_buff_0 = aie.buffer(%{{.*}}tile_1_1) {sym_name = "in_split_1_cons_buff_0"} : memref<192xi32>
+// CHECK-DAG:     %in_split_1_cons_buff_1 = aie.buffer(%{{.*}}tile_1_1) {sym_name = "in_split_1_cons_buff_1"} : memref<192xi32>
+// CHECK-DAG:     %in_split_1_cons_prod_lock = aie.lock(%{{.*}}tile_1_1, {{[0-9]+}}) {init = 6 : i32, sym_name = "in_split_1_cons_prod_lock"}
+// CHECK-DAG:     %in_split_1_cons_cons_lock = aie.lock(%{{.*}}tile_1_1, {{[0-9]+}}) {init = 0 : i32, sym_name = "in_split_1_cons_cons_lock"}
+
+// Memtile (0, 1) receives the whole object and sends its last 192 elements
+// on to memtile (1, 1), which distributes them from offset 0.
+
+// CHECK-DAG:     aie.memtile_dma(%{{.*}}tile_0_1)
+// CHECK-DAG:       aie.use_lock(%in_cons_prod_lock, AcquireGreaterEqual, 6)
+// CHECK-DAG:       aie.dma_bd(%in_cons_buff_0 : memref<512xi32>, 0, 512)
+// CHECK-DAG:       aie.dma_bd(%in_cons_buff_0 : memref<512xi32>, 256, 64)
+// CHECK-DAG:       aie.dma_bd(%in_cons_buff_0 : memref<512xi32>, 320, 192)
+// CHECK-DAG:       aie.dma_bd(%in_cons_buff_1 : memref<512xi32>, 320, 192)
+// CHECK-DAG:     aie.memtile_dma(%{{.*}}tile_1_1)
+// CHECK-DAG:       aie.use_lock(%in_split_1_cons_prod_lock, AcquireGreaterEqual, 3)
+// CHECK-DAG:       aie.dma_bd(%in_split_1_cons_buff_0 : memref<192xi32>, 0, 192)
+// CHECK-DAG:       aie.use_lock(%in_split_1_cons_cons_lock, Release, 3)
+// CHECK-DAG:       aie.use_lock(%in_split_1_cons_cons_lock, AcquireGreaterEqual, 1)
+// CHECK-DAG:       aie.dma_bd(%in_split_1_cons_buff_0 : memref<192xi32>, 0, 64)
+// CHECK-DAG:       aie.dma_bd(%in_split_1_cons_buff_0 : memref<192xi32>, 64, 64)
+// CHECK-DAG:       aie.dma_bd(%in_split_1_cons_buff_1 : memref<192xi32>, 128, 64)
+// CHECK-DAG:       aie.use_lock(%in_split_1_cons_prod_lock, Release, 1)
+
+module {
+  aie.device(npu2) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    %tile_0_4 = aie.tile(0, 4)
+    %tile_0_5 = aie.tile(0, 5)
+    %tile_1_2 = aie.tile(1, 2)
+    %tile_1_3 = aie.tile(1, 3)
+    %tile_1_4 = aie.tile(1, 4)
+    %tile_1_5 = aie.tile(1, 5)
+    aie.objectfifo @in(%tile_0_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<512xi32>>
+    aie.objectfifo @o0(%tile_0_1, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o1(%tile_0_1, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o2(%tile_0_1, {%tile_0_4}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o3(%tile_0_1, {%tile_0_5}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o4(%tile_0_1, {%tile_1_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o5(%tile_0_1, {%tile_1_3}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o6(%tile_0_1, {%tile_1_4}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o7(%tile_0_1, {%tile_1_5}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo.link [@in] -> [@o0, @o1, @o2, @o3, @o4, @o5, @o6, @o7] ([] [0, 64, 128, 192, 256, 320, 384, 448])
+  }
+}
@@ -0,0 +1,79 @@
+//===- link_test_distribute_split_bad.mlir ---------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform --verify-diagnostics -split-input-file %s
+
+// Memtile (0, 1) has six MM2S channels and the four links need eight. Each
+// of them would have to move both of its outputs, leaving a 1:1 link, so
+// none of them is split and the first one is reported.
+
+module {
+  aie.device(npu2) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_1_0 = aie.tile(1, 0)
+    %tile_2_0 = aie.tile(2, 0)
+    %tile_3_0 = aie.tile(3, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    %tile_0_4 = aie.tile(0, 4)
+    %tile_0_5 = aie.tile(0, 5)
+    %tile_1_2 = aie.tile(1, 2)
+    %tile_1_3 = aie.tile(1, 3)
+    %tile_1_4 = aie.tile(1, 4)
+    %tile_1_5 = aie.tile(1, 5)
+    aie.objectfifo @in0(%tile_0_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<128xi32>>
+    aie.objectfifo @a0(%tile_0_1, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @a1(%tile_0_1, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @in1(%tile_1_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<128xi32>>
+    aie.objectfifo @b0(%tile_0_1, {%tile_0_4}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @b1(%tile_0_1, {%tile_0_5}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @in2(%tile_2_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<128xi32>>
+    aie.objectfifo @c0(%tile_0_1, {%tile_1_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @c1(%tile_0_1, {%tile_1_3}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @in3(%tile_3_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<128xi32>>
+    aie.objectfifo @d0(%tile_0_1, {%tile_1_4}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @d1(%tile_0_1, {%tile_1_5}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    // expected-error@+1 {{'aie.objectfifo.link' op does not fit on memtile (0, 1) even when split}}
+    aie.objectfifo.link [@in0] -> [@a0, @a1] ([] [0, 64])
+    aie.objectfifo.link [@in1] -> [@b0, @b1] ([] [0, 64])
+    aie.objectfifo.link [@in2] -> [@c0, @c1] ([] [0, 64])
+    aie.objectfifo.link [@in3] -> [@d0, @d1] ([] [0, 64])
+  }
+}
+
+// -----
+
+// The last two outputs of this distribute would have to move to a neighbour,
+// but the range they cover in the full object also holds kept outputs.
+
+module {
+  aie.device(npu2) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    %tile_0_4 = aie.tile(0, 4)
+    %tile_0_5 = aie.tile(0, 5)
+    %tile_1_2 = aie.tile(1, 2)
+    %tile_1_3 = aie.tile(1, 3)
+    %tile_1_4 = aie.tile(1, 4)
+    aie.objectfifo @in(%tile_0_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<448xi32>>
+    aie.objectfifo @o0(%tile_0_1, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o1(%tile_0_1, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o2(%tile_0_1, {%tile_0_4}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o3(%tile_0_1, {%tile_0_5}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o4(%tile_0_1, {%tile_1_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o5(%tile_0_1, {%tile_1_3}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @o6(%tile_0_1, {%tile_1_4}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    // expected-error@+1 {{'aie.objectfifo.link' op cannot forward its last 2 objectFifos from memtile (0, 1), as their offsets interleave with the others}}
+    aie.objectfifo.link [@in] -> [@o0, @o1, @o2, @o3, @o4, @o5, @o6] ([] [0, 128, 192, 256, 320, 384, 64])
+  }
+}
@@ -0,0 +1,59 @@
+//===- link_test_distribute_split_second.mlir ------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+
+// Memtile (0, 1) has six MM2S channels and the two links need seven. Freeing
+// enough of them for the first link and the fifo chaining it to a neighbour
+// would move both of its outputs, leaving a 1:1 link, so the second link is
+// split instead: its last two outputs, 128 elements from offset 192, move to
+// memtile (1, 1) and the first link then fits.
+
+// CHECK-LABEL: aie.device(npu2) {
+// CHECK-DAG:     memref.global "public" @in1_split_1 : memref<128xi32>
+// CHECK-DAG:     %{{.*}}tile_1_1 = aie.tile(1, 1)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_0_1, DMA : {{[0-9]+}}, %{{.*}}tile_0_2, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_0_1, DMA : {{[0-9]+}}, %{{.*}}tile_0_3, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_0_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_2, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_0_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_1, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_1_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_3, DMA : 0)
+// CHECK-DAG:     aie.flow(%{{.*}}tile_1_1, DMA : {{[0-9]+}}, %{{.*}}tile_1_4, DMA : 0)
+// CHECK-DAG:     aie.dma_bd(%in0_cons_buff_0 : memref<128xi32>, 64, 64)
+// CHECK-DAG:     aie.dma_bd(%in1_cons_buff_0 : memref<320xi32>, 128, 64)
+// CHECK-DAG:     aie.dma_bd(%in1_cons_buff_0 : memref<320xi32>, 192, 128)
+// CHECK-DAG:     aie.dma_bd(%in1_split_1_cons_buff_0 : memref<128xi32>, 0, 64)
+// CHECK-DAG:     aie.dma_bd(%in1_split_1_cons_buff_0 : memref<128xi32>, 64, 64)
+// CHECK-NOT:     @in0_split
+
+module {
+  aie.device(npu2) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_1_0 = aie.tile(1, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    %tile_0_4 = aie.tile(0, 4)
+    %tile_0_5 = aie.tile(0, 5)
+    %tile_1_2 = aie.tile(1, 2)
+    %tile_1_3 = aie.tile(1, 3)
+    %tile_1_4 = aie.tile(1, 4)
+    aie.objectfifo @in0(%tile_0_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<128xi32>>
+    aie.objectfifo @a0(%tile_0_1, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @a1(%tile_0_1, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @in1(%tile_1_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<320xi32>>
+    aie.objectfifo @b0(%tile_0_1, {%tile_0_4}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @b1(%tile_0_1, {%tile_0_5}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @b2(%tile_0_1, {%tile_1_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @b3(%tile_0_1, {%tile_1_3}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @b4(%tile_0_1, {%tile_1_4}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo.link [@in0] -> [@a0, @a1] ([] [0, 64])
+    aie.objectfifo.link [@in1] -> [@b0, @b1, @b2, @b3, @b4] ([] [0, 64, 128, 192, 256])
+  }
+}
@@ -0,0 +1,156 @@
+//===- hybrid_lowering_test.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform=hybrid-objFifos %s | FileCheck %s
+
+// The loop of core_0_2 fits in program memory once unrolled.
+// CHECK-LABEL:   %core_0_2 = aie.core(%{{.*}}tile_0_2) {
+// CHECK:           scf.for %{{.*}} = %{{.*}} to %{{.*}} step %{{.*}} {
+// CHECK:             func.call @work(%small_cons_buff_0)
+// CHECK:             func.call @work(%small_cons_buff_1)
+// CHECK:           }
+// CHECK:           aie.end
+
+// The loop of core_0_3 uses the same buffers in every iteration and is kept.
+// CHECK-LABEL:   %core_0_3 = aie.core(%{{.*}}tile_0_3) {
+// CHECK:           scf.for %{{.*}} = %{{.*}} to %{{.*}} step %c1 {
+// CHECK-NOT:         scf.index_switch
+// CHECK:             func.call @work2(%pair_cons_buff_0, %pair_cons_buff_1)
+// CHECK-NOT:         func.call
+// CHECK:           }
+// CHECK:           aie.end
+
+// Unrolling the loop of core_0_4 by lcm(7, 11) would not fit in program
+// memory: its buffers are selected from the iteration number instead.
+// CHECK-LABEL:   %core_0_4 = aie.core(%{{.*}}tile_0_4) {
+// CHECK:           aie.use_lock(%in_cons_cons_lock, AcquireGreaterEqual, 2)
+// CHECK:           aie.use_lock(%in_cons_prod_lock, Release, 2)
+// CHECK:           scf.for %[[IV:.*]] = %[[LB:.*]] to %{{.*}} step %[[STEP:.*]] {
+// CHECK:             %[[DIST:.*]] = arith.subi %[[IV]], %[[LB]] : index
+// CHECK:             %[[ITER:.*]] = arith.divui %[[DIST]], %[[STEP]] : index
+// CHECK:             aie.use_lock(%out_prod_lock, AcquireGreaterEqual, 1)
+// CHECK:             %[[ADV0:.*]] = arith.constant 1 : index
+// CHECK:             %[[FIRST0:.*]] = arith.constant 0 : index
+// CHECK:             %[[SIZE0:.*]] = arith.constant 7 : index
+// CHECK:             %[[MUL0:.*]] = arith.muli %[[ITER]], %[[ADV0]] : index
+// CHECK:             %[[ADD0:.*]] = arith.addi %[[MUL0]], %[[FIRST0]] : index
+// CHECK:             %[[IDX0:.*]] = arith.remui %[[ADD0]], %[[SIZE0]] : index
+// CHECK:             %[[OUT:.*]] = scf.index_switch %[[IDX0]] -> memref<16xi32>
+// CHECK:             case 0 {
+// CHECK:               scf.yield %out_buff_0 : memref<16xi32>
+// CHECK:             }
+// CHECK:             case 6 {
+// CHECK:               scf.yield %out_buff_6 : memref<16xi32>
+// CHECK:             }
+// CHECK:             default {
+// CHECK:               scf.yield %out_buff_0 : memref<16xi32>
+// CHECK:             }
+// CHECK:             aie.use_lock(%in_cons_cons_lock, AcquireGreaterEqual, 1)
+// CHECK:             %[[ADV1:.*]] = arith.constant 1 : index
+// CHECK:             %[[FIRST1:.*]] = arith.constant 2 : index
+// CHECK:             %[[SIZE1:.*]] = arith.constant 11 : index
+// CHECK:             %[[MUL1:.*]] = arith.muli %[[ITER]], %[[ADV1]] : index
+// CHECK:             %[[ADD1:.*]] = arith.addi %[[MUL1]], %[[FIRST1]] : index
+// CHECK:             %[[IDX1:.*]] = arith.remui %[[ADD1]], %[[SIZE1]] : index
+// CHECK:             %[[IN:.*]] = scf.index_switch %[[IDX1]] -> memref<16xi32>
+// CHECK:             case 10 {
+// CHECK:               scf.yield %in_cons_buff_10 : memref<16xi32>
+// CHECK:             }
+// CHECK:             default {
+// CHECK:               scf.yield %in_cons_buff_2 : memref<16xi32>
+// CHECK:             }
+// CHECK:             func.call @work3(%[[IN]], %[[OUT]])
+// CHECK:             aie.use_lock(%in_cons_prod_lock, Release, 1)
+// CHECK:             aie.use_lock(%out_cons_lock, Release, 1)
+// CHECK:           }
+// After 100 iterations, the next elements are out[100 % 7] and
+// in[102 % 11].
+// CHECK:           aie.use_lock(%out_prod_lock, AcquireGreaterEqual, 1)
+// CHECK:           aie.use_lock(%in_cons_cons_lock, AcquireGreaterEqual, 1)
+// CHECK:           func.call @work3(%in_cons_buff_3, %out_buff_2)
+// CHECK:           aie.end
+
+module {
+  aie.device(npu1_1col) {
+    func.func @work(%buf: memref<16xi32>) -> () {
+      return
+    }
+    func.func @work2(%a: memref<16xi32>, %b: memref<16xi32>) -> () {
+      return
+    }
+    func.func @work3(%in: memref<16xi32>, %out: memref<16xi32>) -> () {
+      return
+    }
+
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    %tile_0_4 = aie.tile(0, 4)
+    aie.objectfifo @small(%tile_0_0, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @pair(%tile_0_0, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @in(%tile_0_0, {%tile_0_4}, 11 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @out(%tile_0_4, {%tile_0_0}, 7 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c10 = arith.constant 10 : index
+      scf.for %arg0 = %c0 to %c10 step %c1 {
+        %0 = aie.objectfifo.acquire @small(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %1 = aie.objectfifo.subview.access %0[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @work(%1) : (memref<16xi32>) -> ()
+        aie.objectfifo.release @small(Consume, 1)
+      }
+      aie.end
+    }
+
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c10 = arith.constant 10 : index
+      scf.for %arg0 = %c0 to %c10 step %c1 {
+        %0 = aie.objectfifo.acquire @pair(Consume, 2) : !aie.objectfifosubview<memref<16xi32>>
+        %1 = aie.objectfifo.subview.access %0[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        %2 = aie.objectfifo.subview.access %0[1] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @work2(%1, %2) : (memref<16xi32>, memref<16xi32>) -> ()
+        aie.objectfifo.release @pair(Consume, 2)
+      }
+      aie.end
+    }
+
+    %core_0_4 = aie.core(%tile_0_4) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c100 = arith.constant 100 : index
+      %0 = aie.objectfifo.acquire @in(Consume, 2) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @in(Consume, 2)
+      scf.for %arg0 = %c0 to %c100 step %c1 {
+        %1 = aie.objectfifo.acquire @out(Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %2 = aie.objectfifo.subview.access %1[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        %3 = aie.objectfifo.acquire @in(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %4 = aie.objectfifo.subview.access %3[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @work3(%4, %2) : (memref<16xi32>, memref<16xi32>) -> ()
+        func.call @work3(%4, %2) : (memref<16xi32>, memref<16xi32>) -> ()
+        func.call @work3(%4, %2) : (memref<16xi32>, memref<16xi32>) -> ()
+        func.call @work3(%4, %2) : (memref<16xi32>, memref<16xi32>) -> ()
+        aie.objectfifo.release @in(Consume, 1)
+        aie.objectfifo.release @out(Produce, 1)
+      }
+      %5 = aie.objectfifo.acquire @out(Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %6 = aie.objectfifo.subview.access %5[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      %7 = aie.objectfifo.acquire @in(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %8 = aie.objectfifo.subview.access %7[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @work3(%8, %6) : (memref<16xi32>, memref<16xi32>) -> ()
+      aie.objectfifo.release @in(Consume, 1)
+      aie.objectfifo.release @out(Produce, 1)
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,386 @@
+//===- aie-router-bench.cpp -------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===---------------------------------------------------------------------===//
+
+// This tool measures the routers in isolation. It generates synthetic flow
+// sets for the devices, routes them with each router and reports the wall
+// time, the number of negotiation iterations, the total wire length and the
+// peak memory use of the process.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
+
+#include "mlir/IR/MLIRContext.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace llvm;
+using namespace xilinx::AIE;
+
+static cl::list<std::string>
+    Devices("device", cl::desc("Devices to route for (default: all)"),
+            cl::CommaSeparated);
+
+static cl::list<std::string> Patterns(
+    "pattern",
+    cl::desc("Flow patterns: nearest-neighbour, broadcast, all-to-all, "
+             "random-packet (default: all)"),
+    cl::CommaSeparated);
+
+static cl::list<std::string>
+    Routers("router", cl::desc("Routers: pathfinder, steiner (default: all)"),
+            cl::CommaSeparated);
+
+static cl::opt<double>
+    Density("density",
+            cl::desc("Fraction of the tiles that take part in a pattern"),
+            cl::init(0.5));
+
+static cl::opt<unsigned> Seed("seed", cl::desc("Random seed"), cl::init(1));
+
+static cl::opt<unsigned>
+    Repeat("repeat", cl::desc("Route each flow set this many times and report "
+                              "the fastest run"),
+           cl::init(1));
+
+static cl::opt<bool> AStar("astar", cl::desc("Enable the A* routing mode"),
+                           cl::init(false));
+
+static cl::opt<bool> Incremental("incremental",
+                                 cl::desc("Enable incremental rerouting"),
+                                 cl::init(false));
+
+static cl::opt<bool>
+    Parallel("parallel", cl::desc("Run the searches on the thread pool"),
+             cl::init(false));
+
+static cl::opt<int>
+    MaxIterations("max-iterations",
+                  cl::desc("Iterations before a flow set is unroutable"),
+                  cl::init(1000));
+
+namespace {
+
+struct SyntheticFlow {
+  PathEndPoint src;
+  PathEndPoint dst;
+  bool isPacketFlow;
+};
+
+// Number of channels of bundle into (isSource) or out of the switchbox of a
+// tile, looking through the shim mux like the Pathfinder does.
+int getNumChannels(const AIETargetModel &targetModel, int col, int row,
+                   WireBundle bundle, bool isSource) {
+  int channels =
+      isSource
+          ? targetModel.getNumSourceSwitchboxConnections(col, row, bundle)
+          : targetModel.getNumDestSwitchboxConnections(col, row, bundle);
+  if (channels == 0 && targetModel.isShimNOCorPLTile(col, row))
+    channels =
+        isSource ? targetModel.getNumSourceShimMuxConnections(col, row, bundle)
+                 : targetModel.getNumDestShimMuxConnections(col, row, bundle);
+  return channels;
+}
+
+class FlowGenerator {
+public:
+  FlowGenerator(const AIETargetModel &targetModel, double density,
+                unsigned seed)
+      : targetModel(targetModel), density(density), rng(seed) {
+    for (int col = 0; col < targetModel.columns(); col++) {
+      for (int row = 0; row < targetModel.rows(); row++) {
+        if (targetModel.isCoreTile(col, row))
+          coreTiles.push_back({col, row});
+        if (targetModel.isShimNOCTile(col, row))
+          shimTiles.push_back({col, row});
+        if (getNumChannels(targetModel, col, row, WireBundle::DMA, true) > 0)
+          dmaTiles.push_back({col, row});
+      }
+    }
+  }
+
+  std::vector<SyntheticFlow> generate(StringRef pattern) {
+    flows.clear();
+    usedSrcs.clear();
+    usedDsts.clear();
+    if (pattern == "nearest-neighbour")
+      nearestNeighbour();
+    else if (pattern == "broadcast")
+      broadcast();
+    else if (pattern == "all-to-all")
+      allToAll();
+    else if (pattern == "random-packet")
+      randomPacket();
+    return flows;
+  }
+
+private:
+  bool selected() {
+    return std::uniform_real_distribution<>(0.0, 1.0)(rng) < density;
+  }
+
+  bool isCoreTile(TileID tile) {
+    return targetModel.isValidTile(tile) &&
+           targetModel.isCoreTile(tile.col, tile.row);
+  }
+
+  // Claim a free DMA channel of tile, as source or destination. Packet flow
+  // destinations may be shared.
+  std::optional<PathEndPoint> claimDMA(TileID tile, bool isSource,
+                                       bool isPacketFlow = false) {
+    auto &used = isSource ? usedSrcs : usedDsts;
+    int channels = getNumChannels(targetModel, tile.col, tile.row,
+                                  WireBundle::DMA, isSource);
+    for (int channel = 0; channel < channels; channel++) {
+      PathEndPoint point = {tile, {WireBundle::DMA, channel}};
+      auto it = used.find(point);
+      if (it == used.end()) {
+        used[point] = isPacketFlow;
+        return point;
+      }
+      if (!isSource && isPacketFlow && it->second)
+        return point;
+    }
+    return std::nullopt;
+  }
+
+  void addFlow(TileID src, TileID dst, bool isPacketFlow) {
+    auto srcPoint = claimDMA(src, true);
+    auto dstPoint = claimDMA(dst, false, isPacketFlow);
+    if (srcPoint && dstPoint)
+      flows.push_back({*srcPoint, *dstPoint, isPacketFlow});
+  }
+
+  // Every selected core streams to its east neighbour, or its north
+  // neighbour on the east edge of the array.
+  void nearestNeighbour() {
+    for (TileID tile : coreTiles) {
+      if (!selected())
+        continue;
+      TileID east = {tile.col + 1, tile.row};
+      TileID north = {tile.col, tile.row + 1};
+      if (isCoreTile(east))
+        addFlow(tile, east, false);
+      else if (isCoreTile(north))
+        addFlow(tile, north, false);
+    }
+  }
+
+  // Every selected shim tile broadcasts to the cores of its column and a
+  // random selection of the other cores.
+  void broadcast() {
+    for (TileID shim : shimTiles) {
+      if (!selected())
+        continue;
+      auto src = claimDMA(shim, true);
+      if (!src)
+        continue;
+      for (TileID core : coreTiles) {
+        if (core.col != shim.col && !selected())
+          continue;
+        if (auto dst = claimDMA(core, false))
+          flows.push_back({*src, *dst, false});
+      }
+    }
+  }
+
+  // The selected cores are split into groups of four, in which every core
+  // sends packets to every other one.
+  void allToAll() {
+    std::vector<TileID> tiles;
+    for (TileID tile : coreTiles)
+      if (selected())
+        tiles.push_back(tile);
+    for (size_t begin = 0; begin < tiles.size(); begin += 4) {
+      size_t end = std::min(begin + 4, tiles.size());
+      for (size_t i = begin; i < end; i++) {
+        auto src = claimDMA(tiles[i], true);
+        if (!src)
+          continue;
+        for (size_t j = begin; j < end; j++) {
+          if (i == j)
+            continue;
+          if (auto dst = claimDMA(tiles[j], false, true))
+            flows.push_back({*src, *dst, true});
+        }
+      }
+    }
+  }
+
+  // Random packet flows with one to four destinations between tiles with a
+  // DMA.
+  void randomPacket() {
+    std::uniform_int_distribution<size_t> pick(0, dmaTiles.size() - 1);
+    size_t numFlows = density * dmaTiles.size();
+    for (size_t i = 0; i < numFlows; i++) {
+      auto src = claimDMA(dmaTiles[pick(rng)], true);
+      if (!src)
+        continue;
+      int numDsts = std::uniform_int_distribution<>(1, 4)(rng);
+      for (int d = 0; d < numDsts; d++) {
+        TileID dstTile = dmaTiles[pick(rng)];
+        if (dstTile == src->coords)
+          continue;
+        if (auto dst = claimDMA(dstTile, false, true))
+          flows.push_back({*src, *dst, true});
+      }
+    }
+  }
+
+  const AIETargetModel &targetModel;
+  double density;
+  std::mt19937 rng;
+  std::vector<TileID> coreTiles, shimTiles, dmaTiles;
+  std::vector<SyntheticFlow> flows;
+  // claimed DMA channels, and whether they are used by packet flows
+  std::map<PathEndPoint, bool> usedSrcs, usedDsts;
+};
+
+std::unique_ptr<Pathfinder> createRouter(StringRef name) {
+  if (name == "pathfinder")
+    return std::make_unique<Pathfinder>();
+  if (name == "steiner")
+    return std::make_unique<SteinerRouter>();
+  return nullptr;
+}
+
+// Peak resident set size of the process in KiB, 0 if unknown.
+long getPeakMemory() {
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  cl::ParseCommandLineOptions(argc, argv, "AIE router benchmark\n");
+
+  std::vector<std::string> devices(Devices.begin(), Devices.end());
+  if (devices.empty())
+    for (uint32_t i = 0; i <= getMaxEnumValForAIEDevice(); i++)
+      if (auto device = symbolizeAIEDevice(i))
+        devices.push_back(stringifyAIEDevice(*device).str());
+  const std::vector<std::string> allPatterns = {
+      "nearest-neighbour", "broadcast", "all-to-all", "random-packet"};
+  std::vector<std::string> patterns(Patterns.begin(), Patterns.end());
+  if (patterns.empty())
+    patterns = allPatterns;
+  for (const std::string &pattern : patterns) {
+    if (!llvm::is_contained(allPatterns, pattern)) {
+      errs() << "unknown pattern '" << pattern << "'\n";
+      return 1;
+    }
+  }
+  std::vector<std::string> routers(Routers.begin(), Routers.end());
+  if (routers.empty())
+    routers = {"pathfinder", "steiner"};
+  for (const std::string &routerName : routers) {
+    if (!createRouter(routerName)) {
+      errs() << "unknown router '" << routerName << "'\n";
+      return 1;
+    }
+  }
+
+  mlir::MLIRContext context;
+  RouterOptions options;
+  options.astar = AStar;
+  options.incremental = Incremental;
+  options.parallel = Parallel;
+  options.context = &context;
+
+  outs() << left_justify("device", 10) << " " << left_justify("pattern", 17)
+         << " " << left_justify("router", 10) << " "
+         << right_justify("flows", 6) << " " << right_justify("time(ms)", 10)
+         << " " << right_justify("iters", 6) << " "
+         << right_justify("wires", 8) << " " << right_justify("peak(KiB)", 10)
+         << "\n";
+  int status = 0;
+  for (const std::string &deviceName : devices) {
+    auto device = symbolizeAIEDevice(deviceName);
+    if (!device) {
+      errs() << "unknown device '" << deviceName << "'\n";
+      return 1;
+    }
+    const AIETargetModel &targetModel = getTargetModel(*device);
+    FlowGenerator generator(targetModel, Density, Seed);
+    for (const std::string &pattern : patterns) {
+      std::vector<SyntheticFlow> flows = generator.generate(pattern);
+      for (const std::string &routerName : routers) {
+        double bestTime = std::numeric_limits<double>::max();
+        std::optional<std::map<PathEndPoint, SwitchSettings>> solution;
+        int iterations = 0;
+        for (unsigned run = 0; run < std::max(1u, unsigned(Repeat)); run++) {
+          auto router = createRouter(routerName);
+          router->setOptions(options);
+          auto start = std::chrono::steady_clock::now();
+          // Same order as DynamicTileAnalysis: packet flows, then sortFlows,
+          // then circuit flows.
+          router->initialize(targetModel.columns() - 1,
+                             targetModel.rows() - 1, targetModel);
+          for (const auto &flow : flows)
+            if (flow.isPacketFlow)
+              router->addFlow(flow.src.coords, flow.src.port, flow.dst.coords,
+                              flow.dst.port, true, false, 0);
+          router->sortFlows(targetModel.columns(), targetModel.rows());
+          for (const auto &flow : flows)
+            if (!flow.isPacketFlow)
+              router->addFlow(flow.src.coords, flow.src.port, flow.dst.coords,
+                              flow.dst.port, false, false, 0);
+          solution = router->findPaths(MaxIterations);
+          std::chrono::duration<double, std::milli> elapsed =
+              std::chrono::steady_clock::now() - start;
+          bestTime = std::min(bestTime, elapsed.count());
+          iterations = solution ? router->getNumIterations() : MaxIterations;
+        }
+
+        size_t wires = 0;
+        if (solution)
+          for (const auto &[src, settings] : *solution)
+            for (const auto &[tile, setting] : settings)
+              wires += setting.dsts.size();
+        else
+          status = 2;
+        outs() << format("%-10s %-17s %-10s %6zu %10.2f %6d ",
+                         deviceName.c_str(), pattern.c_str(),
+                         routerName.c_str(), flows.size(), bestTime,
+                         iterations);
+        if (solution)
+          outs() << format("%8zu", wires);
+        else
+          outs() << right_justify("FAIL", 8);
+        outs() << format(" %10ld\n", getPeakMemory());
+      }
+    }
+  }
+  return status;
+}
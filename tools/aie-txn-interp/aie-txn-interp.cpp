@@ -0,0 +1,128 @@
+//===- aie-txn-interp.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2026 Advanced Micro Devices, Inc.
+//
+//===---------------------------------------------------------------------===//
+
+// This tool runs an NPU transaction binary, as generated by
+// aie-translate --aie-npu-to-binary, against a register model of the device
+// and reports the final BD, lock and stream switch state of each tile along
+// with the number, size and run time of the operations. The binary can be
+// given as raw little-endian words or as text with one hex word per line.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Targets/AIETxnInterpreter.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace xilinx::AIE;
+
+static cl::opt<std::string> InputFilename(cl::Positional,
+                                          cl::desc("<transaction binary>"),
+                                          cl::init("-"));
+
+static cl::opt<std::string>
+    Device("device",
+           cl::desc("Device the binary is for (default: from its header)"));
+
+static cl::opt<bool> PrintState("state",
+                                cl::desc("Print the final state of the tiles"),
+                                cl::init(true));
+
+static cl::opt<bool> PrintStats("stats",
+                                cl::desc("Print the operation statistics"),
+                                cl::init(true));
+
+static cl::opt<bool> PrintTime("time",
+                               cl::desc("Print the run time of the operations"),
+                               cl::init(false));
+
+namespace {
+
+// Returns true if the buffer holds one hex word per line, as printed by
+// aie-translate --aie-npu-to-binary without --aie-output-binary.
+bool isText(StringRef buffer) {
+  StringRef first = buffer.split('\n').first.trim();
+  return first.size() == 8 && llvm::all_of(first, llvm::isHexDigit);
+}
+
+bool readWords(StringRef buffer, std::vector<uint32_t> &words) {
+  if (isText(buffer)) {
+    SmallVector<StringRef> lines;
+    buffer.split(lines, '\n', -1, false);
+    for (StringRef line : lines) {
+      line = line.trim();
+      if (line.empty())
+        continue;
+      uint32_t word;
+      if (line.getAsInteger(16, word)) {
+        errs() << "invalid word '" << line << "'\n";
+        return false;
+      }
+      words.push_back(word);
+    }
+    return true;
+  }
+  if (buffer.size() % sizeof(uint32_t)) {
+    errs() << "binary size " << buffer.size()
+           << " is not a multiple of 4 bytes\n";
+    return false;
+  }
+  for (size_t i = 0; i < buffer.size(); i += sizeof(uint32_t))
+    words.push_back(support::endian::read32le(buffer.data() + i));
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  cl::ParseCommandLineOptions(argc, argv, "AIE transaction interpreter\n");
+
+  auto buffer = MemoryBuffer::getFileOrSTDIN(InputFilename);
+  if (std::error_code ec = buffer.getError()) {
+    errs() << "cannot open '" << InputFilename << "': " << ec.message()
+           << "\n";
+    return 1;
+  }
+  std::vector<uint32_t> words;
+  if (!readWords((*buffer)->getBuffer(), words))
+    return 1;
+
+  std::optional<AIEDevice> device;
+  if (!Device.empty()) {
+    device = symbolizeAIEDevice(Device);
+    if (!device) {
+      errs() << "unknown device '" << Device << "'\n";
+      return 1;
+    }
+  } else {
+    device = TxnInterpreter::inferDevice(words);
+    if (!device) {
+      errs() << "cannot tell the device from the header, use --device\n";
+      return 1;
+    }
+  }
+
+  TxnInterpreter interpreter(getTargetModel(*device));
+  if (failed(interpreter.run(words)))
+    return 1;
+
+  if (PrintState)
+    interpreter.printState(outs());
+  if (PrintStats)
+    interpreter.printStats(outs(), PrintTime);
+  return 0;
+}